@@ -36,4 +36,14 @@ group "Windows"
 group "Application"
     include "Application/BuildApplication.lua"
 
+group "Tools"
+    include "Engine/Source/SchedulerSimulator/BuildSchedulerSimulator.lua"
+    include "Engine/Source/Benchmarks/BenchmarkCommon/BuildBenchmarkCommon.lua"
+    include "Engine/Source/Benchmarks/DequeBenchmark/BuildDequeBenchmark.lua"
+    include "Engine/Source/Benchmarks/CoroutineBenchmark/BuildCoroutineBenchmark.lua"
+    include "Engine/Source/Benchmarks/UpdateGraphBenchmark/BuildUpdateGraphBenchmark.lua"
+    include "Engine/Source/Benchmarks/EcsGroupBenchmark/BuildEcsGroupBenchmark.lua"
+    include "Engine/Source/Benchmarks/EcsObserverBenchmark/BuildEcsObserverBenchmark.lua"
+    include "Engine/Source/Benchmarks/EcsLayoutBenchmark/BuildEcsLayoutBenchmark.lua"
+
 link_modules()
\ No newline at end of file
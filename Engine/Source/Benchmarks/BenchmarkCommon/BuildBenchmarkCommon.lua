@@ -0,0 +1,38 @@
+project "BenchmarkCommon"
+    kind "StaticLib"
+    language "C++"
+    cppdialect "C++20"
+    targetdir "Binaries/%{cfg.buildcfg}"
+    staticruntime "off"
+
+    publicIncludeDirs
+    {
+        "Public"
+    }
+
+    files { 
+        "Public/**.h",
+        "Private/**.cpp",
+    }
+
+    use_modules({"Core"})
+
+    targetdir ("../../Binaries/" .. OutputDir .. "/%{prj.name}")
+    objdir ("../../Binaries/Intermediates/" .. OutputDir .. "/%{prj.name}")
+
+    register_project(project(), path.getdirectory(_SCRIPT))
+ 
+    filter "system:windows"
+        systemversion "latest"
+        defines { "PLATFORM_WINDOWS" }
+
+    filter "configurations:Debug"
+        defines { "DEBUG" }
+        runtime "Debug"
+        symbols "On"
+ 
+    filter "configurations:Release"
+        defines { "RELEASE" }
+        runtime "Release"
+        optimize "On"
+        symbols "On"
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "BenchmarkCommon.h"
+
+#include <algorithm>
+#include <format>
+#include <iostream>
+
+namespace LE
+{
+bool ParseBenchmarkOptions(int ArgCount, char* Args[], std::span<const BenchmarkOption> Options)
+{
+	for (int i = 1; i < ArgCount; i += 2)
+	{
+		const std::string_view name = Args[i];
+		const auto option = std::find_if(Options.begin(), Options.end(), [name](const BenchmarkOption& Option)
+		{
+			return Option.Name == name;
+		});
+
+		if (option == Options.end() || i + 1 >= ArgCount || !option->Parse(Args[i + 1]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void PrintBenchmarkUsage(std::string_view ToolName, std::span<const BenchmarkOption> Options)
+{
+	size_t width = 0;
+	for (const BenchmarkOption& option : Options)
+	{
+		width = Max(width, option.Name.size() + option.ValueName.size() + 1);
+	}
+
+	std::cout << std::format("Usage: {} [options]\n", ToolName);
+	for (const BenchmarkOption& option : Options)
+	{
+		std::string nameAndValue = std::format("{} {}", option.Name, option.ValueName);
+		nameAndValue.resize(width, ' ');
+		std::cout << std::format("  {}  {}\n", nameAndValue, option.Description);
+	}
+}
+}
\ No newline at end of file
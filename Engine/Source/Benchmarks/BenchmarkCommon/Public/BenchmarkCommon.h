@@ -0,0 +1,104 @@
+#pragma once
+#include <charconv>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "CoreDefinitions.h"
+#include "Math/Math.h"
+#include "Time/Clock.h"
+
+namespace LE
+{
+// Command line option of a benchmark tool, every option is followed by its value
+struct BenchmarkOption
+{
+	std::string_view Name;
+	std::string_view ValueName; // Shown in the usage, like <Count> or 4,8,16
+	std::string_view Description;
+	FunctionRef<bool(std::string_view)> Parse; // Returns false if the value isn't valid
+};
+
+template <typename T>
+bool ParseBenchmarkNumber(std::string_view String, T& OutNumber)
+{
+	const auto [end, error] = std::from_chars(String.data(), String.data() + String.size(), OutNumber);
+	return error == std::errc() && end == String.data() + String.size();
+}
+
+// Number accepted only within [MinValue, MaxValue]
+template <typename T>
+BenchmarkOption NumberOption(std::string_view Name, std::string_view ValueName, std::string_view Description, T& OutValue,
+                             std::type_identity_t<T> MinValue = 0, std::type_identity_t<T> MaxValue = Constants<T>::CMax)
+{
+	return {Name, ValueName, Description, [&OutValue, MinValue, MaxValue](std::string_view Value)
+	{
+		return ParseBenchmarkNumber(Value, OutValue) && OutValue >= MinValue && OutValue <= MaxValue;
+	}};
+}
+
+// Comma separated numbers, each of them at least MinValue. Replaces the default list, which can't be left empty
+template <typename T>
+BenchmarkOption NumberListOption(std::string_view Name, std::string_view ValueName, std::string_view Description, std::vector<T>& OutValues,
+                                 std::type_identity_t<T> MinValue = 1)
+{
+	return {Name, ValueName, Description, [&OutValues, MinValue](std::string_view Value)
+	{
+		OutValues.clear();
+		for (size_t begin = 0; begin < Value.size();)
+		{
+			const size_t end = Min(Value.find(',', begin), Value.size());
+			T number = 0;
+			if (!ParseBenchmarkNumber(Value.substr(begin, end - begin), number) || number < MinValue)
+			{
+				return false;
+			}
+
+			OutValues.push_back(number);
+			begin = end + 1;
+		}
+		return !OutValues.empty();
+	}};
+}
+
+// Returns false on unknown options, missing or invalid values
+bool ParseBenchmarkOptions(int ArgCount, char* Args[], std::span<const BenchmarkOption> Options);
+void PrintBenchmarkUsage(std::string_view ToolName, std::span<const BenchmarkOption> Options);
+
+// Keeps the shortest of the measured times, the first measurement replaces whatever was there
+inline void KeepFastest(uint64& FastestNs, uint64 TimeNs, bool IsFirst)
+{
+	FastestNs = IsFirst ? TimeNs : Min(FastestNs, TimeNs);
+}
+
+// Time of the fastest of the calls, in ns
+template <typename Func>
+uint64 MeasureFastest(uint32 RepeatCount, Func&& Function)
+{
+	uint64 fastestNs = 0;
+	for (uint32 repeat = 0; repeat < RepeatCount; ++repeat)
+	{
+		const uint64 startNs = Clock::NowNs();
+		Function();
+		KeepFastest(fastestNs, Clock::NowNs() - startNs, repeat == 0);
+	}
+	return fastestNs;
+}
+
+// Result of the fastest of the runs, Function returns a result with its TimeNs
+template <typename Func>
+std::invoke_result_t<Func&> RunFastest(uint32 RepeatCount, Func&& Function)
+{
+	std::invoke_result_t<Func&> fastest = Function();
+	for (uint32 repeat = 1; repeat < RepeatCount; ++repeat)
+	{
+		const std::invoke_result_t<Func&> result = Function();
+		if (result.TimeNs < fastest.TimeNs)
+		{
+			fastest = result;
+		}
+	}
+	return fastest;
+}
+}
\ No newline at end of file
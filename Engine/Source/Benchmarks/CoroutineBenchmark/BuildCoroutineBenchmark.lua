@@ -0,0 +1,35 @@
+project "CoroutineBenchmark"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++20"
+    targetdir "Binaries/%{cfg.buildcfg}"
+    staticruntime "off"
+
+    files { "Source/**.h", "Source/**.cpp" }
+
+    publicIncludeDirs
+    {
+        "Source",
+    }
+
+    use_modules({"Core", "BenchmarkCommon"})
+
+    targetdir ("../../Binaries/" .. OutputDir .. "/%{prj.name}")
+    objdir ("../../Binaries/Intermediates/" .. OutputDir .. "/%{prj.name}")
+
+    register_project(project(), path.getdirectory(_SCRIPT))
+
+    filter "system:windows"
+        systemversion "latest"
+        defines { "PLATFORM_WINDOWS" }
+
+    filter "configurations:Debug"
+        defines { "DEBUG" }
+        runtime "Debug"
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { "RELEASE" }
+        runtime "Release"
+        optimize "On"
+        symbols "On"
\ No newline at end of file
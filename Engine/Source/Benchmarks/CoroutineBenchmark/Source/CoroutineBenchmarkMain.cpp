@@ -0,0 +1,164 @@
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <string_view>
+#include <thread>
+
+#include "BenchmarkCommon.h"
+#include "Multithreading/JobScheduler.h"
+#include "Time/Clock.h"
+
+namespace
+{
+	struct BenchmarkOptions
+	{
+		LE::uint16 WorkerCount = 0; // Zero uses the default worker count of the scheduler
+		LE::uint32 JobCount = 1000;
+		LE::uint32 WaitingPercent = 30;
+		LE::uint32 WorkIterations = 20000;
+		LE::uint32 WaitUs = 2000;
+		LE::uint32 FrameCount = 20;
+	};
+
+	struct BenchmarkResult
+	{
+		LE::uint64 FrameNs = 0;
+		LE::uint64 WorkNs = 0;
+	};
+
+	// Waiting jobs wait for the fence between the two halves of their work, it's signaled from another thread, like IO or the render thread
+	struct FrameContext
+	{
+		FrameContext(const BenchmarkOptions& InOptions, bool InIsBlocking)
+			: Options(InOptions)
+			  , IsBlocking(InIsBlocking)
+		{
+		}
+
+		const BenchmarkOptions& Options;
+		bool IsBlocking;
+		LE::JobFence Fence;
+		std::atomic<LE::uint64> WorkNs = 0;
+	};
+
+	void DoWork(FrameContext& Context, LE::uint32 WorkIterations)
+	{
+		const LE::uint64 startNs = LE::Clock::NowNs();
+		volatile LE::uint64 value = 0;
+		for (LE::uint32 iteration = 0; iteration < WorkIterations; ++iteration)
+		{
+			value = value * 6364136223846793005ull + iteration;
+		}
+		Context.WorkNs.fetch_add(LE::Clock::NowNs() - startNs, std::memory_order_relaxed);
+	}
+
+	LE::JobTask RunWaitingJob(FrameContext& Context)
+	{
+		DoWork(Context, Context.Options.WorkIterations / 2);
+		if (Context.IsBlocking)
+		{
+			Context.Fence.Wait();
+		}
+		else
+		{
+			co_await Context.Fence;
+		}
+		DoWork(Context, Context.Options.WorkIterations - Context.Options.WorkIterations / 2);
+	}
+
+	// Spawns the jobs of the frame as its children, waiting jobs are spread evenly among the others
+	LE::JobTask RunFrameJob(FrameContext& Context)
+	{
+		LE::JobScheduler* scheduler = LE::JobScheduler::Get();
+		const LE::uint32 jobCount = Context.Options.JobCount;
+		const LE::uint32 waitingPercent = Context.Options.WaitingPercent;
+		for (LE::uint32 job = 0; job < jobCount; ++job)
+		{
+			const bool isWaiting = job * waitingPercent / 100 != (job + 1) * waitingPercent / 100;
+			if (isWaiting)
+			{
+				scheduler->SpawnCoroutineJob("Waiting Job", RunWaitingJob(Context));
+			}
+			else
+			{
+				scheduler->SpawnChildJob("Job", [&Context](const float)
+				{
+					DoWork(Context, Context.Options.WorkIterations);
+				});
+			}
+		}
+		co_return;
+	}
+
+	BenchmarkResult RunBenchmark(const BenchmarkOptions& Options, bool IsBlocking)
+	{
+		LE::JobScheduler* scheduler = LE::JobScheduler::Get();
+		BenchmarkResult result;
+		for (LE::uint32 frame = 0; frame < Options.FrameCount; ++frame)
+		{
+			FrameContext context(Options, IsBlocking);
+			const LE::uint64 startNs = LE::Clock::NowNs();
+			scheduler->StartFrame();
+			scheduler->SpawnCoroutineJob("Frame Job", RunFrameJob(context));
+
+			std::thread signaler([&context, &Options]
+			{
+				std::this_thread::sleep_for(std::chrono::microseconds(Options.WaitUs));
+				context.Fence.Signal();
+			});
+
+			scheduler->HelpWorkerThreads();
+			scheduler->WaitForAll();
+			result.FrameNs += LE::Clock::NowNs() - startNs;
+			result.WorkNs += context.WorkNs.load(std::memory_order_relaxed);
+			signaler.join();
+		}
+		return result;
+	}
+
+	void PrintResult(std::string_view ModeName, LE::uint16 ThreadCount, LE::uint32 FrameCount, const BenchmarkResult& Result)
+	{
+		// Share of the frame the threads running jobs spent doing work, jobs blocked on the fence hold their thread without working
+		const double utilisation = static_cast<double>(Result.WorkNs) / (static_cast<double>(Result.FrameNs) * ThreadCount);
+		std::cout << std::format("{:>10} {:>12.2f} {:>12.2f} {:>11.1f}%\n", ModeName, static_cast<double>(Result.FrameNs) / FrameCount / 1e6,
+		                         static_cast<double>(Result.WorkNs) / FrameCount / 1e6, utilisation * 100.0);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Log::Initialize();
+
+	BenchmarkOptions options;
+	const LE::BenchmarkOption commandLineOptions[] = {
+		LE::NumberOption("--workers", "<Count>", "Worker threads, the scheduler default if not set", options.WorkerCount, 1),
+		LE::NumberOption("--jobs", "<Count>", "Jobs spawned every frame", options.JobCount, 1),
+		LE::NumberOption("--waiting", "<Percent>", "Share of the jobs that wait for a fence in the middle of their work", options.WaitingPercent,
+		                 0, 100),
+		LE::NumberOption("--work", "<Iterations>", "Work done by each job", options.WorkIterations),
+		LE::NumberOption("--wait", "<Us>", "Time from the start of the frame till the fence is signaled", options.WaitUs),
+		LE::NumberOption("--frames", "<Count>", "Frames measured per mode", options.FrameCount, 1),
+	};
+	if (!LE::ParseBenchmarkOptions(argc, argv, commandLineOptions))
+	{
+		LE::PrintBenchmarkUsage("CoroutineBenchmark", commandLineOptions);
+		return 1;
+	}
+
+	LE::JobScheduler* scheduler = LE::JobScheduler::Get();
+	const LE::uint16 workerCount = options.WorkerCount > 0 ? options.WorkerCount : LE::JobScheduler::GetDefaultWorkerThreadCount();
+	scheduler->Init(workerCount);
+	scheduler->StartRenderThread();
+
+	std::cout << std::format("{} workers, {} jobs per frame, {}% of them wait {} us from the frame start, {} hardware threads\n\n", workerCount,
+	                         options.JobCount, options.WaitingPercent, options.WaitUs, std::thread::hardware_concurrency());
+	std::cout << std::format("{:>10} {:>12} {:>12} {:>12}\n", "Mode", "Frame (ms)", "Work (ms)", "Utilisation");
+	// Main thread runs jobs too while it helps the workers
+	const LE::uint16 threadCount = workerCount + 1;
+	PrintResult("Blocking", threadCount, options.FrameCount, RunBenchmark(options, true));
+	PrintResult("co_await", threadCount, options.FrameCount, RunBenchmark(options, false));
+
+	scheduler->Shutdown();
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include <atomic>
+#include <deque>
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "BenchmarkCommon.h"
+#include "Multithreading/WorkStealingQueue.h"
+#include "Time/Clock.h"
+
+namespace
+{
+	// Worker queue the scheduler had before the Chase-Lev deque: the owner locks for every push and pop,
+	// thieves give up when the lock is taken
+	class MutexJobQueue
+	{
+	public:
+		void Push(LE::uint32 Job)
+		{
+			std::lock_guard lock(Mutex);
+			Jobs.push_back(Job);
+			Count.store(static_cast<LE::uint32>(Jobs.size()), std::memory_order_relaxed);
+		}
+
+		bool Pop(LE::uint32& OutJob)
+		{
+			std::lock_guard lock(Mutex);
+			if (Jobs.empty())
+			{
+				return false;
+			}
+
+			OutJob = Jobs.back();
+			Jobs.pop_back();
+			Count.store(static_cast<LE::uint32>(Jobs.size()), std::memory_order_relaxed);
+			return true;
+		}
+
+		bool Steal(LE::uint32& OutJob)
+		{
+			std::unique_lock lock(Mutex, std::try_to_lock);
+			if (!lock || Jobs.empty())
+			{
+				return false;
+			}
+
+			OutJob = Jobs.front();
+			Jobs.pop_front();
+			Count.store(static_cast<LE::uint32>(Jobs.size()), std::memory_order_relaxed);
+			return true;
+		}
+
+		bool IsEmpty() const noexcept
+		{
+			return Count.load(std::memory_order_relaxed) == 0;
+		}
+
+	private:
+		std::deque<LE::uint32> Jobs;
+		std::mutex Mutex;
+		std::atomic<LE::uint32> Count = 0; // Mirror of the size, so thieves can skip empty queues without locking
+	};
+
+	struct BenchmarkOptions
+	{
+		std::vector<LE::uint16> WorkerCounts = {4, 8, 16, 32, 64};
+		LE::uint32 JobCount = 1000000;
+		LE::uint32 WorkIterations = 0; // Zero measures the queues alone
+		LE::uint32 RepeatCount = 5;
+	};
+
+	struct BenchmarkResult
+	{
+		LE::uint64 TimeNs = 0;
+		LE::uint64 StealAttempts = 0; // Only the ones on queues that had jobs, they fail because of other thieves or the owner
+		LE::uint64 Steals = 0;
+	};
+
+	// Written by a single worker, padded so workers don't share cache lines
+	struct alignas(CACHE_LINE_SIZE) WorkerStats
+	{
+		LE::uint64 StealAttempts = 0;
+		LE::uint64 Steals = 0;
+		LE::uint64 Checksum = 0;
+	};
+
+	constexpr LE::uint32 GPushBatchSize = 32;
+
+	LE::uint64 RunJob(LE::uint32 Job, LE::uint32 WorkIterations)
+	{
+		LE::uint64 value = Job;
+		for (LE::uint32 iteration = 0; iteration < WorkIterations; ++iteration)
+		{
+			value = value * 6364136223846793005ull + iteration;
+		}
+		return value;
+	}
+
+	// Half of the jobs are pushed by the first worker and the rest are spread over the others, so the workers that run out
+	// of their own jobs keep stealing. Owners push in batches whenever their queue runs dry, like workers spawning jobs
+	template <typename QueueType>
+	BenchmarkResult RunBenchmark(LE::uint16 WorkerCount, const BenchmarkOptions& Options)
+	{
+		std::vector<QueueType> queues(WorkerCount);
+		std::vector<WorkerStats> stats(WorkerCount);
+		std::atomic<LE::uint64> remainingJobs = Options.JobCount;
+		std::atomic<bool> isStarted = false;
+
+		auto getJobsToPush = [&](LE::uint16 WorkerIdx) -> LE::uint32
+		{
+			const LE::uint32 firstWorkerJobs = WorkerCount > 1 ? Options.JobCount / 2 : Options.JobCount;
+			const LE::uint32 otherJobs = Options.JobCount - firstWorkerJobs;
+			if (WorkerIdx == 0)
+			{
+				return firstWorkerJobs;
+			}
+
+			const LE::uint32 share = otherJobs / (WorkerCount - 1);
+			return share + (WorkerIdx <= otherJobs % (WorkerCount - 1) ? 1 : 0);
+		};
+
+		std::vector<std::thread> workers;
+		workers.reserve(WorkerCount);
+		for (LE::uint16 workerIdx = 0; workerIdx < WorkerCount; ++workerIdx)
+		{
+			workers.emplace_back([&, workerIdx]
+			{
+				QueueType& queue = queues[workerIdx];
+				WorkerStats& workerStats = stats[workerIdx];
+				LE::uint32 jobsToPush = getJobsToPush(workerIdx);
+				LE::uint32 nextJob = workerIdx;
+				LE::uint64 executedJobs = 0; // Flushed to remainingJobs only when the worker runs dry, the counter is shared
+
+				while (!isStarted.load(std::memory_order_acquire))
+				{
+				}
+
+				while (remainingJobs.load(std::memory_order_acquire) > 0)
+				{
+					LE::uint32 job = 0;
+					if (queue.Pop(job))
+					{
+						workerStats.Checksum += RunJob(job, Options.WorkIterations);
+						++executedJobs;
+						continue;
+					}
+
+					if (jobsToPush > 0)
+					{
+						const LE::uint32 batchSize = std::min(jobsToPush, GPushBatchSize);
+						for (LE::uint32 current = 0; current < batchSize; ++current)
+						{
+							queue.Push(nextJob);
+							nextJob += WorkerCount;
+						}
+						jobsToPush -= batchSize;
+						continue;
+					}
+
+					if (executedJobs > 0)
+					{
+						remainingJobs.fetch_sub(executedJobs, std::memory_order_acq_rel);
+						executedJobs = 0;
+					}
+
+					for (LE::uint16 offset = 1; offset < WorkerCount; ++offset)
+					{
+						QueueType& victim = queues[(workerIdx + offset) % WorkerCount];
+						if (victim.IsEmpty())
+						{
+							continue;
+						}
+
+						++workerStats.StealAttempts;
+						if (victim.Steal(job))
+						{
+							++workerStats.Steals;
+							workerStats.Checksum += RunJob(job, Options.WorkIterations);
+							++executedJobs;
+							break;
+						}
+					}
+				}
+			});
+		}
+
+		const LE::uint64 startNs = LE::Clock::NowNs();
+		isStarted.store(true, std::memory_order_release);
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+
+		BenchmarkResult result;
+		result.TimeNs = LE::Clock::NowNs() - startNs;
+		for (const WorkerStats& workerStats : stats)
+		{
+			result.StealAttempts += workerStats.StealAttempts;
+			result.Steals += workerStats.Steals;
+		}
+		return result;
+	}
+
+	void PrintResult(std::string_view QueueName, LE::uint16 WorkerCount, LE::uint32 JobCount, const BenchmarkResult& Result)
+	{
+		// Time every worker spent per job, it's the queue overhead when the jobs do no work
+		const double jobCpuNs = static_cast<double>(Result.TimeNs) * WorkerCount / JobCount;
+		const double stealSuccess = Result.StealAttempts > 0 ? static_cast<double>(Result.Steals) / static_cast<double>(Result.StealAttempts) : 0.0;
+		std::cout << std::format("{:>8} {:>12} {:>10.2f} {:>12.1f} {:>10} {:>9.2f}%\n", WorkerCount, QueueName, static_cast<double>(Result.TimeNs) / 1e6,
+		                         jobCpuNs, Result.Steals, stealSuccess * 100.0);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Log::Initialize();
+
+	BenchmarkOptions options;
+	const LE::BenchmarkOption commandLineOptions[] = {
+		LE::NumberListOption("--workers", "4,8,16", "Worker thread counts to measure", options.WorkerCounts),
+		LE::NumberOption("--jobs", "<Count>", "Jobs run per measurement", options.JobCount, 1),
+		LE::NumberOption("--work", "<Iterations>", "Work done by each job, 0 measures the queues alone", options.WorkIterations),
+		LE::NumberOption("--repeats", "<Count>", "Measurements per worker count, the fastest one is printed", options.RepeatCount, 1),
+	};
+	if (!LE::ParseBenchmarkOptions(argc, argv, commandLineOptions))
+	{
+		LE::PrintBenchmarkUsage("DequeBenchmark", commandLineOptions);
+		return 1;
+	}
+
+	std::cout << std::format("{} jobs of {} work iterations, {} hardware threads\n\n", options.JobCount, options.WorkIterations,
+	                         std::thread::hardware_concurrency());
+	std::cout << std::format("{:>8} {:>12} {:>10} {:>12} {:>10} {:>10}\n", "Workers", "Queue", "Time (ms)", "CPU ns/job", "Steals", "Success");
+	for (const LE::uint16 workerCount : options.WorkerCounts)
+	{
+		PrintResult("Mutex", workerCount, options.JobCount, LE::RunFastest(options.RepeatCount, [workerCount, &options]
+		{
+			return RunBenchmark<MutexJobQueue>(workerCount, options);
+		}));
+		PrintResult("Chase-Lev", workerCount, options.JobCount, LE::RunFastest(options.RepeatCount, [workerCount, &options]
+		{
+			return RunBenchmark<LE::WorkStealingQueue<LE::uint32>>(workerCount, options);
+		}));
+	}
+
+	return 0;
+}
\ No newline at end of file
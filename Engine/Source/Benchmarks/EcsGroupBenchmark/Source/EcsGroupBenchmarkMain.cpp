@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <format>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "BenchmarkCommon.h"
+#include "ECS/Ecs.h"
+#include "ECS/EcsRegistry.h"
+#include "Math/Vector3.h"
+
+namespace LE
+{
+struct BenchmarkPosition
+{
+	Vector3F Value = Vector3F(0.0f);
+};
+
+struct BenchmarkVelocity
+{
+	Vector3F Value = Vector3F(1.0f);
+};
+
+struct BenchmarkAcceleration
+{
+	Vector3F Value = Vector3F(0.5f);
+};
+
+struct BenchmarkDamping
+{
+	float Value = 0.99f;
+};
+
+ECS_REGISTER_COMPONENT(BenchmarkPosition, "BenchmarkPosition")
+ECS_REGISTER_COMPONENT(BenchmarkVelocity, "BenchmarkVelocity")
+ECS_REGISTER_COMPONENT(BenchmarkAcceleration, "BenchmarkAcceleration")
+ECS_REGISTER_COMPONENT(BenchmarkDamping, "BenchmarkDamping")
+}
+
+namespace
+{
+	struct BenchmarkOptions
+	{
+		LE::uint32 EntityCount = 100000;
+		LE::uint32 ShuffledPercent = 50;
+		LE::uint32 RepeatCount = 20;
+	};
+
+	// Fastest pass of the repeats, in ns
+	struct BenchmarkResult
+	{
+		LE::uint64 ViewNs = 0;
+		LE::uint64 GroupNs = 0;
+	};
+
+	// Every entity gets all of the components. Other components of a share of them are removed and added again, so their
+	// storages end up in a different order than the first one, like after entities were spawned and gained components over time.
+	// Same Update then runs through Each of a view and of an owning group over the components
+	template <typename FirstComponentType, typename... OtherComponentTypes, typename Func>
+	BenchmarkResult RunBenchmark(const BenchmarkOptions& Options, Func&& Update)
+	{
+		LE::EcsRegistry<LE::EcsEntity> registry;
+		std::vector<LE::EcsEntity> entities;
+		entities.reserve(Options.EntityCount);
+		for (LE::uint32 entityIdx = 0; entityIdx < Options.EntityCount; ++entityIdx)
+		{
+			const LE::EcsEntity entity = registry.CreateEntity();
+			registry.AddComponentToEntity<FirstComponentType>(entity);
+			(registry.AddComponentToEntity<OtherComponentTypes>(entity), ...);
+			entities.push_back(entity);
+		}
+
+		std::mt19937 random(1);
+		std::shuffle(entities.begin(), entities.end(), random);
+		for (LE::uint32 entityIdx = 0; entityIdx < static_cast<LE::uint64>(Options.EntityCount) * Options.ShuffledPercent / 100; ++entityIdx)
+		{
+			(registry.DeleteComponent<OtherComponentTypes>(entities[entityIdx]), ...);
+			(registry.AddComponentToEntity<OtherComponentTypes>(entities[entityIdx]), ...);
+		}
+
+		BenchmarkResult result;
+		const auto view = registry.View<FirstComponentType, OtherComponentTypes...>();
+		result.ViewNs = LE::MeasureFastest(Options.RepeatCount, [&view, &Update]
+		{
+			view.Each(Update);
+		});
+
+		const auto group = registry.Group<FirstComponentType, OtherComponentTypes...>();
+		result.GroupNs = LE::MeasureFastest(Options.RepeatCount, [&group, &Update]
+		{
+			group.Each(Update);
+		});
+		return result;
+	}
+
+	void PrintResult(LE::uint32 ComponentCount, const BenchmarkResult& Result)
+	{
+		std::cout << std::format("{:>10} {:>12.1f} {:>12.1f} {:>9.1f}x\n", ComponentCount, static_cast<double>(Result.ViewNs) / 1000.0,
+		                         static_cast<double>(Result.GroupNs) / 1000.0,
+		                         static_cast<double>(Result.ViewNs) / static_cast<double>(std::max<LE::uint64>(Result.GroupNs, 1)));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Log::Initialize();
+
+	BenchmarkOptions options;
+	const LE::BenchmarkOption commandLineOptions[] = {
+		LE::NumberOption("--entities", "<Count>", "Entities having all of the components", options.EntityCount, 1),
+		LE::NumberOption("--shuffled", "<Percent>", "Share of the entities whose other components are removed and added again",
+		                 options.ShuffledPercent, 0, 100),
+		LE::NumberOption("--repeats", "<Count>", "Passes per measurement, the fastest one is printed", options.RepeatCount, 1),
+	};
+	if (!LE::ParseBenchmarkOptions(argc, argv, commandLineOptions))
+	{
+		LE::PrintBenchmarkUsage("EcsGroupBenchmark", commandLineOptions);
+		return 1;
+	}
+
+	using namespace LE;
+	std::cout << std::format("{} entities, {}% of them with reordered components\n\n", options.EntityCount, options.ShuffledPercent);
+	std::cout << std::format("{:>10} {:>12} {:>12} {:>10}\n", "Components", "View (us)", "Group (us)", "Speedup");
+	PrintResult(2, RunBenchmark<BenchmarkPosition, BenchmarkVelocity>(options,
+		[](EcsEntity, BenchmarkPosition& Position, const BenchmarkVelocity& Velocity)
+		{
+			Position.Value += Velocity.Value;
+		}));
+	PrintResult(3, RunBenchmark<BenchmarkPosition, BenchmarkVelocity, BenchmarkAcceleration>(options,
+		[](EcsEntity, BenchmarkPosition& Position, const BenchmarkVelocity& Velocity, const BenchmarkAcceleration& Acceleration)
+		{
+			Position.Value += Velocity.Value + Acceleration.Value;
+		}));
+	PrintResult(4, RunBenchmark<BenchmarkPosition, BenchmarkVelocity, BenchmarkAcceleration, BenchmarkDamping>(options,
+		[](EcsEntity, BenchmarkPosition& Position, const BenchmarkVelocity& Velocity, const BenchmarkAcceleration& Acceleration,
+		   const BenchmarkDamping& Damping)
+		{
+			Position.Value += (Velocity.Value + Acceleration.Value) * Damping.Value;
+		}));
+
+	return 0;
+}
\ No newline at end of file
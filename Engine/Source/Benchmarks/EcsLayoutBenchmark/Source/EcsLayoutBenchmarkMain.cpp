@@ -0,0 +1,202 @@
+#include <format>
+#include <iostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "BenchmarkCommon.h"
+#include "ECS/Ecs.h"
+#include "ECS/EcsRegistry.h"
+#include "Math/Matrix4x4.h"
+
+namespace LE
+{
+// Same transform stored as an array of structs and as one column per matrix row, the last row is the position
+struct BenchmarkTransformAoS
+{
+	Matrix4x4F Transform;
+};
+
+struct BenchmarkTransformSoA
+{
+	Matrix4x4F Transform;
+};
+
+ECS_REGISTER_COMPONENT(BenchmarkTransformAoS, "BenchmarkTransformAoS")
+ECS_REGISTER_COMPONENT(BenchmarkTransformSoA, "BenchmarkTransformSoA")
+ECS_REGISTER_COMPONENT_COLUMNS(BenchmarkTransformSoA, EcsColumn<Vector4F, 0>, EcsColumn<Vector4F, 16>, EcsColumn<Vector4F, 32>,
+                               EcsColumn<Vector4F, 48>)
+}
+
+namespace
+{
+	using AoSStorage = LE::EcsComponentStorage<LE::BenchmarkTransformAoS, LE::EcsEntity>;
+	using SoAStorage = LE::EcsComponentStorage<LE::BenchmarkTransformSoA, LE::EcsEntity>;
+
+	struct BenchmarkOptions
+	{
+		LE::uint32 EntityCount = 200000;
+		LE::uint32 RepeatCount = 30;
+	};
+
+	// Keeps the sums of read-only passes alive
+	volatile float GSink = 0.0f;
+
+	template <typename Func>
+	LE::uint64 MeasureFastestSum(LE::uint32 RepeatCount, Func&& Function)
+	{
+		return LE::MeasureFastest(RepeatCount, [&Function]
+		{
+			GSink = GSink + Function();
+		});
+	}
+
+	float SumRow(const LE::Vector4F& Row)
+	{
+		return Row.X + Row.Y + Row.Z + Row.W;
+	}
+
+	float SumMatrix(const LE::Matrix4x4F& Matrix)
+	{
+		return SumRow(Matrix.M[0]) + SumRow(Matrix.M[1]) + SumRow(Matrix.M[2]) + SumRow(Matrix.M[3]);
+	}
+
+	void PrintResult(std::string_view AccessName, LE::uint64 AoSNs, LE::uint64 SoANs)
+	{
+		std::cout << std::format("{:>24} {:>10.1f} {:>10.1f}\n", AccessName, static_cast<double>(AoSNs) / 1000.0,
+		                         static_cast<double>(SoANs) / 1000.0);
+	}
+
+	// Every entity has both components with the same values. AoS is walked with EachChunk, SoA with EachColumns over
+	// the columns the access needs, and once more through Each, which gathers every component from its columns
+	void RunBenchmark(const BenchmarkOptions& Options)
+	{
+		LE::EcsRegistry<LE::EcsEntity> registry;
+		std::vector<LE::EcsEntity> entities(Options.EntityCount);
+		registry.CreateEntities(entities.begin(), entities.end());
+		for (LE::uint32 entityIdx = 0; entityIdx < Options.EntityCount; ++entityIdx)
+		{
+			LE::Matrix4x4F transform;
+			for (LE::uint32 row = 0; row < 4; ++row)
+			{
+				transform.M[row] = LE::Vector4F(static_cast<float>(entityIdx), 1.0f, 2.0f, static_cast<float>(row));
+			}
+			registry.AddComponentToEntity<LE::BenchmarkTransformAoS>(entities[entityIdx], LE::BenchmarkTransformAoS{transform});
+			registry.AddComponentToEntity<LE::BenchmarkTransformSoA>(entities[entityIdx], LE::BenchmarkTransformSoA{transform});
+		}
+
+		const auto aosView = registry.View<LE::BenchmarkTransformAoS>();
+		const auto soaView = registry.View<LE::BenchmarkTransformSoA>();
+
+		PrintResult("Position read", MeasureFastestSum(Options.RepeatCount, [&aosView]
+		{
+			float sum = 0.0f;
+			aosView.EachChunk([&sum](std::span<const LE::EcsEntity>, std::span<const LE::BenchmarkTransformAoS> Transforms)
+			{
+				for (const LE::BenchmarkTransformAoS& transform : Transforms)
+				{
+					sum += transform.Transform.M[3].X + transform.Transform.M[3].Y + transform.Transform.M[3].Z;
+				}
+			});
+			return sum;
+		}), MeasureFastestSum(Options.RepeatCount, [&soaView]
+		{
+			float sum = 0.0f;
+			soaView.EachColumns<3>([&sum](std::span<const LE::EcsEntity>, std::span<const LE::Vector4F> Positions)
+			{
+				for (const LE::Vector4F& position : Positions)
+				{
+					sum += position.X + position.Y + position.Z;
+				}
+			});
+			return sum;
+		}));
+
+		PrintResult("Position write", MeasureFastestSum(Options.RepeatCount, [&aosView]
+		{
+			aosView.EachChunk([](std::span<const LE::EcsEntity>, std::span<LE::BenchmarkTransformAoS> Transforms)
+			{
+				for (LE::BenchmarkTransformAoS& transform : Transforms)
+				{
+					transform.Transform.M[3].X += 1.0f;
+					transform.Transform.M[3].Y += 1.0f;
+					transform.Transform.M[3].Z += 1.0f;
+				}
+			});
+			return 0.0f;
+		}), MeasureFastestSum(Options.RepeatCount, [&soaView]
+		{
+			soaView.EachColumns<3>([](std::span<const LE::EcsEntity>, std::span<LE::Vector4F> Positions)
+			{
+				for (LE::Vector4F& position : Positions)
+				{
+					position.X += 1.0f;
+					position.Y += 1.0f;
+					position.Z += 1.0f;
+				}
+			});
+			return 0.0f;
+		}));
+
+		const LE::uint64 aosMatrixNs = MeasureFastestSum(Options.RepeatCount, [&aosView]
+		{
+			float sum = 0.0f;
+			aosView.EachChunk([&sum](std::span<const LE::EcsEntity>, std::span<const LE::BenchmarkTransformAoS> Transforms)
+			{
+				for (const LE::BenchmarkTransformAoS& transform : Transforms)
+				{
+					sum += SumMatrix(transform.Transform);
+				}
+			});
+			return sum;
+		});
+
+		PrintResult("Matrix read (columns)", aosMatrixNs, MeasureFastestSum(Options.RepeatCount, [&soaView]
+		{
+			float sum = 0.0f;
+			soaView.EachColumns<0, 1, 2, 3>([&sum](std::span<const LE::EcsEntity>, std::span<const LE::Vector4F> Rows0,
+			                                      std::span<const LE::Vector4F> Rows1, std::span<const LE::Vector4F> Rows2,
+			                                      std::span<const LE::Vector4F> Rows3)
+			{
+				for (size_t current = 0; current < Rows0.size(); ++current)
+				{
+					sum += SumRow(Rows0[current]) + SumRow(Rows1[current]) + SumRow(Rows2[current]) + SumRow(Rows3[current]);
+				}
+			});
+			return sum;
+		}));
+
+		PrintResult("Matrix read (gather)", aosMatrixNs, MeasureFastestSum(Options.RepeatCount, [&soaView]
+		{
+			float sum = 0.0f;
+			soaView.Each([&sum](LE::EcsEntity, SoAStorage::const_reference Transform)
+			{
+				sum += SumMatrix(LE::BenchmarkTransformSoA(Transform).Transform);
+			});
+			return sum;
+		}));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Log::Initialize();
+
+	BenchmarkOptions options;
+	const LE::BenchmarkOption commandLineOptions[] = {
+		LE::NumberOption("--entities", "<Count>", "Entities having the transform in both layouts", options.EntityCount, 1),
+		LE::NumberOption("--repeats", "<Count>", "Passes per measurement, the fastest one is printed", options.RepeatCount, 1),
+	};
+	if (!LE::ParseBenchmarkOptions(argc, argv, commandLineOptions))
+	{
+		LE::PrintBenchmarkUsage("EcsLayoutBenchmark", commandLineOptions);
+		return 1;
+	}
+
+	static_assert(SoAStorage::IsColumnar && !AoSStorage::IsColumnar);
+	std::cout << std::format("{} entities with a 4x4 matrix, SoA stores a column per row\n\n", options.EntityCount);
+	std::cout << std::format("{:>24} {:>10} {:>10}\n", "Access", "AoS (us)", "SoA (us)");
+	RunBenchmark(options);
+
+	return 0;
+}
\ No newline at end of file
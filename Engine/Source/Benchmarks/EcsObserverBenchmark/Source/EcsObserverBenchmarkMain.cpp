@@ -0,0 +1,170 @@
+#include <array>
+#include <format>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "BenchmarkCommon.h"
+#include "ECS/Ecs.h"
+#include "ECS/EcsRegistry.h"
+#include "Time/Clock.h"
+
+namespace LE
+{
+struct BenchmarkHealth
+{
+	float Value = 100.0f;
+};
+
+// Added and removed every frame, like a status effect or a per frame request
+struct BenchmarkMarker
+{
+	uint32 Value = 0;
+};
+
+ECS_REGISTER_COMPONENT(BenchmarkHealth, "BenchmarkHealth")
+ECS_REGISTER_COMPONENT(BenchmarkMarker, "BenchmarkMarker")
+}
+
+namespace
+{
+	struct BenchmarkOptions
+	{
+		LE::uint32 EntityCount = 50000;
+		LE::uint32 FrameCount = 30;
+	};
+
+	enum class BenchmarkPhase : LE::uint8
+	{
+		Added = 0,
+		Updated,
+		Removed,
+
+		Count
+	};
+
+	constexpr std::array<std::string_view, static_cast<size_t>(BenchmarkPhase::Count)> GPhaseNames = {"Added", "Updated", "Removed"};
+
+	struct PhaseResult
+	{
+		LE::uint64 BestNs = 0;
+		LE::uint64 TotalNs = 0;
+		LE::uint64 ObservedCount = 0; // Over all frames, every phase should see each entity once per frame
+	};
+
+	struct BenchmarkResult
+	{
+		std::array<PhaseResult, static_cast<size_t>(BenchmarkPhase::Count)> Phases;
+		LE::uint64 BestFrameNs = 0;
+		LE::uint64 TotalNs = 0;
+	};
+
+	template <typename Func>
+	LE::uint64 MeasurePhase(PhaseResult& Result, LE::uint32 Frame, Func&& Function)
+	{
+		const LE::uint64 startNs = LE::Clock::NowNs();
+		Result.ObservedCount += Function();
+		const LE::uint64 timeNs = LE::Clock::NowNs() - startNs;
+		LE::KeepFastest(Result.BestNs, timeNs, Frame == 0);
+		Result.TotalNs += timeNs;
+		return timeNs;
+	}
+
+	template <typename ObserverType>
+	LE::uint64 ReadAndReset(ObserverType& Observer)
+	{
+		LE::uint64 observedCount = 0;
+		for ([[maybe_unused]] const LE::EcsEntity entity : Observer)
+		{
+			++observedCount;
+		}
+		Observer.ResetObservedEntities();
+		return observedCount;
+	}
+
+	// Every frame the marker is added to all of the entities and removed again, and their health is written once.
+	// Each phase is timed together with reading and resetting the observer of it
+	BenchmarkResult RunBenchmark(const BenchmarkOptions& Options)
+	{
+		LE::EcsRegistry<LE::EcsEntity> registry;
+		std::vector<LE::EcsEntity> entities;
+		entities.reserve(Options.EntityCount);
+		for (LE::uint32 entityIdx = 0; entityIdx < Options.EntityCount; ++entityIdx)
+		{
+			entities.push_back(registry.CreateEntity());
+			registry.AddComponentToEntity<LE::BenchmarkHealth>(entities.back());
+		}
+
+		auto addedObserver = registry.Observe<LE::BenchmarkMarker, LE::BenchmarkHealth>(LE::ComponentChangeType::ComponentAdded);
+		auto updatedObserver = registry.Observe<LE::BenchmarkHealth>(LE::ComponentChangeType::ComponentUpdated);
+		auto removedObserver = registry.Observe<LE::BenchmarkMarker>(LE::ComponentChangeType::ComponentRemoved);
+		const auto healthView = registry.View<LE::BenchmarkHealth>();
+
+		BenchmarkResult result;
+		for (LE::uint32 frame = 0; frame < Options.FrameCount; ++frame)
+		{
+			LE::uint64 frameNs = MeasurePhase(result.Phases[static_cast<size_t>(BenchmarkPhase::Added)], frame, [&]
+			{
+				for (const LE::EcsEntity entity : entities)
+				{
+					registry.AddComponentToEntity<LE::BenchmarkMarker>(entity, LE::BenchmarkMarker{frame});
+				}
+				return ReadAndReset(addedObserver);
+			});
+
+			frameNs += MeasurePhase(result.Phases[static_cast<size_t>(BenchmarkPhase::Updated)], frame, [&]
+			{
+				healthView.Each([](LE::EcsEntity, LE::BenchmarkHealth& Health)
+				{
+					Health.Value -= 1.0f;
+				});
+				updatedObserver.CollectUpdatedEntities();
+				return ReadAndReset(updatedObserver);
+			});
+
+			frameNs += MeasurePhase(result.Phases[static_cast<size_t>(BenchmarkPhase::Removed)], frame, [&]
+			{
+				for (const LE::EcsEntity entity : entities)
+				{
+					registry.DeleteComponent<LE::BenchmarkMarker>(entity);
+				}
+				return ReadAndReset(removedObserver);
+			});
+
+			LE::KeepFastest(result.BestFrameNs, frameNs, frame == 0);
+			result.TotalNs += frameNs;
+		}
+		return result;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Log::Initialize();
+
+	BenchmarkOptions options;
+	const LE::BenchmarkOption commandLineOptions[] = {
+		LE::NumberOption("--entities", "<Count>", "Entities churned every frame", options.EntityCount, 1),
+		LE::NumberOption("--frames", "<Count>", "Frames measured", options.FrameCount, 1),
+	};
+	if (!LE::ParseBenchmarkOptions(argc, argv, commandLineOptions))
+	{
+		LE::PrintBenchmarkUsage("EcsObserverBenchmark", commandLineOptions);
+		return 1;
+	}
+
+	const BenchmarkResult result = RunBenchmark(options);
+
+	std::cout << std::format("{} entities churned per frame, {} frames\n\n", options.EntityCount, options.FrameCount);
+	std::cout << std::format("{:>8} {:>10} {:>14} {:>16}\n", "Phase", "Best (ms)", "Average (ms)", "Observed/frame");
+	for (size_t phase = 0; phase < result.Phases.size(); ++phase)
+	{
+		const PhaseResult& phaseResult = result.Phases[phase];
+		std::cout << std::format("{:>8} {:>10.2f} {:>14.2f} {:>16}\n", GPhaseNames[phase], static_cast<double>(phaseResult.BestNs) / 1e6,
+		                         static_cast<double>(phaseResult.TotalNs) / options.FrameCount / 1e6, phaseResult.ObservedCount / options.FrameCount);
+	}
+	std::cout << std::format("{:>8} {:>10.2f} {:>14.2f}\n", "Frame", static_cast<double>(result.BestFrameNs) / 1e6,
+	                         static_cast<double>(result.TotalNs) / options.FrameCount / 1e6);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BenchmarkCommon.h"
+#include "Multithreading/JobScheduler.h"
+#include "Multithreading/Utils/UpdateGraphDescription.h"
+#include "Time/Clock.h"
+
+namespace
+{
+	struct BenchmarkOptions
+	{
+		std::vector<LE::uint32> JobCounts = {1000, 2000, 4000};
+		LE::uint32 JobsPerPass = 25;
+		LE::uint32 ComponentCount = 200;
+		LE::uint32 ResourceCount = 20;
+		LE::uint32 RepeatCount = 5;
+		LE::uint32 Seed = 1;
+		LE::uint16 WorkerCount = 0; // Zero uses the default worker count of the scheduler
+		LE::uint32 FrameCount = 200;
+		LE::Path GraphPath; // Dumped update graph run instead of the generated ones
+	};
+
+	struct FrameResult
+	{
+		LE::uint64 FrameNs = 0;
+		double StolenJobs = 0.0; // Jobs executed by another thread than the one that queued them, per frame
+	};
+
+	// Fastest of the repeats, in ns
+	struct BenchmarkResult
+	{
+		LE::uint64 BuildNs = 0;
+		LE::uint64 RemovePassNs = 0;
+		LE::uint64 AddPassNs = 0;
+		LE::uint32 EdgeCount = 0;
+		FrameResult Frames; // Average over the frames of the first repeat
+	};
+
+	constexpr LE::uint32 GWarmUpFrameCount = 20;
+
+	// Jobs touch one to three components and sometimes a resource, reads are the most common and structural changes the rarest.
+	// Passes depend on one of the earlier passes half of the time
+	class GraphGenerator
+	{
+	public:
+		explicit GraphGenerator(const BenchmarkOptions& InOptions)
+			: Options(InOptions)
+			  , Random(InOptions.Seed)
+		{
+		}
+
+		// Passes that aren't dependable can be unregistered without leaving dangling dependencies behind
+		void AddPasses(LE::UpdateGraphDescription& Description, LE::uint32 JobCount, bool IsDependable)
+		{
+			for (LE::uint32 addedJobs = 0; addedJobs < JobCount; addedJobs += Options.JobsPerPass)
+			{
+				const std::string passName = std::format("Pass {}", PassCount++);
+				LE::UpdatePassDescription& pass = Description.Passes.emplace_back();
+				pass.Name = passName;
+				if (!DependablePasses.empty() && Random() % 2 == 0)
+				{
+					pass.DependsOn.push_back(DependablePasses[Random() % DependablePasses.size()]);
+				}
+				if (IsDependable)
+				{
+					DependablePasses.push_back(passName);
+				}
+
+				for (LE::uint32 jobIdx = 0; jobIdx < std::min(Options.JobsPerPass, JobCount - addedJobs); ++jobIdx)
+				{
+					LE::UpdateJobDescription& job = Description.Jobs.emplace_back();
+					job.Name = std::format("{} Job {}", passName, jobIdx);
+					job.PassName = passName;
+					AddAccesses(job);
+				}
+			}
+		}
+
+	private:
+		void AddAccesses(LE::UpdateJobDescription& Job)
+		{
+			const LE::uint32 accessCount = 1 + Random() % 3;
+			for (LE::uint32 access = 0; access < accessCount; ++access)
+			{
+				Job.Components[GetOperation()].push_back(Random() % Options.ComponentCount);
+			}
+
+			if (Options.ResourceCount > 0 && Random() % 4 == 0)
+			{
+				Job.Resources[GetOperation()].push_back(Random() % Options.ResourceCount);
+			}
+		}
+
+		// Read, write, add and delete, in the order of UpdateJob operations
+		size_t GetOperation()
+		{
+			const LE::uint32 roll = Random() % 10;
+			return roll < 5 ? 0 : roll < 8 ? 1 : roll < 9 ? 2 : 3;
+		}
+
+		const BenchmarkOptions& Options;
+		std::mt19937 Random;
+		std::vector<std::string> DependablePasses;
+		LE::uint32 PassCount = 0;
+	};
+
+	LE::uint32 CountEdges(const LE::JobGraph& Graph)
+	{
+		LE::uint32 edgeCount = 0;
+		for (LE::uint32 jobIdx = 0; jobIdx < Graph.GetJobCount(); ++jobIdx)
+		{
+			edgeCount += static_cast<LE::uint32>(Graph.GetJob(jobIdx)->GetDependentJobs().size());
+		}
+		return edgeCount;
+	}
+
+	// Registered and unregistered passes are picked up by the next rebuild, like passes of modules loaded between frames
+	LE::uint64 MeasureRebuild()
+	{
+		const LE::uint64 startNs = LE::Clock::NowNs();
+		LE::JobScheduler::Get()->RebuildChangedUpdatePasses();
+		return LE::Clock::NowNs() - startNs;
+	}
+
+	// Jobs of the generated graphs do nothing, so a frame costs only the scheduling of its jobs: the frame start, readiness counters,
+	// queues, wakeups and telemetry
+	FrameResult MeasureFrames(LE::uint32 FrameCount)
+	{
+		LE::JobScheduler* scheduler = LE::JobScheduler::Get();
+		const LE::JobGraph& graph = scheduler->GetCompiledGraph();
+		LE::uint64 totalNs = 0;
+		LE::uint64 stolenJobCount = 0;
+		for (LE::uint32 frame = 0; frame < GWarmUpFrameCount + FrameCount; ++frame)
+		{
+			const LE::uint64 startNs = LE::Clock::NowNs();
+			scheduler->StartFrame();
+			scheduler->HelpWorkerThreads();
+			scheduler->WaitForAll();
+			if (frame < GWarmUpFrameCount)
+			{
+				continue;
+			}
+
+			totalNs += LE::Clock::NowNs() - startNs;
+			for (LE::uint32 jobIndex = 0; jobIndex < graph.GetJobCount(); ++jobIndex)
+			{
+				stolenJobCount += graph.GetJob(jobIndex)->WasLastExecutionStolen();
+			}
+		}
+		return {totalNs / FrameCount, static_cast<double>(stolenJobCount) / FrameCount};
+	}
+
+	// Builds the whole graph into an empty scheduler, then unregisters a pass from the middle of it and registers it again.
+	// Only the passes sharing components or resources with it are rebuilt then. The complete graph is then run for a number of frames
+	BenchmarkResult RunBenchmark(LE::uint32 JobCount, const BenchmarkOptions& Options)
+	{
+		BenchmarkResult result;
+		for (LE::uint32 repeat = 0; repeat < Options.RepeatCount; ++repeat)
+		{
+			GraphGenerator generator(Options);
+			const LE::uint32 middleJobCount = std::min(Options.JobsPerPass, JobCount);
+			const LE::uint32 headJobCount = (JobCount - middleJobCount) / 2;
+			LE::UpdateGraphDescription headDescription;
+			LE::UpdateGraphDescription middleDescription;
+			LE::UpdateGraphDescription tailDescription;
+			generator.AddPasses(headDescription, headJobCount, true);
+			generator.AddPasses(middleDescription, middleJobCount, false);
+			generator.AddPasses(tailDescription, JobCount - middleJobCount - headJobCount, true);
+
+			{
+				LE::UpdateGraphInstance head(headDescription);
+				LE::UniquePtr<LE::UpdateGraphInstance> middle = std::make_unique<LE::UpdateGraphInstance>(middleDescription);
+				LE::UpdateGraphInstance tail(tailDescription);
+				LE::KeepFastest(result.BuildNs, MeasureRebuild(), repeat == 0);
+				result.EdgeCount = CountEdges(LE::JobScheduler::Get()->GetCompiledGraph());
+
+				middle.reset();
+				LE::KeepFastest(result.RemovePassNs, MeasureRebuild(), repeat == 0);
+				middle = std::make_unique<LE::UpdateGraphInstance>(middleDescription);
+				LE::KeepFastest(result.AddPassNs, MeasureRebuild(), repeat == 0);
+				if (repeat == 0 && Options.FrameCount > 0)
+				{
+					result.Frames = MeasureFrames(Options.FrameCount);
+				}
+			}
+			MeasureRebuild();
+		}
+		return result;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Log::Initialize();
+
+	BenchmarkOptions options;
+	const LE::BenchmarkOption commandLineOptions[] = {
+		LE::NumberListOption("--jobs", "1000,2000", "Job counts of the generated graphs", options.JobCounts),
+		LE::NumberOption("--jobs-per-pass", "<Count>", "Jobs in every pass", options.JobsPerPass, 1),
+		LE::NumberOption("--components", "<Count>", "Components the jobs access", options.ComponentCount, 1),
+		LE::NumberOption("--resources", "<Count>", "Shared resources the jobs access", options.ResourceCount),
+		LE::NumberOption("--repeats", "<Count>", "Measurements per graph, the fastest one is printed", options.RepeatCount, 1),
+		LE::NumberOption("--seed", "<Seed>", "Seed of the generated graphs", options.Seed),
+		LE::NumberOption("--workers", "<Count>", "Worker threads running the frames, the scheduler default if not set", options.WorkerCount, 1),
+		LE::NumberOption("--frames", "<Count>", "Frames of empty jobs run on every graph, 0 only measures the rebuilds", options.FrameCount),
+		{"--graph", "<UpdatePass.json>", "Runs the frames on an update graph dumped by the engine instead", [&options](std::string_view Value)
+		{
+			options.GraphPath = Value;
+			return true;
+		}},
+	};
+	if (!LE::ParseBenchmarkOptions(argc, argv, commandLineOptions))
+	{
+		LE::PrintBenchmarkUsage("UpdateGraphBenchmark", commandLineOptions);
+		return 1;
+	}
+
+	LE::JobScheduler* scheduler = LE::JobScheduler::Get();
+	const LE::uint16 workerCount = options.WorkerCount > 0 ? options.WorkerCount : LE::JobScheduler::GetDefaultWorkerThreadCount();
+	scheduler->Init(workerCount);
+	scheduler->StartRenderThread();
+
+	// Jobs of the dumped graph keep their dependencies, but do nothing like the generated ones
+	if (!options.GraphPath.empty())
+	{
+		LE::UpdateGraphDescription description;
+		if (!description.Load(options.GraphPath))
+		{
+			return 1;
+		}
+
+		FrameResult result;
+		{
+			LE::UpdateGraphInstance graphInstance(description);
+			MeasureRebuild();
+			result = MeasureFrames(std::max(options.FrameCount, 1u));
+		}
+		MeasureRebuild();
+
+		const size_t jobCount = description.Jobs.size();
+		std::cout << std::format("\n{}, {} workers\n\n", options.GraphPath.string(), workerCount);
+		std::cout << std::format("{:>8} {:>12} {:>10} {:>14}\n", "Jobs", "Frame (us)", "ns/job", "Stolen/frame");
+		std::cout << std::format("{:>8} {:>12.1f} {:>10.1f} {:>14.1f}\n", jobCount, static_cast<double>(result.FrameNs) / 1000.0,
+		                         static_cast<double>(result.FrameNs) / std::max<size_t>(jobCount, 1), result.StolenJobs);
+		scheduler->Shutdown();
+		return 0;
+	}
+
+	std::vector<std::pair<LE::uint32, BenchmarkResult>> results;
+	for (const LE::uint32 jobCount : options.JobCounts)
+	{
+		results.emplace_back(jobCount, RunBenchmark(jobCount, options));
+	}
+
+	// Printed after all runs, as rebuilds log every processed pass
+	std::cout << std::format("\n{} jobs per pass, {} components, {} resources, {} workers\n\n", options.JobsPerPass, options.ComponentCount,
+	                         options.ResourceCount, workerCount);
+	std::cout << std::format("{:>8} {:>8} {:>12} {:>18} {:>15} {:>12} {:>10} {:>14}\n", "Jobs", "Edges", "Build (us)", "Remove pass (us)",
+	                         "Add pass (us)", "Frame (us)", "ns/job", "Stolen/frame");
+	for (const auto& [jobCount, result] : results)
+	{
+		std::cout << std::format("{:>8} {:>8} {:>12} {:>18} {:>15} {:>12.1f} {:>10.1f} {:>14.1f}\n", jobCount, result.EdgeCount,
+		                         result.BuildNs / 1000, result.RemovePassNs / 1000, result.AddPassNs / 1000,
+		                         static_cast<double>(result.Frames.FrameNs) / 1000.0, static_cast<double>(result.Frames.FrameNs) / jobCount,
+		                         result.Frames.StolenJobs);
+	}
+
+	scheduler->Shutdown();
+
+	return 0;
+}
\ No newline at end of file
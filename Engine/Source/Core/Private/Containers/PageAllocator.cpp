@@ -0,0 +1,141 @@
+#include "Containers/PageAllocator.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "Core.h"
+
+#if PLATFORM_WINDOWS
+#include <malloc.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace LE
+{
+namespace
+{
+	size_t AlignSize(size_t Size, size_t Alignment)
+	{
+		return (Size + Alignment - 1) / Alignment * Alignment;
+	}
+}
+
+PageAllocator& PageAllocator::Get()
+{
+	static PageAllocator* allocator = new PageAllocator;
+	return *allocator;
+}
+
+void* PageAllocator::Allocate(size_t Size)
+{
+	const size_t allocationSize = AlignSize(Size, PageAlignment);
+	bool isLargePage = false;
+	{
+		std::lock_guard lock(Mutex);
+		auto freeList = std::find_if(FreeLists.begin(), FreeLists.end(), [allocationSize](const FreeList& List)
+		{
+			return List.Size == allocationSize;
+		});
+		if (freeList != FreeLists.end() && !freeList->Pages.empty())
+		{
+			void* page = freeList->Pages.back();
+			freeList->Pages.pop_back();
+			FreeBytes -= allocationSize;
+			return page;
+		}
+
+		isLargePage = UseLargePages && allocationSize >= LargePageSize;
+	}
+
+	void* page = AllocateFromSystem(allocationSize, isLargePage);
+	LE_ASSERT_DESC(page, "Out of memory allocating a {} byte page", allocationSize)
+
+	std::lock_guard lock(Mutex);
+	AllocatedBytes += allocationSize;
+	return page;
+}
+
+void PageAllocator::Free(void* Page, size_t Size)
+{
+	if (!Page)
+	{
+		return;
+	}
+
+	const size_t allocationSize = AlignSize(Size, PageAlignment);
+	std::lock_guard lock(Mutex);
+	auto freeList = std::find_if(FreeLists.begin(), FreeLists.end(), [allocationSize](const FreeList& List)
+	{
+		return List.Size == allocationSize;
+	});
+	if (freeList == FreeLists.end())
+	{
+		freeList = FreeLists.insert(FreeLists.end(), FreeList{allocationSize, {}});
+	}
+
+	freeList->Pages.push_back(Page);
+	FreeBytes += allocationSize;
+}
+
+void PageAllocator::ReleaseFreePages()
+{
+	std::lock_guard lock(Mutex);
+	for (FreeList& freeList : FreeLists)
+	{
+		for (void* page : freeList.Pages)
+		{
+			FreeToSystem(page);
+		}
+
+		AllocatedBytes -= freeList.Pages.size() * freeList.Size;
+		freeList.Pages.clear();
+	}
+	FreeBytes = 0;
+}
+
+void PageAllocator::SetUseLargePages(bool InUseLargePages)
+{
+	std::lock_guard lock(Mutex);
+	UseLargePages = InUseLargePages;
+}
+
+size_t PageAllocator::GetAllocatedBytes() const
+{
+	std::lock_guard lock(Mutex);
+	return AllocatedBytes;
+}
+
+size_t PageAllocator::GetFreeBytes() const
+{
+	std::lock_guard lock(Mutex);
+	return FreeBytes;
+}
+
+void* PageAllocator::AllocateFromSystem(size_t Size, bool IsLargePage)
+{
+	const size_t alignment = IsLargePage ? LargePageSize : PageAlignment;
+#if PLATFORM_WINDOWS
+	return _aligned_malloc(Size, alignment);
+#else
+	// aligned_alloc wants the size to be a multiple of the alignment
+	void* page = std::aligned_alloc(alignment, AlignSize(Size, alignment));
+#if defined(__linux__)
+	if (page && IsLargePage)
+	{
+		madvise(page, AlignSize(Size, alignment), MADV_HUGEPAGE);
+	}
+#endif
+	return page;
+#endif
+}
+
+void PageAllocator::FreeToSystem(void* Page)
+{
+#if PLATFORM_WINDOWS
+	_aligned_free(Page);
+#else
+	std::free(Page);
+#endif
+}
+}
\ No newline at end of file
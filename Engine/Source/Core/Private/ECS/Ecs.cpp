@@ -1,11 +1,15 @@
 #include "ECS/Ecs.h"
 
+#include <atomic>
+
 #include "Log.h"
+#include "Multithreading/JobNode.h"
 
 
 namespace LE
 {
 static UniquePtr<ECSModule> GEcsModule;
+static std::atomic<EcsTick> GEcsChangeTick = 1;
 
 void RegisterECSModule(UniquePtr<ECSModule> Module)
 {
@@ -21,4 +25,27 @@ ECSModule& GetECSModule()
 
 	return *GEcsModule;
 }
+
+EcsTick GetEcsChangeTick()
+{
+	return GEcsChangeTick.load(std::memory_order_relaxed);
+}
+
+EcsTick AdvanceEcsChangeTick()
+{
+	return GEcsChangeTick.fetch_add(1, std::memory_order_relaxed);
+}
+
+EcsTick GetSystemLastRunTick()
+{
+	for (const JobNode* job = JobNode::GetCurrentJob(); job; job = job->GetParent())
+	{
+		if (job->IsGraphJob())
+		{
+			return job->GetLastRunChangeTick();
+		}
+	}
+
+	return 0;
+}
 }
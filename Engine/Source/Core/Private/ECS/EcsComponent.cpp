@@ -1,6 +1,79 @@
 #include "ECS/EcsComponent.h"
 
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Core.h"
+
 namespace LE
 {
-	
+namespace
+{
+	struct EcsComponentTypeInfo
+	{
+		std::string_view TypeName;
+		EcsComponentType TypeId;
+		const void* TypeKey;
+	};
+
+	struct EcsComponentTypeRegistry
+	{
+		std::mutex Mutex;
+		std::vector<EcsComponentTypeInfo> Types; // Indexed by EcsComponentIndex
+		std::unordered_map<EcsComponentType, EcsComponentIndex> TypeIndices;
+	};
+
+	// Function static, components register themselves during static initialization
+	EcsComponentTypeRegistry& GetComponentTypeRegistry()
+	{
+		static EcsComponentTypeRegistry registry;
+		return registry;
+	}
+}
+
+EcsComponentIndex RegisterEcsComponentType(std::string_view TypeName, EcsComponentType TypeId, const void* TypeKey)
+{
+	EcsComponentTypeRegistry& registry = GetComponentTypeRegistry();
+	std::lock_guard lock(registry.Mutex);
+
+	const auto it = registry.TypeIndices.find(TypeId);
+	if (it != registry.TypeIndices.end())
+	{
+		const EcsComponentTypeInfo& registeredType = registry.Types[it->second];
+		LE_ASSERT_DESC(registeredType.TypeName == TypeName, "Component names {} and {} have the same hash, rename one of them",
+		               registeredType.TypeName, TypeName)
+		LE_ASSERT_DESC(registeredType.TypeKey == TypeKey, "Component name {} is registered for two different types", TypeName)
+		return it->second;
+	}
+
+	const EcsComponentIndex index = static_cast<EcsComponentIndex>(registry.Types.size());
+	LE_ASSERT_DESC(index < ECS_MAX_COMPONENT_TYPES, "Too many component types, raise ECS_MAX_COMPONENT_TYPES")
+	registry.Types.push_back({TypeName, TypeId, TypeKey});
+	registry.TypeIndices.emplace(TypeId, index);
+	return index;
+}
+
+uint32 GetRegisteredEcsComponentCount()
+{
+	EcsComponentTypeRegistry& registry = GetComponentTypeRegistry();
+	std::lock_guard lock(registry.Mutex);
+	return static_cast<uint32>(registry.Types.size());
+}
+
+EcsComponentType GetEcsComponentType(EcsComponentIndex Index)
+{
+	EcsComponentTypeRegistry& registry = GetComponentTypeRegistry();
+	std::lock_guard lock(registry.Mutex);
+	LE_ASSERT_DESC(Index < registry.Types.size(), "Component index {} isn't registered", Index)
+	return registry.Types[Index].TypeId;
+}
+
+EcsComponentIndex FindEcsComponentIndex(EcsComponentType TypeId)
+{
+	EcsComponentTypeRegistry& registry = GetComponentTypeRegistry();
+	std::lock_guard lock(registry.Mutex);
+	const auto it = registry.TypeIndices.find(TypeId);
+	return it != registry.TypeIndices.end() ? it->second : InvalidEcsComponentIndex;
+}
 }
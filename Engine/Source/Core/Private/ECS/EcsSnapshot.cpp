@@ -0,0 +1,68 @@
+#include "ECS/EcsSnapshot.h"
+
+#include <cstring>
+
+#include "Math/Math.h"
+
+namespace LE
+{
+void EcsSnapshotBufferWriter::Write(const void* Data, size_t Size)
+{
+	if (Size == 0)
+	{
+		return;
+	}
+
+	if (BufferSize + Size > BufferCapacity)
+	{
+		Reserve(Max(BufferSize + Size, BufferCapacity * 2));
+	}
+
+	std::memcpy(Buffer.get() + BufferSize, Data, Size);
+	BufferSize += Size;
+}
+
+void EcsSnapshotBufferWriter::Reserve(size_t Capacity)
+{
+	if (Capacity <= BufferCapacity)
+	{
+		return;
+	}
+
+	UniquePtr<std::byte[]> buffer(new std::byte[Capacity]);
+	if (BufferSize > 0)
+	{
+		std::memcpy(buffer.get(), Buffer.get(), BufferSize);
+	}
+	Buffer = std::move(buffer);
+	BufferCapacity = Capacity;
+}
+
+const std::byte* EcsSnapshotReader::ReadBlock(size_t Size)
+{
+	if (IsFailed || Size > Data.size() - Position)
+	{
+		IsFailed = true;
+		return nullptr;
+	}
+
+	const std::byte* block = Data.data() + Position;
+	Position += Size;
+	return block;
+}
+
+bool EcsSnapshotReader::Read(void* OutData, size_t Size)
+{
+	const std::byte* block = ReadBlock(Size);
+	if (!block)
+	{
+		return false;
+	}
+
+	if (Size > 0)
+	{
+		std::memcpy(OutData, block, Size);
+	}
+	return true;
+}
+}
\ No newline at end of file
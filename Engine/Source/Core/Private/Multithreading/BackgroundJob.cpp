@@ -0,0 +1,37 @@
+#include "Multithreading/BackgroundJob.h"
+
+#include "Multithreading/JobScheduler.h"
+
+namespace LE
+{
+void BackgroundJob::YieldToFrameJobs()
+{
+	Owner->RunPendingFrameJobs();
+}
+
+void BackgroundJob::Cancel()
+{
+	IsCancelRequested.store(true, std::memory_order_release);
+	Owner->CancelQueuedBackgroundJob(this);
+}
+
+void BackgroundJob::Wait() const
+{
+	for (BackgroundJobState state = GetState(); state == BackgroundJobState::Queued || state == BackgroundJobState::Running; state = GetState())
+	{
+		State.wait(state, std::memory_order_acquire);
+	}
+}
+
+void BackgroundJob::Run()
+{
+	if (!IsCancellationRequested())
+	{
+		State.store(BackgroundJobState::Running, std::memory_order_release);
+		Function(*this);
+	}
+
+	State.store(IsCancellationRequested() ? BackgroundJobState::Cancelled : BackgroundJobState::Completed, std::memory_order_release);
+	State.notify_all();
+}
+}
\ No newline at end of file
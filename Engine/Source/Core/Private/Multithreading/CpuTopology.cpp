@@ -0,0 +1,367 @@
+#include "Multithreading/CpuTopology.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <thread>
+
+#include "Core.h"
+#include "Math/Math.h"
+
+#if PLATFORM_WINDOWS
+#include <Windows.h>
+#elif defined(__linux__)
+#include <filesystem>
+#include <fstream>
+#include <string>
+#endif
+
+namespace LE
+{
+namespace
+{
+#if defined(__linux__) && !PLATFORM_WINDOWS
+	bool ReadSysfsValue(const std::filesystem::path& FilePath, uint32& OutValue)
+	{
+		std::ifstream file(FilePath);
+		return static_cast<bool>(file >> OutValue);
+	}
+
+	// Parses the kernel cpulist format, e.g. "0-3,8,10-11"
+	std::vector<uint32> ParseCpuList(const std::filesystem::path& FilePath)
+	{
+		std::vector<uint32> cpus;
+		std::ifstream file(FilePath);
+		std::string list;
+		if (!(file >> list))
+		{
+			return cpus;
+		}
+
+		size_t position = 0;
+		while (position < list.size())
+		{
+			const size_t rangeEnd = list.find(',', position);
+			const std::string range = list.substr(position, rangeEnd == std::string::npos ? std::string::npos : rangeEnd - position);
+			const size_t dash = range.find('-');
+			const uint32 first = static_cast<uint32>(std::stoul(range.substr(0, dash)));
+			const uint32 last = dash == std::string::npos ? first : static_cast<uint32>(std::stoul(range.substr(dash + 1)));
+			for (uint32 cpu = first; cpu <= last; ++cpu)
+			{
+				cpus.push_back(cpu);
+			}
+
+			if (rangeEnd == std::string::npos)
+			{
+				break;
+			}
+			position = rangeEnd + 1;
+		}
+
+		return cpus;
+	}
+#endif
+}
+
+const CpuTopology& CpuTopology::Get()
+{
+	static CpuTopology topology;
+	return topology;
+}
+
+CpuTopology::CpuTopology()
+{
+	Probed = ProbePlatform();
+	if (!Probed)
+	{
+		SetupFallback();
+	}
+
+	FinalizeProbe();
+}
+
+const LogicalCpuInfo* CpuTopology::FindLogicalCpu(uint32 LogicalId) const
+{
+	for (const LogicalCpuInfo& cpu : LogicalCpus)
+	{
+		if (cpu.LogicalId == LogicalId)
+		{
+			return &cpu;
+		}
+	}
+
+	return nullptr;
+}
+
+std::vector<uint32> CpuTopology::GetAffinityOrder(ThreadAffinityPolicy Policy) const
+{
+	std::vector<uint32> order;
+	if (Policy == ThreadAffinityPolicy::None || !Probed)
+	{
+		return order;
+	}
+
+	std::vector<const LogicalCpuInfo*> cpus;
+	for (const LogicalCpuInfo& cpu : LogicalCpus)
+	{
+		if (Policy != ThreadAffinityPolicy::PhysicalCores || cpu.SmtIndex == 0)
+		{
+			cpus.push_back(&cpu);
+		}
+	}
+
+	// Compact order, neighbours share as much of the hierarchy as possible
+	std::sort(cpus.begin(), cpus.end(), [](const LogicalCpuInfo* Left, const LogicalCpuInfo* Right)
+	{
+		return std::tie(Left->NumaNode, Left->CacheDomainId, Left->CoreId, Left->SmtIndex)
+			< std::tie(Right->NumaNode, Right->CacheDomainId, Right->CoreId, Right->SmtIndex);
+	});
+
+	if (Policy == ThreadAffinityPolicy::Scatter)
+	{
+		// Round-robin over cache domains one core at a time, domains of different NUMA nodes are interleaved.
+		// All first hardware threads of cores go before any SMT sibling
+		using DomainKey = std::tuple<uint32, uint32, uint32>; // SmtIndex, domain rank inside its node, node
+		std::map<std::pair<uint32, uint32>, uint32> domainRanks;
+		std::map<uint32, uint32> domainCountPerNode;
+		std::map<DomainKey, std::vector<const LogicalCpuInfo*>> domains;
+		for (const LogicalCpuInfo* cpu : cpus)
+		{
+			const std::pair<uint32, uint32> domain(cpu->NumaNode, cpu->CacheDomainId);
+			if (!domainRanks.contains(domain))
+			{
+				domainRanks[domain] = domainCountPerNode[cpu->NumaNode]++;
+			}
+
+			domains[DomainKey(cpu->SmtIndex, domainRanks[domain], cpu->NumaNode)].push_back(cpu);
+		}
+
+		cpus.clear();
+		auto levelBegin = domains.begin();
+		while (levelBegin != domains.end())
+		{
+			const uint32 smtIndex = std::get<0>(levelBegin->first);
+			auto levelEnd = levelBegin;
+			size_t longestDomain = 0;
+			while (levelEnd != domains.end() && std::get<0>(levelEnd->first) == smtIndex)
+			{
+				longestDomain = Max(longestDomain, levelEnd->second.size());
+				++levelEnd;
+			}
+
+			for (size_t round = 0; round < longestDomain; ++round)
+			{
+				for (auto it = levelBegin; it != levelEnd; ++it)
+				{
+					if (round < it->second.size())
+					{
+						cpus.push_back(it->second[round]);
+					}
+				}
+			}
+
+			levelBegin = levelEnd;
+		}
+	}
+
+	order.reserve(cpus.size());
+	for (const LogicalCpuInfo* cpu : cpus)
+	{
+		order.push_back(cpu->LogicalId);
+	}
+
+	return order;
+}
+
+bool CpuTopology::ProbePlatform()
+{
+#if PLATFORM_WINDOWS
+	DWORD length = 0;
+	GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+	if (GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+	{
+		return false;
+	}
+
+	std::vector<uint8> buffer(length);
+	if (!GetLogicalProcessorInformationEx(RelationAll, reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data()), &length))
+	{
+		return false;
+	}
+
+	// Logical id is group * 64 + bit, same as what the affinity setup expects
+	auto forEachCpu = [](const GROUP_AFFINITY& Affinity, auto&& Function)
+	{
+		for (uint32 bit = 0; bit < 64; ++bit)
+		{
+			if (Affinity.Mask & (static_cast<KAFFINITY>(1) << bit))
+			{
+				Function(static_cast<uint32>(Affinity.Group) * 64 + bit);
+			}
+		}
+	};
+
+	std::map<uint32, LogicalCpuInfo> cpus;
+	uint32 coreId = 0;
+	uint32 packageId = 0;
+	uint32 cacheDomainId = 0;
+	for (DWORD offset = 0; offset < length;)
+	{
+		const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX& info = *reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+		switch (info.Relationship)
+		{
+		case RelationProcessorCore:
+			{
+				uint32 smtIndex = 0;
+				for (WORD group = 0; group < info.Processor.GroupCount; ++group)
+				{
+					forEachCpu(info.Processor.GroupMask[group], [&](uint32 LogicalId)
+					{
+						cpus[LogicalId].LogicalId = LogicalId;
+						cpus[LogicalId].CoreId = coreId;
+						cpus[LogicalId].SmtIndex = smtIndex++;
+					});
+				}
+				++coreId;
+				break;
+			}
+		case RelationProcessorPackage:
+			{
+				for (WORD group = 0; group < info.Processor.GroupCount; ++group)
+				{
+					forEachCpu(info.Processor.GroupMask[group], [&](uint32 LogicalId)
+					{
+						cpus[LogicalId].PackageId = packageId;
+					});
+				}
+				++packageId;
+				break;
+			}
+		case RelationNumaNode:
+			{
+				forEachCpu(info.NumaNode.GroupMask, [&](uint32 LogicalId)
+				{
+					cpus[LogicalId].NumaNode = info.NumaNode.NodeNumber;
+				});
+				break;
+			}
+		case RelationCache:
+			{
+				if (info.Cache.Level == 3)
+				{
+					forEachCpu(info.Cache.GroupMask, [&](uint32 LogicalId)
+					{
+						cpus[LogicalId].CacheDomainId = cacheDomainId;
+					});
+					++cacheDomainId;
+				}
+				break;
+			}
+		default:
+			break;
+		}
+
+		offset += info.Size;
+	}
+
+	for (const auto& cpu : cpus)
+	{
+		LogicalCpus.push_back(cpu.second);
+	}
+
+	return !LogicalCpus.empty();
+#elif defined(__linux__)
+	const std::filesystem::path cpuRoot = "/sys/devices/system/cpu";
+	const std::vector<uint32> onlineCpus = ParseCpuList(cpuRoot / "online");
+	if (onlineCpus.empty())
+	{
+		return false;
+	}
+
+	std::map<uint32, uint32> numaNodes;
+	for (uint32 node = 0; std::filesystem::exists(std::filesystem::path("/sys/devices/system/node") / ("node" + std::to_string(node))); ++node)
+	{
+		for (uint32 cpu : ParseCpuList(std::filesystem::path("/sys/devices/system/node") / ("node" + std::to_string(node)) / "cpulist"))
+		{
+			numaNodes[cpu] = node;
+		}
+	}
+
+	std::map<std::pair<uint32, uint32>, uint32> coreIds;
+	std::map<uint32, uint32> smtCounts;
+	for (uint32 cpu : onlineCpus)
+	{
+		const std::filesystem::path cpuPath = cpuRoot / ("cpu" + std::to_string(cpu));
+		LogicalCpuInfo info;
+		info.LogicalId = cpu;
+
+		uint32 coreId = cpu;
+		if (!ReadSysfsValue(cpuPath / "topology" / "core_id", coreId) || !ReadSysfsValue(cpuPath / "topology" / "physical_package_id", info.PackageId))
+		{
+			return false;
+		}
+
+		// core_id is only unique within a package
+		const std::pair<uint32, uint32> coreKey(info.PackageId, coreId);
+		if (!coreIds.contains(coreKey))
+		{
+			const uint32 newCoreId = static_cast<uint32>(coreIds.size());
+			coreIds[coreKey] = newCoreId;
+		}
+		info.CoreId = coreIds[coreKey];
+		info.SmtIndex = smtCounts[info.CoreId]++;
+		info.NumaNode = numaNodes.contains(cpu) ? numaNodes[cpu] : 0;
+
+		// Highest cache level is the last level cache, the first CPU sharing it identifies the domain
+		uint32 highestLevel = 0;
+		for (uint32 index = 0; std::filesystem::exists(cpuPath / "cache" / ("index" + std::to_string(index))); ++index)
+		{
+			const std::filesystem::path cachePath = cpuPath / "cache" / ("index" + std::to_string(index));
+			uint32 level = 0;
+			if (ReadSysfsValue(cachePath / "level", level) && level >= highestLevel)
+			{
+				const std::vector<uint32> sharedCpus = ParseCpuList(cachePath / "shared_cpu_list");
+				if (!sharedCpus.empty())
+				{
+					highestLevel = level;
+					info.CacheDomainId = sharedCpus.front();
+				}
+			}
+		}
+
+		LogicalCpus.push_back(info);
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+void CpuTopology::SetupFallback()
+{
+	LogicalCpus.clear();
+	const uint32 cpuCount = Max(std::thread::hardware_concurrency(), 1u);
+	for (uint32 cpu = 0; cpu < cpuCount; ++cpu)
+	{
+		LogicalCpuInfo info;
+		info.LogicalId = cpu;
+		info.CoreId = cpu;
+		LogicalCpus.push_back(info);
+	}
+}
+
+void CpuTopology::FinalizeProbe()
+{
+	uint32 maxCoreId = 0;
+	uint32 maxNumaNode = 0;
+	for (const LogicalCpuInfo& cpu : LogicalCpus)
+	{
+		maxCoreId = Max(maxCoreId, cpu.CoreId);
+		maxNumaNode = Max(maxNumaNode, cpu.NumaNode);
+	}
+
+	PhysicalCoreCount = LogicalCpus.empty() ? 0 : maxCoreId + 1;
+	NumaNodeCount = maxNumaNode + 1;
+}
+}
\ No newline at end of file
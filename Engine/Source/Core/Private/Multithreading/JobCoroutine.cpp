@@ -0,0 +1,49 @@
+#include "Multithreading/JobCoroutine.h"
+
+namespace LE
+{
+bool JobWaitListAwaiter::await_suspend(std::coroutine_handle<> Handle)
+{
+	JobNode* currentJob = JobNode::GetCurrentJob();
+	LE_ASSERT_DESC(currentJob, "Coroutine has to run as a job to be suspended")
+
+	// Job the coroutine runs in stays incomplete while the coroutine is suspended
+	Waiter.SuspendedJob = currentJob;
+	Waiter.Handle = Handle;
+	currentJob->HoldCompletion();
+	if (!WaitList.AddWaiter(Waiter))
+	{
+		currentJob->ReleaseCompletion();
+		return false;
+	}
+
+	return true;
+}
+
+JobCounter::JobCounter(uint32 InitialValue)
+	: Value(InitialValue)
+{
+	if (InitialValue == 0)
+	{
+		WaitList.Signal();
+	}
+}
+
+void JobCounter::Add(uint32 Count)
+{
+	if (Value.fetch_add(Count, std::memory_order_acq_rel) == 0)
+	{
+		WaitList.Reset();
+	}
+}
+
+void JobCounter::Decrement()
+{
+	const uint32 previousValue = Value.fetch_sub(1, std::memory_order_acq_rel);
+	LE_ASSERT_DESC(previousValue > 0, "Job counter was decremented below zero")
+	if (previousValue == 1)
+	{
+		WaitList.Signal();
+	}
+}
+}
\ No newline at end of file
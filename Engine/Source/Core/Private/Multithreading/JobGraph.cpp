@@ -0,0 +1,73 @@
+#include "Multithreading/JobGraph.h"
+
+#include <new>
+
+#include "Multithreading/JobNode.h"
+
+namespace LE
+{
+void JobGraph::Compile(std::span<JobNode* const> InJobs)
+{
+	Reset();
+
+	const uint32 jobCount = static_cast<uint32>(InJobs.size());
+	uint32 dependentCount = 0;
+	for (uint32 jobIndex = 0; jobIndex < jobCount; ++jobIndex)
+	{
+		InJobs[jobIndex]->Graph = this;
+		InJobs[jobIndex]->GraphJobIndex = jobIndex;
+		dependentCount += static_cast<uint32>(InJobs[jobIndex]->GetDependentJobs().size());
+	}
+
+	// Pointers go first, so every array is naturally aligned. Counters start on their own cache line
+	const size_t jobsSize = sizeof(JobNode*) * jobCount;
+	const size_t countersOffset = (jobsSize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+	const size_t dependencyCountsOffset = countersOffset + sizeof(std::atomic<uint32>) * jobCount;
+	const size_t offsetsOffset = dependencyCountsOffset + sizeof(uint32) * jobCount;
+	const size_t dependentsOffset = offsetsOffset + sizeof(uint32) * (jobCount + 1);
+	const size_t totalSize = dependentsOffset + sizeof(uint32) * dependentCount;
+
+	uint8* memory = static_cast<uint8*>(::operator new(totalSize, std::align_val_t(CACHE_LINE_SIZE)));
+	Memory = memory;
+	JobCount = jobCount;
+	Jobs = reinterpret_cast<JobNode**>(memory);
+	RemainingDependencies = reinterpret_cast<std::atomic<uint32>*>(memory + countersOffset);
+	DependencyCounts = reinterpret_cast<uint32*>(memory + dependencyCountsOffset);
+	DependentOffsets = reinterpret_cast<uint32*>(memory + offsetsOffset);
+	Dependents = reinterpret_cast<uint32*>(memory + dependentsOffset);
+
+	uint32 dependentOffset = 0;
+	for (uint32 jobIndex = 0; jobIndex < jobCount; ++jobIndex)
+	{
+		JobNode* job = InJobs[jobIndex];
+		Jobs[jobIndex] = job;
+		DependencyCounts[jobIndex] = job->GetDefaultRemainingJobCount();
+		new(&RemainingDependencies[jobIndex]) std::atomic<uint32>(DependencyCounts[jobIndex]);
+
+		DependentOffsets[jobIndex] = dependentOffset;
+		for (const JobNode* dependentJob : job->GetDependentJobs())
+		{
+			LE_ASSERT_DESC(dependentJob->Graph == this && dependentJob->GraphJobIndex > jobIndex, "Jobs aren't topologically sorted")
+			Dependents[dependentOffset++] = dependentJob->GraphJobIndex;
+		}
+	}
+	DependentOffsets[jobCount] = dependentOffset;
+}
+
+void JobGraph::Reset()
+{
+	// Jobs aren't touched here, they may already be gone. Jobs leaving the graph are unlinked by the owner
+	if (Memory)
+	{
+		::operator delete(Memory, std::align_val_t(CACHE_LINE_SIZE));
+	}
+
+	Memory = nullptr;
+	JobCount = 0;
+	Jobs = nullptr;
+	RemainingDependencies = nullptr;
+	DependencyCounts = nullptr;
+	DependentOffsets = nullptr;
+	Dependents = nullptr;
+}
+}
\ No newline at end of file
@@ -4,42 +4,154 @@
 
 #include "Time/Clock.h"
 
+namespace
+{
+	thread_local LE::JobNode* GCurrentJob = nullptr;
+	// Set while ExecuteQueued runs on a worker or the main thread, holds the dependent that thread runs next
+	thread_local LE::JobNode** GContinuationSlot = nullptr;
+}
+
 namespace LE
 {
-void JobNode::Execute()
+JobNode* JobNode::GetCurrentJob()
 {
-	Function(Clock::GetElapsedSeconds());
-	OnCompleted();
+	return GCurrentJob;
 }
 
-void JobNode::IncrementDependencyCounter()
+void JobNode::Execute()
 {
-	JobsTillReady.fetch_add(1, std::memory_order_release);
+	PendingChildren.store(1, std::memory_order_relaxed);
+	JobNode* previousJob = GCurrentJob;
+	GCurrentJob = this;
+
+	StartTimeNs = Clock::NowNs();
+	ExecutingThreadIndex = Thread::IsMainThread() ? static_cast<int16>(0) : Thread::GetWorkerThreadIndex();
+	Function(Clock::GetElapsedSeconds());
+	ExecutionTimeNs = Clock::NowNs() - StartTimeNs;
+
+	// Weight of the new sample is 1 / 2^JOB_EXECUTION_TIME_SMOOTHING_SHIFT
+	const uint64 average = AverageExecutionTimeNs.load(std::memory_order_relaxed);
+	const uint64 newAverage = average == 0
+		                          ? ExecutionTimeNs
+		                          : average - (average >> JOB_EXECUTION_TIME_SMOOTHING_SHIFT) + (ExecutionTimeNs >> JOB_EXECUTION_TIME_SMOOTHING_SHIFT);
+	AverageExecutionTimeNs.store(Max<uint64>(newAverage, 1), std::memory_order_relaxed);
+
+	GCurrentJob = previousJob;
+	OnChildCompleted();
 }
 
-void JobNode::DecrementDependencyCounter()
+void JobNode::ExecuteQueued(JobNode* Job)
 {
-	uint32 newValue = JobsTillReady.fetch_sub(1, std::memory_order_acq_rel) - 1;
-	LE_ASSERT(newValue < 3000)
-	if (newValue == 0)
+	// Render thread keeps to its own work, update graph continuations would only delay it
+	JobNode* continuation = nullptr;
+	JobNode** previousSlot = GContinuationSlot;
+	GContinuationSlot = Thread::IsRenderThread() ? nullptr : &continuation;
+
+	// Continuations run in a loop instead of recursively, so long chains don't grow the stack
+	while (Job)
 	{
-		if (Owner)
+		const bool isQueueOwned = !Job->Graph;
+		Job->Execute();
+		if (isQueueOwned)
 		{
-			Owner->OnJobBecameAvailable(this);
+			Job->Release();
 		}
+
+		Job = continuation;
+		continuation = nullptr;
 	}
+
+	GContinuationSlot = previousSlot;
+}
+
+void JobNode::AddChildJob(RefCountingPtr<JobNode> ChildJob)
+{
+	JobNode* childJob = ChildJob.GetPointer();
+	AddChildJobs({&childJob, 1});
+}
+
+void JobNode::AddChildJobs(std::span<JobNode* const> ChildJobs)
+{
+	LE_ASSERT_DESC(Owner, "Job {} doesn't belong to a scheduler", JobName)
+	for (JobNode* childJob : ChildJobs)
+	{
+		LE_ASSERT_DESC(PendingChildren.load(std::memory_order_relaxed) > 0, "Child job {} was added to {} which is not running", childJob->GetName(), JobName)
+		LE_ASSERT_DESC(!childJob->Parent, "Job {} already has a parent", childJob->GetName())
+		childJob->Parent = this;
+		childJob->Priority = Priority;
+	}
+
+	PendingChildren.fetch_add(static_cast<uint32>(ChildJobs.size()), std::memory_order_relaxed);
+	Owner->PushJobs(ChildJobs);
+}
+
+void JobNode::OnChildCompleted()
+{
+	if (PendingChildren.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		OnCompleted();
+	}
+}
+
+uint64 JobNode::GetCost() const
+{
+	const uint64 average = GetAverageExecutionTimeNs();
+	return average != 0 ? average : static_cast<uint64>(StaticWeight) * JOB_STATIC_WEIGHT_UNIT_NS;
 }
 
 void JobNode::OnCompleted()
 {
-	for (auto& dependentJob : DependentJobs)
+	LE_ASSERT_DESC(Graph || DependentJobs.empty(), "Job {} has dependent jobs but was never compiled into a job graph", JobName)
+	if (Graph)
 	{
-		dependentJob->DecrementDependencyCounter();
+		// Taken before the dependents start, everything they change is newer
+		LastRunChangeTick = AdvanceEcsChangeTick();
+
+		// Dependents that became ready together are submitted as one batch, so every worker is woken up at most once
+		JobNode* readyJobs[JOB_SUBMIT_BATCH_SIZE];
+		uint32 readyJobCount = 0;
+		for (const uint32 dependentIndex : Graph->GetDependents(GraphJobIndex))
+		{
+			if (!Graph->OnDependencyCompleted(dependentIndex))
+			{
+				continue;
+			}
+
+			// First dependent that became ready runs next on this thread, while the data this job touched is still in cache
+			JobNode* readyJob = Graph->GetJob(dependentIndex);
+			if (GContinuationSlot && !*GContinuationSlot)
+			{
+				Owner->OnJobContinued(readyJob);
+				*GContinuationSlot = readyJob;
+				continue;
+			}
+
+			readyJobs[readyJobCount++] = readyJob;
+			if (readyJobCount == JOB_SUBMIT_BATCH_SIZE)
+			{
+				Owner->OnJobsBecameAvailable({readyJobs, readyJobCount});
+				readyJobCount = 0;
+			}
+		}
+
+		if (readyJobCount > 0)
+		{
+			Owner->OnJobsBecameAvailable({readyJobs, readyJobCount});
+		}
+		Graph->ResetDependencies(GraphJobIndex);
 	}
-	JobsTillReady.store(DefaultDependencies, std::memory_order_release);
+	CompletionWaitList.Signal();
+
+	// Parent is still active till this returns, so the frame can't finish in between
+	if (Parent)
+	{
+		RefCountingPtr<JobNode> parent = std::move(Parent);
+		parent->OnChildCompleted();
+	}
+
 	if (Owner)
 	{
 		Owner->OnJobFinished();
 	}
 }
-}
+}
\ No newline at end of file
@@ -1,12 +1,142 @@
 #include "Multithreading/JobScheduler.h"
 
+#include <algorithm>
+#include <bit>
+
 #include "Multithreading/UpdatePasses.h"
 #include "Multithreading/Utils/JobVisualizer.h"
+#include "Time/Clock.h"
 
 namespace LE
 {
 static JobScheduler* gJobScheduler = nullptr;
 
+namespace
+{
+bool IsGraphIndexSet(const std::vector<uint64>& Bits, uint32 GraphIndex)
+{
+	const size_t word = GraphIndex / 64;
+	return word < Bits.size() && (Bits[word] & (1ull << (GraphIndex % 64))) != 0;
+}
+
+void SetGraphIndex(std::vector<uint64>& Bits, uint32 GraphIndex)
+{
+	const size_t word = GraphIndex / 64;
+	if (word >= Bits.size())
+	{
+		Bits.resize(word + 1, 0);
+	}
+	Bits[word] |= 1ull << (GraphIndex % 64);
+}
+
+void MergeGraphIndices(std::vector<uint64>& Bits, const std::vector<uint64>& OtherBits)
+{
+	if (OtherBits.size() > Bits.size())
+	{
+		Bits.resize(OtherBits.size(), 0);
+	}
+
+	for (size_t word = 0; word < OtherBits.size(); ++word)
+	{
+		Bits[word] |= OtherBits[word];
+	}
+}
+
+class ParallelForContext : public RefCountableBase
+{
+public:
+	ParallelForContext(uint64 InCount, uint64 InChunkSize, FunctionRef<void(uint64, uint64)> InFunction)
+		: Function(std::move(InFunction))
+		  , Count(InCount)
+		  , ChunkSize(InChunkSize)
+		  , ChunkCount((InCount + InChunkSize - 1) / InChunkSize)
+		  , NextChunk(0)
+	{
+	}
+
+	void RunChunks()
+	{
+		for (uint64 chunk = NextChunk.fetch_add(1, std::memory_order_relaxed); chunk < ChunkCount;
+		     chunk = NextChunk.fetch_add(1, std::memory_order_relaxed))
+		{
+			const uint64 begin = chunk * ChunkSize;
+			Function(begin, Min(begin + ChunkSize, Count));
+		}
+	}
+
+	uint64 GetChunkCount() const
+	{
+		return ChunkCount;
+	}
+
+private:
+	FunctionRef<void(uint64, uint64)> Function;
+	uint64 Count;
+	uint64 ChunkSize;
+	uint64 ChunkCount;
+	std::atomic<uint64> NextChunk;
+};
+
+// Child job that keeps grabbing chunks until none are left, the context keeps Function alive till the last of them is done
+class ParallelForJob : public JobNode
+{
+public:
+	ParallelForJob(JobScheduler* InOwner, ParallelForContext* InContext)
+		: JobNode(InOwner, "ParallelFor Chunk", {}, UpdateJobType(), UpdatePassType())
+		  , Context(InContext)
+	{
+		Function.Attach<&ParallelForJob::Run>(this);
+	}
+
+	void Run(const float)
+	{
+		Context->RunChunks();
+	}
+
+private:
+	RefCountingPtr<ParallelForContext> Context;
+};
+
+class ChildJob : public JobNode
+{
+public:
+	ChildJob(JobScheduler* InOwner, std::string_view InName, FunctionRef<void(const float)> InFunction)
+		: JobNode(InOwner, InName, {}, UpdateJobType(), UpdatePassType())
+		  , ChildFunction(std::move(InFunction))
+	{
+		Function.Attach<&ChildJob::Run>(this);
+	}
+
+	void Run(const float DeltaTime)
+	{
+		ChildFunction(DeltaTime);
+	}
+
+private:
+	FunctionRef<void(const float)> ChildFunction;
+};
+
+// Runs a coroutine till its next suspension point or till it is finished
+class CoroutineJob : public JobNode
+{
+public:
+	CoroutineJob(JobScheduler* InOwner, std::string_view InName, std::coroutine_handle<> InHandle)
+		: JobNode(InOwner, InName, {}, UpdateJobType(), UpdatePassType())
+		  , Handle(InHandle)
+	{
+		Function.Attach<&CoroutineJob::Run>(this);
+	}
+
+	void Run(const float)
+	{
+		Handle.resume();
+	}
+
+private:
+	std::coroutine_handle<> Handle;
+};
+}
+
 
 JobScheduler* JobScheduler::Get()
 {
@@ -18,23 +148,46 @@ JobScheduler* JobScheduler::Get()
 	return gJobScheduler;
 }
 
-void JobScheduler::Init(int8 WorkerThreadsNum)
+uint16 JobScheduler::GetDefaultWorkerThreadCount(ThreadAffinityPolicy AffinityPolicy)
 {
-	if (WorkerThreadsNum <= 0)
+	const CpuTopology& topology = CpuTopology::Get();
+	const uint32 cpuCount = AffinityPolicy == ThreadAffinityPolicy::PhysicalCores ? topology.GetPhysicalCoreCount() : topology.GetLogicalCpuCount();
+	const uint32 workerCount = cpuCount > 3 ? cpuCount - 2 : 1;
+	return static_cast<uint16>(Min<uint32>(workerCount, Constants<int16>::CMax));
+}
+
+void JobScheduler::Init(uint16 WorkerThreadsNum, ThreadAffinityPolicy AffinityPolicy)
+{
+	if (WorkerThreadsNum == 0)
 	{
 		return;
 	}
-	ThreadCount = WorkerThreadsNum;
+	ThreadCount = Min<uint16>(WorkerThreadsNum, Constants<int16>::CMax);
+	AffinityOrder = CpuTopology::Get().GetAffinityOrder(AffinityPolicy);
 
 	ConstructUpdateGraph();
 	LE_INFO("-------------------------Spawning worker threads-------------------------");
-	ThreadPool.reserve(WorkerThreadsNum);
-	for (uint8 i = 0; i < static_cast<uint8>(WorkerThreadsNum); ++i)
+	ThreadPool.reserve(ThreadCount);
+	for (uint16 i = 0; i < ThreadCount; ++i)
 	{
 		const std::string threadName = std::format("Worker Thread {}", i);
-		ThreadPool.emplace_back(i + 1, threadName, ThreadType::Worker, this);
-		LE_INFO("Thread {} was created", threadName);
-		ThreadPool[i].Start();
+		ThreadPool.emplace_back(static_cast<int16>(i + 1), threadName, ThreadType::Worker, this);
+		if (i + 2u < AffinityOrder.size())
+		{
+			ThreadPool.back().SetAffinity(static_cast<int32>(AffinityOrder[i + 2]));
+			LE_INFO("Thread {} was created, pinned to CPU {}", threadName, AffinityOrder[i + 2]);
+		}
+		else
+		{
+			LE_INFO("Thread {} was created", threadName);
+		}
+	}
+	SetupStealOrders();
+
+	// Workers start stealing right away, so the whole pool has to exist before the first one runs
+	for (Thread& workerThread : ThreadPool)
+	{
+		workerThread.Start();
 	}
 	LE_INFO("-------------------------Finished Spawning worker threads-------------------------");
 }
@@ -44,12 +197,64 @@ void JobScheduler::StartRenderThread()
 	LE_INFO("-------------------------Spawning render thread-------------------------");
 	const std::string renderThreadName = "Render Thread";
 	RenderThread = new Thread(-1, renderThreadName, ThreadType::Render, this);
+	if (AffinityOrder.size() > 1)
+	{
+		RenderThread->SetAffinity(static_cast<int32>(AffinityOrder[1]));
+	}
 	RenderThread->Start();
 	LE_INFO("-------------------------Finished Spawning render thread-------------------------");
 }
 
+void JobScheduler::SetupStealOrders()
+{
+	const CpuTopology& topology = CpuTopology::Get();
+	auto getThreadCpu = [&](uint16 ThreadIdx) -> const LogicalCpuInfo*
+	{
+		const int32 affinity = ThreadIdx > 0 ? ThreadPool[ThreadIdx - 1].GetAffinity() : -1;
+		return affinity >= 0 ? topology.FindLogicalCpu(static_cast<uint32>(affinity)) : nullptr;
+	};
+
+	StealOrders.assign(ThreadCount + 1, {});
+	for (uint16 requestingIdx = 0; requestingIdx <= ThreadCount; ++requestingIdx)
+	{
+		const LogicalCpuInfo* requestingCpu = getThreadCpu(requestingIdx);
+		auto getDistance = [&](uint16 VictimIdx) -> uint32
+		{
+			const LogicalCpuInfo* victimCpu = getThreadCpu(VictimIdx + 1);
+			if (!requestingCpu || !victimCpu)
+			{
+				return 0;
+			}
+
+			if (requestingCpu->NumaNode != victimCpu->NumaNode)
+			{
+				return 2;
+			}
+			return requestingCpu->CacheDomainId == victimCpu->CacheDomainId ? 0 : 1;
+		};
+
+		// Within the same distance victims are rotated, so threads don't all go for the same sibling first
+		std::vector<uint16>& stealOrder = StealOrders[requestingIdx];
+		for (uint16 i = 0; i < ThreadCount; ++i)
+		{
+			const uint16 victimIdx = static_cast<uint16>((requestingIdx + i) % ThreadCount);
+			if (victimIdx + 1 != requestingIdx)
+			{
+				stealOrder.push_back(victimIdx);
+			}
+		}
+
+		std::stable_sort(stealOrder.begin(), stealOrder.end(), [&](uint16 Left, uint16 Right)
+		{
+			return getDistance(Left) < getDistance(Right);
+		});
+	}
+}
+
 void JobScheduler::Shutdown()
 {
+	// Running background jobs are asked to return early, workers can't be joined before they do
+	CancelBackgroundJobs();
 	for (Thread& thread : ThreadPool)
 	{
 		thread.Stop();
@@ -60,44 +265,332 @@ void JobScheduler::Shutdown()
 
 void JobScheduler::ConstructUpdateGraph()
 {
-	AvailableJobs.clear();
-	Jobs.clear();
+	LE_INFO("-------------------------Starting Update graph construction-------------------------");
+	RebuildUpdateGraph(true);
+	UpdateCriticalPath();
+	DumpUpdateGraph(GetEngineRoot().parent_path() / "Debug" / "UpdatePass.dot", false);
+	LE_INFO("-------------------------Finished Update graph construction-------------------------");
+}
 
-	std::vector<const UpdatePass*>& updatePasses = UpdatePass::GetUpdatePasses();
+void JobScheduler::RebuildChangedUpdatePasses()
+{
+	const std::vector<const UpdatePass*>& updatePasses = UpdatePass::GetUpdatePasses();
+	bool hasChanges = updatePasses.size() != PassGraphs.size();
+	for (size_t i = 0; i < PassGraphs.size() && !hasChanges; ++i)
+	{
+		const UpdatePassGraph& passGraph = PassGraphs[i];
+		hasChanges = std::find(updatePasses.begin(), updatePasses.end(), passGraph.Pass) == updatePasses.end()
+			|| passGraph.Pass->GetVersion() != passGraph.Version;
+	}
+
+	if (hasChanges)
+	{
+		RebuildUpdateGraph(false);
+	}
+}
+
+void JobScheduler::RebuildUpdateGraph(bool RebuildAllPasses)
+{
+	const uint64 rebuildStart = Clock::NowNs();
 
-	LE_INFO("-------------------------Starting Update graph construction-------------------------");
 	GraphBuildContext context;
-	for (const auto& pass : updatePasses)
+	std::vector<const UpdatePass*> passOrder;
+	for (const UpdatePass* pass : UpdatePass::GetUpdatePasses())
+	{
+		SortUpdatePass(pass, context, passOrder);
+	}
+
+	std::unordered_map<UpdatePassType, size_t> previousPassIndices;
+	for (size_t i = 0; i < PassGraphs.size(); ++i)
+	{
+		previousPassIndices[PassGraphs[i].Type] = i;
+	}
+
+	// Passes that kept their relative order can keep their edges, everything from the first reordered pass on is rebuilt
+	size_t firstReorderedPass = passOrder.size();
+	size_t previousOrderPosition = 0;
+	for (size_t i = 0; i < passOrder.size(); ++i)
+	{
+		auto it = previousPassIndices.find(passOrder[i]->GetType());
+		if (it == previousPassIndices.end())
+		{
+			continue;
+		}
+
+		if (it->second < previousOrderPosition)
+		{
+			firstReorderedPass = i;
+			break;
+		}
+		previousOrderPosition = it->second;
+	}
+
+	std::unordered_set<EcsComponentType> affectedComponents;
+	std::unordered_set<SharedResourceType> affectedResources;
+	auto markAffected = [&affectedComponents, &affectedResources](const UpdatePassGraph& PassGraph)
 	{
-		ConstructUpdateGraphForPass(pass, context);
+		affectedComponents.insert(PassGraph.Components.begin(), PassGraph.Components.end());
+		affectedResources.insert(PassGraph.Resources.begin(), PassGraph.Resources.end());
+	};
+
+	std::vector<UpdatePassGraph> passGraphs(passOrder.size());
+	std::vector<bool> isPassChanged(passOrder.size(), RebuildAllPasses);
+	std::vector<size_t> passPreviousIndices(passOrder.size(), 0);
+	for (size_t i = 0; i < passOrder.size(); ++i)
+	{
+		const UpdatePass* pass = passOrder[i];
+		auto it = previousPassIndices.find(pass->GetType());
+		if (it != previousPassIndices.end())
+		{
+			passGraphs[i] = std::move(PassGraphs[it->second]);
+			passPreviousIndices[i] = it->second;
+			previousPassIndices.erase(it);
+		}
+
+		UpdatePassGraph& passGraph = passGraphs[i];
+		isPassChanged[i] = isPassChanged[i] || i >= firstReorderedPass || passGraph.Pass != pass || passGraph.Version != pass->GetVersion();
+		passGraph.Pass = pass;
+		passGraph.Type = pass->GetType();
 	}
+
+	// Jobs of removed passes leave the graph, whatever depended on them has to be recomputed.
+	// Their graph indices are released only at the end, as affected jobs still refer to them until they are detached
+	std::vector<size_t> removedPassIndices;
+	std::vector<RefCountingPtr<JobNode>> removedJobs;
+	for (const auto& [passType, passIndex] : previousPassIndices)
+	{
+		removedPassIndices.push_back(passIndex);
+		for (auto& [updateJob, job] : PassGraphs[passIndex].Jobs)
+		{
+			DetachUpdateGraphJob(*job);
+			removedJobs.push_back(job);
+		}
+	}
+	std::sort(removedPassIndices.begin(), removedPassIndices.end());
+
+	// Edges only connect jobs that share a component or resource, so a pass that doesn't touch anything an affected pass
+	// touched before or after the change keeps all of its dependencies
+	uint32 rebuiltPassCount = 0;
+	size_t nextRemovedPass = 0;
+	for (size_t i = 0; i < passGraphs.size(); ++i)
+	{
+		UpdatePassGraph& passGraph = passGraphs[i];
+		bool isAffected = isPassChanged[i];
+		for (; nextRemovedPass < removedPassIndices.size() && removedPassIndices[nextRemovedPass] < passPreviousIndices[i]; ++nextRemovedPass)
+		{
+			markAffected(PassGraphs[removedPassIndices[nextRemovedPass]]);
+		}
+		for (auto it = passGraph.Components.begin(); !isAffected && it != passGraph.Components.end(); ++it)
+		{
+			isAffected = affectedComponents.contains(*it);
+		}
+		for (auto it = passGraph.Resources.begin(); !isAffected && it != passGraph.Resources.end(); ++it)
+		{
+			isAffected = affectedResources.contains(*it);
+		}
+
+		if (!isAffected)
+		{
+			ReplayUpdateGraphForJobs(passGraph, context);
+			continue;
+		}
+
+		markAffected(passGraph);
+		for (auto& [updateJob, job] : passGraph.Jobs)
+		{
+			DetachUpdateGraphJob(*job);
+		}
+
+		LE_INFO("	Processing Update Pass: {}", passGraph.Pass->GetName());
+		ConstructUpdateGraphForJobs(passGraph, context, removedJobs);
+		markAffected(passGraph);
+		++rebuiltPassCount;
+		LE_INFO("	Finished processing Update Pass: {}", passGraph.Pass->GetName());
+	}
+
+	for (RefCountingPtr<JobNode>& job : removedJobs)
+	{
+		ReleaseGraphIndex(*job);
+	}
+
+	PassGraphs = std::move(passGraphs);
+	AvailableJobs.clear();
+	Jobs.clear();
+	std::vector<JobNode*> compiledJobs;
+	for (UpdatePassGraph& passGraph : PassGraphs)
+	{
+		for (auto& [updateJob, job] : passGraph.Jobs)
+		{
+			if (job->GetDefaultRemainingJobCount() == 0)
+			{
+				AvailableJobs.push_back(job.GetPointer());
+			}
+			Jobs.push_back(job);
+			compiledJobs.push_back(job.GetPointer());
+		}
+	}
+	CompiledGraph.Compile(compiledJobs);
+
 	LE_ASSERT_DESC(ValidateGraph(), "Constructed graph is invalid")
-	LE::JobVisualizer visualizer(Jobs);
-	visualizer.Dump(GetEngineRoot().parent_path() / "Debug" / "UpdatePass.dot");
-	LE_INFO("-------------------------Finished Update graph construction-------------------------");
+	LE_INFO("Update graph: rebuilt {} of {} passes, {} jobs in {} us", rebuiltPassCount, PassGraphs.size(), Jobs.size(),
+	        (Clock::NowNs() - rebuildStart) / 1000);
+}
+
+void JobScheduler::DetachUpdateGraphJob(JobNode& Job)
+{
+	// Links are removed on both ends, so the jobs detached after this one don't see it among their predecessors.
+	// Walking the accounted dependencies instead would visit every transitive predecessor of the job
+	while (!Job.PrecedingJobs.empty())
+	{
+		Job.PrecedingJobs.back()->RemoveDependentJob(Job);
+	}
+	while (!Job.DependentJobs.empty())
+	{
+		Job.RemoveDependentJob(*Job.DependentJobs.back());
+	}
+
+	if (Job.GraphIndex < AccountedDependencies.size())
+	{
+		AccountedDependencies[Job.GraphIndex].clear();
+	}
+}
+
+void JobScheduler::AcquireGraphIndex(JobNode& Job)
+{
+	if (Job.GraphIndex != Constants<uint32>::CMax)
+	{
+		return;
+	}
+
+	if (!FreeGraphIndices.empty())
+	{
+		Job.GraphIndex = FreeGraphIndices.back();
+		FreeGraphIndices.pop_back();
+		GraphJobs[Job.GraphIndex] = &Job;
+		return;
+	}
+
+	Job.GraphIndex = static_cast<uint32>(GraphJobs.size());
+	GraphJobs.push_back(&Job);
+	AccountedDependencies.emplace_back();
+}
+
+void JobScheduler::ReleaseGraphIndex(JobNode& Job)
+{
+	if (Job.GraphIndex == Constants<uint32>::CMax)
+	{
+		return;
+	}
+
+	AccountedDependencies[Job.GraphIndex].clear();
+	GraphJobs[Job.GraphIndex] = nullptr;
+	Job.Graph = nullptr;
+	FreeGraphIndices.push_back(Job.GraphIndex);
+	Job.GraphIndex = Constants<uint32>::CMax;
+}
+
+void JobScheduler::DumpUpdateGraph(const Path& SavePath, bool AnnotateWithTelemetry) const
+{
+	JobVisualizer visualizer(Jobs, AnnotateWithTelemetry ? &Telemetry : nullptr);
+	visualizer.Dump(SavePath);
+
+	Path jsonPath = SavePath;
+	visualizer.DumpJson(jsonPath.replace_extension(".json"));
 }
 
 void JobScheduler::StartFrame()
 {
+	DispatchBackgroundJobCallbacks();
+	RecordJobTelemetry();
 	++FrameCounter;
 	ActiveJobs.store(0);
 	CurrentThreadForPush.store(0);
+	LastFrameWorkerIdleStats = GetWorkerIdleStats();
 	for (auto& workerThread : ThreadPool)
 	{
+		workerThread.ResetIdleStats();
 		workerThread.IncrementFrameCounter();
 	}
 
-	for (auto& job : AvailableJobs)
+	RebuildChangedUpdatePasses();
+	UpdateCriticalPath();
+	for (auto& job : Jobs)
+	{
+		job->CompletionWaitList.Reset();
+	}
+
+	PushJobs(AvailableJobs);
+}
+
+void JobScheduler::RecordJobTelemetry()
+{
+	if (FrameCounter == 0)
+	{
+		return;
+	}
+
+	for (const RefCountingPtr<JobNode>& job : Jobs)
+	{
+		JobExecutionRecord record;
+		record.FrameIndex = FrameCounter;
+		record.ExecutionTimeNs = job->GetLastExecutionTimeNs();
+		record.QueueWaitNs = job->GetLastQueueWaitNs();
+		record.ThreadIndex = job->GetLastExecutingThreadIndex();
+		record.WasStolen = job->WasLastExecutionStolen();
+		Telemetry.Record(job->GetType(), record);
+	}
+}
+
+void JobScheduler::UpdateCriticalPath()
+{
+	// Jobs are stored in topological order, so one backward and one forward sweep give both path costs
+	CriticalPathCost = 0;
+	const uint32 jobCount = CompiledGraph.GetJobCount();
+	for (uint32 jobIndex = jobCount; jobIndex-- > 0;)
+	{
+		JobNode* job = CompiledGraph.GetJob(jobIndex);
+		uint64 longestDependentPath = 0;
+		for (const uint32 dependentIndex : CompiledGraph.GetDependents(jobIndex))
+		{
+			longestDependentPath = Max(longestDependentPath, CompiledGraph.GetJob(dependentIndex)->RemainingPathCost);
+		}
+
+		job->RemainingPathCost = job->GetCost() + longestDependentPath;
+		job->PrecedingPathCost = 0;
+		CriticalPathCost = Max(CriticalPathCost, job->RemainingPathCost);
+	}
+
+	for (uint32 jobIndex = 0; jobIndex < jobCount; ++jobIndex)
 	{
-		PushJob(job);
+		JobNode* job = CompiledGraph.GetJob(jobIndex);
+		const uint64 pathEnd = job->PrecedingPathCost + job->GetCost();
+		for (const uint32 dependentIndex : CompiledGraph.GetDependents(jobIndex))
+		{
+			JobNode* dependentJob = CompiledGraph.GetJob(dependentIndex);
+			dependentJob->PrecedingPathCost = Max(dependentJob->PrecedingPathCost, pathEnd);
+		}
+
+		const uint64 slack = CriticalPathCost - (job->PrecedingPathCost + job->RemainingPathCost);
+		if (slack * 100 <= CriticalPathCost * JOB_CRITICAL_SLACK_PERCENT)
+		{
+			job->SetPriority(JobPriority::Critical);
+		}
+		else if (slack * 100 <= CriticalPathCost * JOB_HIGH_PRIORITY_SLACK_PERCENT)
+		{
+			job->SetPriority(JobPriority::High);
+		}
+		else
+		{
+			job->SetPriority(JobPriority::Normal);
+		}
 	}
 }
 
 void JobScheduler::StartFrameRender(Delegate<void(const float)> Delegate)
 {
 	// TODO: This needs to be reworked once actual multithreading for render part is done
-	RefCountingPtr<JobNode> job = new JobNode(nullptr, "Render Kick-Off job", Delegate, UpdateJobType(), UpdatePassType());
-	RenderThread->PushJob(job);
+	RenderThread->PushJob(new JobNode(nullptr, "Render Kick-Off job", Delegate, UpdateJobType(), UpdatePassType()));
+	RenderThread->TryUnpark();
 }
 
 void JobScheduler::IncrementRenderThreadCount()
@@ -105,17 +598,29 @@ void JobScheduler::IncrementRenderThreadCount()
 	RenderThread->IncrementFrameCounter();
 }
 
-void JobScheduler::OnJobBecameAvailable(RefCountingPtr<JobNode> JobNode)
+void JobScheduler::OnJobBecameAvailable(JobNode* JobNode)
 {
 	PushJob(JobNode);
 }
 
+void JobScheduler::OnJobsBecameAvailable(std::span<JobNode* const> ReadyJobs)
+{
+	PushJobs(ReadyJobs);
+}
+
+void JobScheduler::OnJobContinued(JobNode* JobNode)
+{
+	// Counted before the completing job finishes, so the frame can't end in between
+	ActiveJobs.fetch_add(1, std::memory_order_acq_rel);
+	JobNode->OnPushed(Clock::NowNs());
+	JobNode->OnPickedUp(false);
+}
+
 void JobScheduler::OnJobFinished()
 {
 	if (ActiveJobs.fetch_sub(1, std::memory_order_acq_rel) == 1)
 	{
-		std::lock_guard lock(FrameFinishedMutex);
-		FrameFinishedCV.notify_all();
+		ActiveJobs.notify_all();
 	}
 }
 
@@ -126,54 +631,351 @@ bool JobScheduler::AreAllFinished() const
 
 void JobScheduler::WaitForAll()
 {
-	std::unique_lock lock(FrameFinishedMutex);
-	FrameFinishedCV.wait(lock, [this] { return ActiveJobs.load(std::memory_order_acquire) == 0; });
+	for (uint32 activeJobs = ActiveJobs.load(std::memory_order_acquire); activeJobs != 0;
+	     activeJobs = ActiveJobs.load(std::memory_order_acquire))
+	{
+		ActiveJobs.wait(activeJobs, std::memory_order_acquire);
+	}
 }
 
 void JobScheduler::HelpWorkerThreads()
 {
-	uint8 threadIdxToSteal = 0;
-
-	RefCountingPtr<JobNode> currentJob = nullptr;
-	while (TryStealJobFromThread(threadIdxToSteal, currentJob))
+	JobNode* currentJob = nullptr;
+	while (TryStealJobFromThread(0, currentJob))
 	{
-		currentJob->Execute();
-		threadIdxToSteal = (threadIdxToSteal + 1) % ThreadCount;
+		JobNode::ExecuteQueued(currentJob);
 	}
 }
 
-bool JobScheduler::TryStealJobFromThread(uint8 RequestingThreadIdx, RefCountingPtr<JobNode>& OutJob, ThreadType StealingType)
+bool JobScheduler::TryStealJobFromThread(uint16 RequestingThreadIdx, JobNode*& OutJob, ThreadType StealingType)
 {
-	uint8 threadIdxToSteal = (RequestingThreadIdx + 1) % ThreadCount;
-	while (threadIdxToSteal != RequestingThreadIdx)
+	// Higher priority jobs are looked for on all threads before lower priority ones, closer victims first
+	const std::vector<uint16>& stealOrder = StealOrders[RequestingThreadIdx];
+	for (size_t priority = 0; priority < JOB_PRIORITY_COUNT; ++priority)
 	{
-		if (ThreadPool[threadIdxToSteal].TryStealJob(OutJob))
+		for (const uint16 threadIdxToSteal : stealOrder)
 		{
-			return true;
+			if (ThreadPool[threadIdxToSteal].TryStealJob(OutJob, static_cast<JobPriority>(priority)))
+			{
+				return true;
+			}
 		}
-		threadIdxToSteal = (threadIdxToSteal + 1) % ThreadCount;
 	}
 
 	return false;
 }
 
-void JobScheduler::PushJob(RefCountingPtr<JobNode> JobNode)
+uint64 JobScheduler::GetParallelForChunkSize(uint64 Count) const
 {
-	ActiveJobs.fetch_add(1, std::memory_order_acq_rel);
+	// A few chunks per thread, so faster threads can pick up the slack of slower ones
+	const uint64 targetChunkCount = static_cast<uint64>(ThreadCount + 1) * PARALLEL_FOR_CHUNKS_PER_THREAD;
+	const uint64 chunkSize = std::bit_ceil(Max<uint64>(Count / targetChunkCount, 1));
+	return Min<uint64>(Max<uint64>(chunkSize, PARALLEL_FOR_MIN_CHUNK_SIZE), PARALLEL_FOR_MAX_CHUNK_SIZE);
+}
+
+void JobScheduler::ParallelForImpl(uint64 Count, uint64 ChunkSize, FunctionRef<void(uint64, uint64)> Function)
+{
+	if (Count == 0)
+	{
+		return;
+	}
+
+	ChunkSize = ChunkSize != 0 ? ChunkSize : GetParallelForChunkSize(Count);
+	if (Count <= ChunkSize || ThreadPool.empty())
+	{
+		Function(0, Count);
+		return;
+	}
+
+	RefCountingPtr<ParallelForContext> context = new ParallelForContext(Count, ChunkSize, std::move(Function));
+	JobNode* parentJob = JobNode::GetCurrentJob();
+	// Without a running job the calling thread takes the place of one of the chunk jobs
+	const uint64 childJobCount = Min<uint64>(context->GetChunkCount(), parentJob ? ThreadCount + 1u : ThreadCount);
+	std::vector<RefCountingPtr<JobNode>> childJobs;
+	std::vector<JobNode*> childJobPointers;
+	childJobs.reserve(childJobCount);
+	childJobPointers.reserve(childJobCount);
+	for (uint64 i = 0; i < childJobCount; ++i)
+	{
+		childJobPointers.push_back(childJobs.emplace_back(new ParallelForJob(this, context)).GetPointer());
+	}
+
+	if (parentJob)
+	{
+		parentJob->AddChildJobs(childJobPointers);
+		return;
+	}
+
+	// Calling thread is blocked till the chunks are done, so finishing them goes before starting anything new
+	for (JobNode* childJob : childJobPointers)
+	{
+		childJob->Priority = JobPriority::Critical;
+	}
+	PushJobs(childJobPointers);
+	context->RunChunks();
+
+	// Chunks may have forked children of the jobs they ran in, so the jobs are waited for, not only the chunks.
+	// Ones that were dealt to a worker calling this are run right away, nobody else might pick them up
+	RunPendingFrameJobs();
+	for (const RefCountingPtr<JobNode>& childJob : childJobs)
+	{
+		childJob->GetCompletionWaitList().Wait();
+	}
+}
+
+void JobScheduler::SpawnChildJob(std::string_view Name, FunctionRef<void(const float)> Function)
+{
+	JobNode* parentJob = JobNode::GetCurrentJob();
+	LE_ASSERT_DESC(parentJob, "Child job {} has to be spawned from a running job", Name)
+	parentJob->AddChildJob(new ChildJob(this, Name, std::move(Function)));
+}
+
+void JobScheduler::SpawnCoroutineJob(std::string_view Name, JobTask Task)
+{
+	RefCountingPtr<JobNode> coroutineJob = new CoroutineJob(this, Name, Task.Release());
+	if (JobNode* parentJob = JobNode::GetCurrentJob())
+	{
+		parentJob->AddChildJob(coroutineJob);
+		return;
+	}
+
+	PushJob(coroutineJob.GetPointer());
+}
+
+void JobScheduler::ResumeCoroutine(JobNode& SuspendedJob, std::coroutine_handle<> Handle)
+{
+	RefCountingPtr<JobNode> coroutineJob = new CoroutineJob(this, SuspendedJob.GetName(), Handle);
+	coroutineJob->Parent = &SuspendedJob;
+	coroutineJob->Priority = SuspendedJob.Priority;
+	SuspendedJob.Release();
+	PushJob(coroutineJob.GetPointer());
+}
+
+void JobScheduler::PushJob(JobNode* JobNode)
+{
+	PushJobs({&JobNode, 1});
+}
+
+void JobScheduler::PushJobs(std::span<JobNode* const> JobsToPush)
+{
+	if (JobsToPush.empty())
+	{
+		return;
+	}
+
+	const uint32 jobCount = static_cast<uint32>(JobsToPush.size());
+	ActiveJobs.fetch_add(jobCount, std::memory_order_acq_rel);
+	const uint64 now = Clock::NowNs();
+	for (JobNode* job : JobsToPush)
+	{
+		job->OnPushed(now);
+	}
+
+	const uint32 wakeCount = Min<uint32>(jobCount, ThreadCount);
+
+	// Workers keep what they produce in their own lock-free queue, idle siblings will steal it
+	const int16 workerIdx = Thread::GetWorkerThreadIndex();
+	if (!Thread::IsRenderThread() && workerIdx > 0 && workerIdx <= ThreadCount)
+	{
+		ThreadPool[workerIdx - 1].PushJobs(JobsToPush);
+		WakeWorkers(wakeCount, static_cast<uint32>(workerIdx));
+		return;
+	}
+
+	// Every thread gets one contiguous slice, starting after the thread the previous push ended on
+	const uint32 firstThreadIdx = CurrentThreadForPush.fetch_add(wakeCount, std::memory_order_acq_rel) + 1;
+	for (uint32 slice = 0; slice < wakeCount; ++slice)
+	{
+		const size_t sliceBegin = static_cast<size_t>(jobCount) * slice / wakeCount;
+		const size_t sliceEnd = static_cast<size_t>(jobCount) * (slice + 1) / wakeCount;
+		ThreadPool[(firstThreadIdx + slice) % ThreadCount].PushJobs(JobsToPush.subspan(sliceBegin, sliceEnd - sliceBegin));
+	}
+
+	WakeWorkers(wakeCount, firstThreadIdx);
+}
+
+void JobScheduler::WakeWorkers(uint32 Count, uint32 FirstThreadIdx)
+{
+	// Pairs with the parking thread announcing itself before its last check for jobs
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (ParkedWorkers.load(std::memory_order_seq_cst) == 0)
+	{
+		return;
+	}
+
+	for (uint32 i = 0; i < ThreadCount && Count > 0; ++i)
+	{
+		if (ThreadPool[(FirstThreadIdx + i) % ThreadCount].TryUnpark())
+		{
+			--Count;
+		}
+	}
+}
+
+BackgroundJobHandle JobScheduler::SubmitBackgroundJob(std::string_view Name, BackgroundJob::WorkFunction Function,
+                                                     BackgroundJob::CompletionCallback OnFinished)
+{
+	LE_ASSERT_DESC(!ThreadPool.empty(), "Background job {} was submitted without worker threads to run it", Name)
+
+	RefCountingPtr<BackgroundJob> job = new BackgroundJob(this, std::string(Name), std::move(Function), std::move(OnFinished));
+	{
+		std::lock_guard lock(BackgroundJobsMutex);
+		QueuedBackgroundJobs.push_back(job);
+		QueuedBackgroundJobCount.store(static_cast<uint32>(QueuedBackgroundJobs.size()), std::memory_order_seq_cst);
+	}
+
+	WakeWorkers(1, CurrentThreadForPush.load(std::memory_order_relaxed) + 1);
+	return BackgroundJobHandle(std::move(job));
+}
+
+bool JobScheduler::TryRunBackgroundJob()
+{
+	if (!HasBackgroundJobsToRun())
+	{
+		return false;
+	}
+
+	RefCountingPtr<BackgroundJob> job;
+	{
+		std::lock_guard lock(BackgroundJobsMutex);
+		if (QueuedBackgroundJobs.empty() || RunningBackgroundJobs.size() >= GetMaxBackgroundWorkers())
+		{
+			return false;
+		}
+
+		job = std::move(QueuedBackgroundJobs.front());
+		QueuedBackgroundJobs.pop_front();
+		QueuedBackgroundJobCount.store(static_cast<uint32>(QueuedBackgroundJobs.size()), std::memory_order_seq_cst);
+		RunningBackgroundJobs.push_back(job);
+		RunningBackgroundJobCount.store(static_cast<uint32>(RunningBackgroundJobs.size()), std::memory_order_seq_cst);
+	}
+
+	job->Run();
+
+	{
+		std::lock_guard lock(BackgroundJobsMutex);
+		RunningBackgroundJobs.erase(std::find(RunningBackgroundJobs.begin(), RunningBackgroundJobs.end(), job));
+		RunningBackgroundJobCount.store(static_cast<uint32>(RunningBackgroundJobs.size()), std::memory_order_seq_cst);
+		FinishedBackgroundJobs.push_back(std::move(job));
+	}
+
+	return true;
+}
+
+bool JobScheduler::HasBackgroundJobsToRun() const
+{
+	return QueuedBackgroundJobCount.load(std::memory_order_seq_cst) > 0
+		&& RunningBackgroundJobCount.load(std::memory_order_seq_cst) < GetMaxBackgroundWorkers();
+}
+
+void JobScheduler::RunPendingFrameJobs()
+{
+	const int16 workerIdx = Thread::GetWorkerThreadIndex();
+	if (!Thread::IsRenderThread() && workerIdx > 0 && workerIdx <= ThreadCount)
+	{
+		ThreadPool[workerIdx - 1].RunPendingJobs();
+	}
+}
+
+void JobScheduler::DispatchBackgroundJobCallbacks()
+{
+	std::vector<RefCountingPtr<BackgroundJob>> finishedJobs;
+	{
+		std::lock_guard lock(BackgroundJobsMutex);
+		finishedJobs.swap(FinishedBackgroundJobs);
+	}
 
-	uint32 idx = CurrentThreadForPush.fetch_add(1, std::memory_order_acq_rel) + 1;
-	for (uint32 i = 0; i != ThreadCount; ++i)
+	// Callbacks are free to submit new background jobs, so they are called without holding the lock
+	for (const RefCountingPtr<BackgroundJob>& job : finishedJobs)
 	{
-		if (ThreadPool[(i + idx) % ThreadCount].TryPushJob(JobNode))
+		if (job->OnFinished)
 		{
-			return;
+			job->OnFinished(job->GetState());
 		}
 	}
+}
+
+void JobScheduler::CancelBackgroundJobs()
+{
+	std::lock_guard lock(BackgroundJobsMutex);
+	for (RefCountingPtr<BackgroundJob>& job : QueuedBackgroundJobs)
+	{
+		job->IsCancelRequested.store(true, std::memory_order_release);
+		FinishCancelledBackgroundJob(std::move(job));
+	}
+	QueuedBackgroundJobs.clear();
+	QueuedBackgroundJobCount.store(0, std::memory_order_seq_cst);
 
-	ThreadPool[idx % ThreadCount].PushJob(JobNode);
+	for (const RefCountingPtr<BackgroundJob>& job : RunningBackgroundJobs)
+	{
+		job->IsCancelRequested.store(true, std::memory_order_release);
+	}
 }
 
-void JobScheduler::ConstructUpdateGraphForPass(const UpdatePass* Pass, GraphBuildContext& Context)
+void JobScheduler::CancelQueuedBackgroundJob(BackgroundJob* Job)
+{
+	// Job that a worker already took is running, it returns early on its own
+	std::lock_guard lock(BackgroundJobsMutex);
+	const auto queuedJob = std::find_if(QueuedBackgroundJobs.begin(), QueuedBackgroundJobs.end(), [Job](const RefCountingPtr<BackgroundJob>& QueuedJob)
+	{
+		return QueuedJob == Job;
+	});
+	if (queuedJob != QueuedBackgroundJobs.end())
+	{
+		FinishCancelledBackgroundJob(std::move(*queuedJob));
+		QueuedBackgroundJobs.erase(queuedJob);
+		QueuedBackgroundJobCount.store(static_cast<uint32>(QueuedBackgroundJobs.size()), std::memory_order_seq_cst);
+	}
+}
+
+void JobScheduler::FinishCancelledBackgroundJob(RefCountingPtr<BackgroundJob> Job)
+{
+	// Doesn't call the work function of a cancelled job, only stores the state and wakes the waiters
+	Job->Run();
+	FinishedBackgroundJobs.push_back(std::move(Job));
+}
+
+uint32 JobScheduler::GetMaxBackgroundWorkers() const
+{
+	return Max<uint32>(static_cast<uint32>(ThreadCount) * BACKGROUND_JOB_MAX_WORKERS_PERCENT / 100, 1);
+}
+
+bool JobScheduler::HasStealableJobs() const
+{
+	for (const Thread& thread : ThreadPool)
+	{
+		if (thread.HasPendingJobs())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobScheduler::OnWorkerParked()
+{
+	ParkedWorkers.fetch_add(1, std::memory_order_seq_cst);
+}
+
+void JobScheduler::OnWorkerUnparked()
+{
+	ParkedWorkers.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+std::vector<ThreadIdleStats> JobScheduler::GetWorkerIdleStats() const
+{
+	std::vector<ThreadIdleStats> stats;
+	stats.reserve(ThreadPool.size());
+	for (const Thread& thread : ThreadPool)
+	{
+		stats.push_back(thread.GetIdleStats());
+	}
+
+	return stats;
+}
+
+void JobScheduler::SortUpdatePass(const UpdatePass* Pass, GraphBuildContext& Context, std::vector<const UpdatePass*>& OutPassOrder)
 {
 	UpdatePassType passType = Pass->GetType();
 	if (Context.ProcessedUpdatePasses.contains(passType) && Context.ProcessedUpdatePasses[passType])
@@ -188,6 +990,11 @@ void JobScheduler::ConstructUpdateGraphForPass(const UpdatePass* Pass, GraphBuil
 		dependsOn.emplace(requiredPass);
 
 		const UpdatePass* requiredPtr = UpdatePass::GetUpdatePass(requiredPass);
+		if (!requiredPtr)
+		{
+			LE_WARN("Update Pass {} depends on a pass that isn't registered, the dependency is skipped", Pass->GetName());
+			continue;
+		}
 
 #ifdef DEBUG
 		if (Context.UpdatePassDependencies[requiredPass].contains(passType))
@@ -197,17 +1004,29 @@ void JobScheduler::ConstructUpdateGraphForPass(const UpdatePass* Pass, GraphBuil
 		}
 #endif
 
-		ConstructUpdateGraphForPass(requiredPtr, Context);
+		SortUpdatePass(requiredPtr, Context, OutPassOrder);
 	}
 
-	LE_INFO("	Processing Update Pass: {}", Pass->GetName());
-	ConstructUpdateGraphForJobs(Pass, Context);
+	OutPassOrder.push_back(Pass);
 	Context.ProcessedUpdatePasses[passType] = true;
-	LE_INFO("	Finished processing Update Pass: {}", Pass->GetName());
 }
 
-void JobScheduler::ConstructUpdateGraphForJobs(const UpdatePass* Pass, GraphBuildContext& Context)
+void JobScheduler::ConstructUpdateGraphForJobs(UpdatePassGraph& PassGraph, GraphBuildContext& Context,
+                                               std::vector<RefCountingPtr<JobNode>>& OutRemovedJobs)
 {
+	const UpdatePass* pass = PassGraph.Pass;
+
+	// Jobs that stay in the pass keep their nodes, together with the measured execution times
+	std::unordered_map<const UpdateJob*, RefCountingPtr<JobNode>> previousJobs;
+	for (auto& [updateJob, job] : PassGraph.Jobs)
+	{
+		previousJobs.emplace(updateJob, std::move(job));
+	}
+	PassGraph.Jobs.clear();
+	PassGraph.Components.clear();
+	PassGraph.Resources.clear();
+	PassGraph.Version = pass->GetVersion();
+
 	std::vector<const UpdateJob*> deleteJobs;
 	std::vector<const UpdateJob*> addJobs;
 	std::vector<const UpdateJob*> WriteJobs;
@@ -218,7 +1037,7 @@ void JobScheduler::ConstructUpdateGraphForJobs(const UpdatePass* Pass, GraphBuil
 	};
 
 	// Populate jobs per components
-	for (const auto& jobPair : Pass->GetUpdateJobs())
+	for (const auto& jobPair : pass->GetUpdateJobs())
 	{
 		const UpdateJob* job = jobPair.second;
 
@@ -249,24 +1068,31 @@ void JobScheduler::ConstructUpdateGraphForJobs(const UpdatePass* Pass, GraphBuil
 		LE_WARN("Detected job: {} which doesn't do anything, it will be skipped", job->GetName());
 	}
 
-	// This is to remove the number of dependency links, if it was accounted by predecessors
-	auto addDependency = [&Context](RefCountingPtr<JobNode>& prevJob, RefCountingPtr<JobNode>& dependentJob)
+	// This is to remove the number of dependency links, if it was accounted by predecessors.
+	// Links to the job are only created while it is being scheduled, so its direct predecessors are tracked just for that time
+	std::vector<JobNode*> directPredecessors;
+	auto addDependency = [this, &directPredecessors](RefCountingPtr<JobNode>& prevJob, RefCountingPtr<JobNode>& dependentJob)
 	{
-		if (!Context.AccountedDependencies[dependentJob].contains(prevJob))
+		std::vector<uint64>& dependentAccounted = AccountedDependencies[dependentJob->GraphIndex];
+		const std::vector<uint64>& prevAccounted = AccountedDependencies[prevJob->GraphIndex];
+		if (!IsGraphIndexSet(dependentAccounted, prevJob->GraphIndex))
 		{
-			Context.AccountedDependencies[dependentJob].insert(Context.AccountedDependencies[prevJob].begin(),
-			                                                   Context.AccountedDependencies[prevJob].end());
-			Context.AccountedDependencies[dependentJob].emplace(prevJob);
+			MergeGraphIndices(dependentAccounted, prevAccounted);
+			SetGraphIndex(dependentAccounted, prevJob->GraphIndex);
 			prevJob->AddDependentJob(*dependentJob);
+			directPredecessors.push_back(prevJob.GetPointer());
 		}
 
-		for (auto& accountedJob : Context.AccountedDependencies[prevJob])
+		std::erase_if(directPredecessors, [&prevAccounted, &dependentJob](JobNode* predecessor)
 		{
-			if (Context.AccountedDependencies[dependentJob].contains(accountedJob))
+			if (!IsGraphIndexSet(prevAccounted, predecessor->GraphIndex))
 			{
-				accountedJob->RemoveDependentJob(*dependentJob);
+				return false;
 			}
-		}
+
+			predecessor->RemoveDependentJob(*dependentJob);
+			return true;
+		});
 	};
 
 	auto setupComponentDependencyFunc = [&Context, &addDependency](RefCountingPtr<JobNode>& job,
@@ -277,14 +1103,14 @@ void JobScheduler::ConstructUpdateGraphForJobs(const UpdatePass* Pass, GraphBuil
 			if (!isReading)
 			{
 				auto itReading = Context.LastReadingJobsPerComponent.find(component);
-				if (itReading != Context.LastReadingJobsPerComponent.find(component))
+				if (itReading != Context.LastReadingJobsPerComponent.end())
 				{
 					for (RefCountingPtr<JobNode> readingJob : itReading->second)
 					{
 						addDependency(readingJob, job);
 					}
 
-					return;
+					continue;
 				}
 			}
 
@@ -304,14 +1130,14 @@ void JobScheduler::ConstructUpdateGraphForJobs(const UpdatePass* Pass, GraphBuil
 			if (!isReading)
 			{
 				auto itReading = Context.LastReadingJobsPerResource.find(component);
-				if (itReading != Context.LastReadingJobsPerResource.find(component))
+				if (itReading != Context.LastReadingJobsPerResource.end())
 				{
 					for (RefCountingPtr<JobNode> readingJob : itReading->second)
 					{
 						addDependency(readingJob, job);
 					}
 
-					return;
+					continue;
 				}
 			}
 
@@ -323,47 +1149,26 @@ void JobScheduler::ConstructUpdateGraphForJobs(const UpdatePass* Pass, GraphBuil
 		}
 	};
 
-	auto updateComponentLastJobsFunc = [&Context](RefCountingPtr<JobNode>& job,
-	                                              const std::unordered_set<EcsComponentType>& components, bool isReading)
+	auto scheduleDependencyFunc = [&setupResourceDependencyFunc, &setupComponentDependencyFunc, &previousJobs, &directPredecessors,
+			&PassGraph, &Context, pass, this](const std::vector<const UpdateJob*>& jobs)
 	{
-		for (EcsComponentType component : components)
-		{
-			if (!isReading)
-			{
-				Context.LastModifyingJobPerComponent[component] = job;
-				Context.LastReadingJobsPerComponent.erase(component);
-			}
-			else
-			{
-				Context.LastReadingJobsPerComponent[component].emplace(job);
-			}
-		}
-	};
-
-	auto updateResourceLastJobsFunc = [&Context](RefCountingPtr<JobNode>& job,
-	                                             const std::unordered_set<SharedResourceType>& resources, bool isReading)
-	{
-		for (SharedResourceType component : resources)
+		for (const UpdateJob* job : jobs)
 		{
-			if (!isReading)
+			auto it = previousJobs.find(job);
+			RefCountingPtr<JobNode> jobNode = nullptr;
+			if (it != previousJobs.end())
 			{
-				Context.LastModifyingJobPerResource[component] = job;
-				Context.LastReadingJobsPerResource.erase(component);
+				jobNode = std::move(it->second);
+				previousJobs.erase(it);
 			}
 			else
 			{
-				Context.LastReadingJobsPerResource[component].emplace(job);
+				jobNode = new JobNode(this, job->GetName(), job->UpdateFunction, job->GetType(), pass->GetType());
+				AcquireGraphIndex(*jobNode);
 			}
-		}
-	};
-
-	auto scheduleDependencyFunc = [&setupResourceDependencyFunc, &setupComponentDependencyFunc, &updateComponentLastJobsFunc,
-			&updateResourceLastJobsFunc, &Pass, this](const std::vector<const UpdateJob*>& jobs)
-	{
-		for (const UpdateJob* job : jobs)
-		{
-			RefCountingPtr<JobNode> jobNode = new JobNode(this, job->GetName(), job->UpdateFunction, job->GetType(), Pass->GetType());
-			Jobs.push_back(jobNode);
+			jobNode->SetStaticWeight(job->GetStaticWeight());
+			PassGraph.Jobs.emplace_back(job, jobNode);
+			directPredecessors.clear();
 
 			// Setup dependencies
 			setupComponentDependencyFunc(jobNode, job->GetDeleteComponents(), false);
@@ -376,19 +1181,12 @@ void JobScheduler::ConstructUpdateGraphForJobs(const UpdatePass* Pass, GraphBuil
 			setupResourceDependencyFunc(jobNode, job->GetWriteResources(), false);
 			setupResourceDependencyFunc(jobNode, job->GetReadResources(), true);
 
-			updateComponentLastJobsFunc(jobNode, job->GetDeleteComponents(), false);
-			updateComponentLastJobsFunc(jobNode, job->GetAddComponents(), false);
-			updateComponentLastJobsFunc(jobNode, job->GetWriteComponents(), false);
-			updateComponentLastJobsFunc(jobNode, job->GetReadComponents(), true);
+			Context.UpdateLastJobs(jobNode, *job);
 
-			updateResourceLastJobsFunc(jobNode, job->GetDeleteResources(), false);
-			updateResourceLastJobsFunc(jobNode, job->GetAddResources(), false);
-			updateResourceLastJobsFunc(jobNode, job->GetWriteResources(), false);
-			updateResourceLastJobsFunc(jobNode, job->GetReadResources(), true);
-
-			if (jobNode->IsReady())
+			for (size_t operation = 0; operation < static_cast<size_t>(UpdateJob::Operation::Count); ++operation)
 			{
-				AvailableJobs.emplace_back(jobNode);
+				PassGraph.Components.insert(job->ComponentOperations[operation].begin(), job->ComponentOperations[operation].end());
+				PassGraph.Resources.insert(job->ResourceOperations[operation].begin(), job->ResourceOperations[operation].end());
 			}
 
 			LE_INFO("		Job {} is scheduled", job->GetName());
@@ -403,17 +1201,79 @@ void JobScheduler::ConstructUpdateGraphForJobs(const UpdatePass* Pass, GraphBuil
 	scheduleDependencyFunc(addJobs);
 	scheduleDependencyFunc(WriteJobs);
 	scheduleDependencyFunc(ReadJobs);
+
+	// Jobs that were removed from the pass
+	for (auto& [updateJob, job] : previousJobs)
+	{
+		OutRemovedJobs.push_back(std::move(job));
+	}
+}
+
+void JobScheduler::ReplayUpdateGraphForJobs(UpdatePassGraph& PassGraph, GraphBuildContext& Context)
+{
+	// Dependencies of the pass are still valid, later passes only need to see it as the last user of what it touches
+	for (auto& [updateJob, job] : PassGraph.Jobs)
+	{
+		Context.UpdateLastJobs(job, *updateJob);
+	}
+}
+
+void JobScheduler::GraphBuildContext::UpdateLastJobs(RefCountingPtr<JobNode>& Job, const UpdateJob& UpdateJob)
+{
+	auto updateComponentLastJobsFunc = [this](RefCountingPtr<JobNode>& job,
+	                                          const std::unordered_set<EcsComponentType>& components, bool isReading)
+	{
+		for (EcsComponentType component : components)
+		{
+			if (!isReading)
+			{
+				LastModifyingJobPerComponent[component] = job;
+				LastReadingJobsPerComponent.erase(component);
+			}
+			else
+			{
+				LastReadingJobsPerComponent[component].emplace(job);
+			}
+		}
+	};
+
+	auto updateResourceLastJobsFunc = [this](RefCountingPtr<JobNode>& job,
+	                                         const std::unordered_set<SharedResourceType>& resources, bool isReading)
+	{
+		for (SharedResourceType component : resources)
+		{
+			if (!isReading)
+			{
+				LastModifyingJobPerResource[component] = job;
+				LastReadingJobsPerResource.erase(component);
+			}
+			else
+			{
+				LastReadingJobsPerResource[component].emplace(job);
+			}
+		}
+	};
+
+	updateComponentLastJobsFunc(Job, UpdateJob.GetDeleteComponents(), false);
+	updateComponentLastJobsFunc(Job, UpdateJob.GetAddComponents(), false);
+	updateComponentLastJobsFunc(Job, UpdateJob.GetWriteComponents(), false);
+	updateComponentLastJobsFunc(Job, UpdateJob.GetReadComponents(), true);
+
+	updateResourceLastJobsFunc(Job, UpdateJob.GetDeleteResources(), false);
+	updateResourceLastJobsFunc(Job, UpdateJob.GetAddResources(), false);
+	updateResourceLastJobsFunc(Job, UpdateJob.GetWriteResources(), false);
+	updateResourceLastJobsFunc(Job, UpdateJob.GetReadResources(), true);
 }
 
 bool JobScheduler::ValidateGraph()
 {
 	std::unordered_map<UpdateJobType, uint32> counter;
-	std::vector<RefCountingPtr<JobNode>> currentJobs = AvailableJobs;
+	std::vector<JobNode*> currentJobs = AvailableJobs;
 
 	uint32 executed = 0;
 	while (!currentJobs.empty())
 	{
-		RefCountingPtr<JobNode> job = currentJobs.back();
+		JobNode* job = currentJobs.back();
 		currentJobs.pop_back();
 		++executed;
 
@@ -434,4 +1294,4 @@ bool JobScheduler::ValidateGraph()
 
 	return executed == Jobs.size();
 }
-}
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "Multithreading/JobTelemetry.h"
+
+#include <algorithm>
+
+namespace LE
+{
+namespace
+{
+	uint64 GetPercentile(std::vector<uint64>& Samples, uint32 Percentile)
+	{
+		if (Samples.empty())
+		{
+			return 0;
+		}
+
+		const size_t index = (Samples.size() - 1) * Percentile / 100;
+		std::nth_element(Samples.begin(), Samples.begin() + index, Samples.end());
+		return Samples[index];
+	}
+}
+
+void JobTelemetry::SetHistorySize(uint32 InHistorySize)
+{
+	LE_ASSERT_DESC(InHistorySize > 0, "Telemetry history can't be empty")
+	HistorySize = InHistorySize;
+	Clear();
+}
+
+void JobTelemetry::Record(UpdateJobType JobType, const JobExecutionRecord& Record)
+{
+	JobHistory& history = Histories[JobType];
+	if (history.Records.size() < HistorySize)
+	{
+		history.Records.reserve(HistorySize);
+		history.LastRecord = static_cast<uint32>(history.Records.size());
+		history.Records.push_back(Record);
+		return;
+	}
+
+	history.LastRecord = (history.LastRecord + 1) % HistorySize;
+	history.Records[history.LastRecord] = Record;
+}
+
+void JobTelemetry::Clear()
+{
+	Histories.clear();
+}
+
+const std::vector<JobExecutionRecord>* JobTelemetry::GetRecords(UpdateJobType JobType) const
+{
+	auto it = Histories.find(JobType);
+	return it != Histories.end() ? &it->second.Records : nullptr;
+}
+
+const JobExecutionRecord* JobTelemetry::GetLastRecord(UpdateJobType JobType) const
+{
+	auto it = Histories.find(JobType);
+	return it != Histories.end() ? &it->second.Records[it->second.LastRecord] : nullptr;
+}
+
+JobTimingSummary JobTelemetry::GetSummary(UpdateJobType JobType) const
+{
+	JobTimingSummary summary;
+	const std::vector<JobExecutionRecord>* records = GetRecords(JobType);
+	if (!records)
+	{
+		return summary;
+	}
+
+	std::vector<uint64> executionTimes;
+	std::vector<uint64> queueWaits;
+	executionTimes.reserve(records->size());
+	queueWaits.reserve(records->size());
+	uint32 stolenCount = 0;
+	for (const JobExecutionRecord& record : *records)
+	{
+		executionTimes.push_back(record.ExecutionTimeNs);
+		queueWaits.push_back(record.QueueWaitNs);
+		stolenCount += record.WasStolen ? 1 : 0;
+	}
+
+	summary.SampleCount = static_cast<uint32>(records->size());
+	summary.StolenRatio = static_cast<float>(stolenCount) / static_cast<float>(summary.SampleCount);
+	summary.P50ExecutionTimeNs = GetPercentile(executionTimes, 50);
+	summary.P99ExecutionTimeNs = GetPercentile(executionTimes, 99);
+	summary.P50QueueWaitNs = GetPercentile(queueWaits, 50);
+	summary.P99QueueWaitNs = GetPercentile(queueWaits, 99);
+	return summary;
+}
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "Multithreading/JobWaitList.h"
+
+#include "Multithreading/JobScheduler.h"
+
+namespace LE
+{
+bool JobWaitList::AddWaiter(Waiter& InWaiter)
+{
+	Waiter* head = Head.load(std::memory_order_acquire);
+	do
+	{
+		if (head == GetSignaledMarker())
+		{
+			return false;
+		}
+
+		InWaiter.Next = head;
+	}
+	while (!Head.compare_exchange_weak(head, &InWaiter, std::memory_order_acq_rel, std::memory_order_acquire));
+
+	return true;
+}
+
+void JobWaitList::Signal()
+{
+	Waiter* waiter = Head.exchange(GetSignaledMarker(), std::memory_order_acq_rel);
+	if (waiter == GetSignaledMarker())
+	{
+		return;
+	}
+
+	Head.notify_all();
+	while (waiter)
+	{
+		// Waiter lives in the coroutine frame, which can be gone as soon as the coroutine is resumed
+		Waiter* next = waiter->Next;
+		JobScheduler::Get()->ResumeCoroutine(*waiter->SuspendedJob, waiter->Handle);
+		waiter = next;
+	}
+}
+
+void JobWaitList::Reset()
+{
+	Waiter* expected = GetSignaledMarker();
+	Head.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+}
+
+void JobWaitList::Wait() const
+{
+	for (Waiter* head = Head.load(std::memory_order_acquire); head != GetSignaledMarker(); head = Head.load(std::memory_order_acquire))
+	{
+		Head.wait(head, std::memory_order_acquire);
+	}
+}
+}
\ No newline at end of file
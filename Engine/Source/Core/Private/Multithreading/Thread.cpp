@@ -1,17 +1,32 @@
 #include "Multithreading/Thread.h"
 
 #include "Multithreading/JobScheduler.h"
+#include "Time/Clock.h"
 #include "common/TracySystem.hpp"
 
 #if PLATFORM_WINDOWS
 #include <Windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
 #endif
 
 namespace
 {
 	thread_local bool GIsRenderThread = false;
 	thread_local bool GIsMainThread = true;
-	thread_local LE::int8 GWorkerThreadIndex = -1;
+	thread_local LE::int16 GWorkerThreadIndex = -1;
+
+	void CpuRelax()
+	{
+#if defined(_M_X64) || defined(__x86_64__)
+		_mm_pause();
+#endif
+	}
 }
 
 namespace LE
@@ -26,7 +41,7 @@ bool Thread::IsRenderThread()
 	return GIsRenderThread;
 }
 
-int8 Thread::GetWorkerThreadIndex()
+int16 Thread::GetWorkerThreadIndex()
 {
 	return GWorkerThreadIndex;
 }
@@ -40,7 +55,9 @@ void Thread::Start()
 void Thread::Stop()
 {
 	IsRunning.store(false, std::memory_order_relaxed);
-	IsReady.release();
+	IsParked.store(false, std::memory_order_seq_cst);
+	WakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+	WakeEpoch.notify_all();
 }
 
 void Thread::Main()
@@ -50,58 +67,147 @@ void Thread::Main()
 	GIsRenderThread = Type == ThreadType::Render;
 
 	SetThreadDescription();
+	ApplyAffinity();
 
 	while (IsRunning.load(std::memory_order_relaxed))
 	{
-		IsReady.acquire();
+		RunPendingJobs();
+
+		// Frame jobs are checked again after every background job, background work only fills the gaps
+		if (Type == ThreadType::Worker && Owner->TryRunBackgroundJob())
+		{
+			continue;
+		}
+
+		WaitForJobs();
+	}
+}
+
+void Thread::RunPendingJobs()
+{
+	JobNode* currentJob = nullptr;
+	while (NextJob(currentJob))
+	{
+		JobNode::ExecuteQueued(currentJob);
+	}
+}
+
+bool Thread::IsCurrentThread() const
+{
+	return ThreadImpl.get_id() == std::this_thread::get_id();
+}
+
+void Thread::PushJob(JobNode* JobToAdd)
+{
+	PushJobs({&JobToAdd, 1});
+}
+
+void Thread::PushJobs(std::span<JobNode* const> JobsToAdd)
+{
+	for (JobNode* job : JobsToAdd)
+	{
+		job->AddQueueReference();
+	}
 
-		RefCountingPtr<JobNode> currentJob = nullptr;
-		while (NextJob(currentJob))
+	if (IsCurrentThread())
+	{
+		for (JobNode* job : JobsToAdd)
 		{
-			currentJob->Execute();
+			LocalQueues[static_cast<size_t>(job->GetPriority())]->Push(job);
 		}
+		return;
+	}
+
+	{
+		std::lock_guard lock(IncomingJobsMutex);
+		IncomingJobs.insert(IncomingJobs.end(), JobsToAdd.begin(), JobsToAdd.end());
+		HasIncomingJobs.store(true, std::memory_order_release);
 	}
 }
 
-bool Thread::TryPushJob(RefCountingPtr<JobNode> JobToAdd)
+bool Thread::TryStealJob(JobNode*& JobOut, JobPriority Priority)
 {
-	std::unique_lock lock(LocalQueueMutex, std::try_to_lock);
-	if (!lock)
+	WorkStealingQueue<JobNode*>& localQueue = *LocalQueues[static_cast<size_t>(Priority)];
+	while (!localQueue.IsEmpty())
+	{
+		if (localQueue.Steal(JobOut))
+		{
+			JobOut->OnPickedUp(true);
+			return true;
+		}
+	}
+
+	// Owner might be busy with a long job, so jobs that were not picked up yet are also up for grabs
+	if (Priority != JobPriority::Normal || !HasIncomingJobs.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+
+	std::unique_lock lock(IncomingJobsMutex, std::try_to_lock);
+	if (!lock || IncomingJobs.empty())
 	{
 		return false;
 	}
 
-	LocalQueue.push_front(JobToAdd);
-	IsReady.release();
+	JobOut = IncomingJobs.back();
+	IncomingJobs.pop_back();
+	HasIncomingJobs.store(!IncomingJobs.empty(), std::memory_order_release);
+	JobOut->OnPickedUp(true);
 	return true;
 }
 
-void Thread::PushJob(RefCountingPtr<JobNode> JobToAdd)
+bool Thread::HasPendingJobs() const
 {
-	std::unique_lock lock(LocalQueueMutex);
-	LocalQueue.push_front(JobToAdd);
-	IsReady.release();
+	for (const UniquePtr<WorkStealingQueue<JobNode*>>& localQueue : LocalQueues)
+	{
+		if (localQueue && !localQueue->IsEmpty())
+		{
+			return true;
+		}
+	}
+
+	return HasIncomingJobs.load(std::memory_order_acquire);
 }
 
-bool Thread::TryStealJob(RefCountingPtr<JobNode>& JobOut)
+bool Thread::TryUnpark()
 {
-	std::unique_lock lock(LocalQueueMutex, std::try_to_lock);
-	if (!lock)
+	if (!IsParked.load(std::memory_order_relaxed))
 	{
 		return false;
 	}
 
-	if (LocalQueue.empty())
+	WakeRequestTimeNs.store(Clock::NowNs(), std::memory_order_relaxed);
+	bool expected = true;
+	if (!IsParked.compare_exchange_strong(expected, false, std::memory_order_seq_cst))
 	{
 		return false;
 	}
 
-	JobOut = LocalQueue.front();
-	LocalQueue.pop_front();
-
+	WakeEpoch.fetch_add(1, std::memory_order_seq_cst);
+	WakeEpoch.notify_one();
 	return true;
 }
 
+ThreadIdleStats Thread::GetIdleStats() const
+{
+	ThreadIdleStats stats;
+	stats.IdleTimeNs = IdleTimeNs.load(std::memory_order_relaxed);
+	stats.ParkCount = ParkCount.load(std::memory_order_relaxed);
+	stats.WakeCount = WakeCount.load(std::memory_order_relaxed);
+	stats.TotalWakeLatencyNs = TotalWakeLatencyNs.load(std::memory_order_relaxed);
+	stats.MaxWakeLatencyNs = MaxWakeLatencyNs.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void Thread::ResetIdleStats()
+{
+	IdleTimeNs.store(0, std::memory_order_relaxed);
+	ParkCount.store(0, std::memory_order_relaxed);
+	WakeCount.store(0, std::memory_order_relaxed);
+	TotalWakeLatencyNs.store(0, std::memory_order_relaxed);
+	MaxWakeLatencyNs.store(0, std::memory_order_relaxed);
+}
+
 void Thread::IncrementFrameCounter()
 {
 	CurrentFrame.fetch_add(1, std::memory_order_relaxed);
@@ -112,14 +218,15 @@ uint64 Thread::GetCurrentFrame() const
 	return CurrentFrame.load(std::memory_order_acquire);
 }
 
-bool Thread::NextJob(RefCountingPtr<JobNode>& JobOut)
+bool Thread::NextJob(JobNode*& JobOut)
 {
+	MoveIncomingJobsToLocalQueue();
+
+	for (UniquePtr<WorkStealingQueue<JobNode*>>& localQueue : LocalQueues)
 	{
-		std::unique_lock lock(LocalQueueMutex);
-		if (lock && !LocalQueue.empty())
+		if (localQueue->Pop(JobOut))
 		{
-			JobOut = LocalQueue.back();
-			LocalQueue.pop_back();
+			JobOut->OnPickedUp(false);
 			return true;
 		}
 	}
@@ -132,6 +239,124 @@ bool Thread::NextJob(RefCountingPtr<JobNode>& JobOut)
 	return Owner->TryStealJobFromThread(Index, JobOut);
 }
 
+bool Thread::HasJobsToRun() const
+{
+	if (HasPendingJobs())
+	{
+		return true;
+	}
+
+	return Type == ThreadType::Worker && (Owner->HasStealableJobs() || Owner->HasBackgroundJobsToRun());
+}
+
+void Thread::WaitForJobs()
+{
+	const uint64 idleStart = Clock::NowNs();
+	if (!SpinForJobs())
+	{
+		Park();
+	}
+	IdleTimeNs.fetch_add(Clock::NowNs() - idleStart, std::memory_order_relaxed);
+}
+
+bool Thread::SpinForJobs()
+{
+	for (uint32 spin = 0; spin < SpinLimit; ++spin)
+	{
+		if (HasJobsToRun())
+		{
+			SpinLimit = Min<uint32>(SpinLimit * 2, THREAD_SPIN_COUNT_MAX);
+			return true;
+		}
+		CpuRelax();
+	}
+
+	for (uint32 yield = 0; yield < THREAD_YIELD_COUNT; ++yield)
+	{
+		if (HasJobsToRun())
+		{
+			return true;
+		}
+		std::this_thread::yield();
+	}
+
+	SpinLimit = Max<uint32>(SpinLimit / 2, THREAD_SPIN_COUNT_MIN);
+	return false;
+}
+
+void Thread::Park()
+{
+	// Announce parking before the last check for jobs, so a concurrent push either sees us parked or we see its job
+	IsParked.store(true, std::memory_order_seq_cst);
+	if (Type == ThreadType::Worker)
+	{
+		Owner->OnWorkerParked();
+	}
+
+	const uint32 epoch = WakeEpoch.load(std::memory_order_seq_cst);
+	if (!HasJobsToRun() && IsRunning.load(std::memory_order_relaxed))
+	{
+		ParkCount.fetch_add(1, std::memory_order_relaxed);
+		WakeEpoch.wait(epoch, std::memory_order_seq_cst);
+	}
+
+	const bool wasWokenUp = !IsParked.exchange(false, std::memory_order_seq_cst);
+	if (Type == ThreadType::Worker)
+	{
+		Owner->OnWorkerUnparked();
+	}
+
+	if (wasWokenUp)
+	{
+		const uint64 now = Clock::NowNs();
+		const uint64 requestTime = WakeRequestTimeNs.load(std::memory_order_relaxed);
+		const uint64 latency = now > requestTime ? now - requestTime : 0;
+		WakeCount.fetch_add(1, std::memory_order_relaxed);
+		TotalWakeLatencyNs.fetch_add(latency, std::memory_order_relaxed);
+		if (latency > MaxWakeLatencyNs.load(std::memory_order_relaxed))
+		{
+			MaxWakeLatencyNs.store(latency, std::memory_order_relaxed);
+		}
+	}
+}
+
+bool Thread::MoveIncomingJobsToLocalQueue()
+{
+	if (!HasIncomingJobs.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+
+	std::lock_guard lock(IncomingJobsMutex);
+	for (JobNode* job : IncomingJobs)
+	{
+		LocalQueues[static_cast<size_t>(job->GetPriority())]->Push(job);
+	}
+
+	const bool movedAny = !IncomingJobs.empty();
+	IncomingJobs.clear();
+	HasIncomingJobs.store(false, std::memory_order_release);
+	return movedAny;
+}
+
+void Thread::ReleaseLocalJobs()
+{
+	JobNode* job = nullptr;
+	for (UniquePtr<WorkStealingQueue<JobNode*>>& localQueue : LocalQueues)
+	{
+		while (localQueue && localQueue->Pop(job))
+		{
+			job->ReleaseQueueReference();
+		}
+	}
+
+	for (JobNode* incomingJob : IncomingJobs)
+	{
+		incomingJob->ReleaseQueueReference();
+	}
+	IncomingJobs.clear();
+}
+
 void Thread::SetThreadDescription()
 {
 	LE_INFO("Thread {} started", Name);
@@ -149,4 +374,32 @@ void Thread::SetThreadDescription()
 	}
 #endif
 }
+
+void Thread::ApplyAffinity()
+{
+	if (AffinityCpu < 0)
+	{
+		return;
+	}
+
+#if PLATFORM_WINDOWS
+	// Logical ids above 63 live in other processor groups
+	GROUP_AFFINITY affinity = {};
+	affinity.Group = static_cast<WORD>(AffinityCpu / 64);
+	affinity.Mask = static_cast<KAFFINITY>(1) << (AffinityCpu % 64);
+	const bool succeeded = SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+#elif defined(__linux__)
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(AffinityCpu, &cpuSet);
+	const bool succeeded = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+	const bool succeeded = false;
+#endif
+
+	if (!succeeded)
+	{
+		LE_WARN("Failed to pin thread {} to CPU {}", Name, AffinityCpu);
+	}
 }
+}
\ No newline at end of file
@@ -15,9 +15,22 @@ std::vector<const UpdatePass*>& UpdatePass::GetUpdatePasses()
    return *gUpdatePassRegistry;
 }
 
+UpdatePass::~UpdatePass()
+{
+	std::vector<const UpdatePass*>& updatePasses = GetUpdatePasses();
+	std::erase(updatePasses, this);
+
+	std::unordered_map<UpdatePassType, const UpdatePass*>& updatePassMap = GetUpdatePassMap();
+	auto it = updatePassMap.find(Type);
+	if (it != updatePassMap.end() && it->second == this)
+	{
+		updatePassMap.erase(it);
+	}
+}
+
 const UpdatePass* UpdatePass::GetUpdatePass(UpdatePassType UpdatePass)
 {
-	auto map = GetUpdatePassMap();
+	const auto& map = GetUpdatePassMap();
 	if (map.contains(UpdatePass))
 	{
 		return map.at(UpdatePass);
@@ -35,4 +48,4 @@ std::unordered_map<UpdatePassType, const UpdatePass*>& UpdatePass::GetUpdatePass
 
 	return *gUpdatePassMap;
 }
-}
+}
\ No newline at end of file
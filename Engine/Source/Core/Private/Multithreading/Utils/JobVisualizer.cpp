@@ -1,10 +1,34 @@
 #include "Multithreading/Utils/JobVisualizer.h"
 
+#include <algorithm>
 #include <fstream>
+#include <iomanip>
 
 namespace LE
 {
-JobVisualizer::JobVisualizer(const std::vector<RefCountingPtr<JobNode>>& Jobs)
+namespace
+{
+	void WriteMicroseconds(std::ostream& Stream, uint64 TimeNs)
+	{
+		Stream << std::fixed << std::setprecision(1) << static_cast<double>(TimeNs) / 1000.0;
+	}
+
+	void WriteTypeIds(std::ostream& Stream, const std::unordered_set<uint32>& TypeIds)
+	{
+		std::vector<uint32> sortedTypeIds(TypeIds.begin(), TypeIds.end());
+		std::sort(sortedTypeIds.begin(), sortedTypeIds.end());
+
+		Stream << "[";
+		for (size_t i = 0; i < sortedTypeIds.size(); ++i)
+		{
+			Stream << (i > 0 ? ", " : "") << sortedTypeIds[i];
+		}
+		Stream << "]";
+	}
+}
+
+JobVisualizer::JobVisualizer(const std::vector<RefCountingPtr<JobNode>>& Jobs, const JobTelemetry* Telemetry)
+	: HasTelemetry(Telemetry != nullptr)
 {
 	for (const auto& job : Jobs)
 	{
@@ -13,6 +37,14 @@ JobVisualizer::JobVisualizer(const std::vector<RefCountingPtr<JobNode>>& Jobs)
 		descriptor.JobName = job->GetName();
 		descriptor.ParentUpdatePass = GetCreateUpdatePassDescriptor(job->GetUpdatePassType());
 		descriptor.ParentUpdatePass->Jobs.push_back(&descriptor);
+		const auto& passJobs = descriptor.ParentUpdatePass->Pass->GetUpdateJobs();
+		const auto passJob = passJobs.find(type);
+		descriptor.Job = passJob != passJobs.end() ? passJob->second : nullptr;
+		OrderedJobs.push_back(&descriptor);
+		if (Telemetry)
+		{
+			descriptor.Timing = Telemetry->GetSummary(type);
+		}
 
 		for (const auto& dependentJob : job->GetDependentJobs())
 		{
@@ -24,6 +56,11 @@ JobVisualizer::JobVisualizer(const std::vector<RefCountingPtr<JobNode>>& Jobs)
 			StartingJobs.push_back(&descriptor);
 		}
 	}
+
+	if (HasTelemetry)
+	{
+		FindCriticalPath();
+	}
 }
 
 JobVisualizer::~JobVisualizer()
@@ -91,6 +128,116 @@ void JobVisualizer::Dump(Path SavePath)
 	os << "}\n";
 }
 
+void JobVisualizer::DumpJson(Path SavePath)
+{
+	std::filesystem::create_directories(SavePath.parent_path());
+	std::ofstream os(SavePath);
+	if (!os)
+	{
+		return;
+	}
+
+	os << "{\n  \"passes\": [\n";
+	for (size_t i = 0; i < OrderedUpdatePasses.size(); ++i)
+	{
+		const UpdatePass& pass = *OrderedUpdatePasses[i]->Pass;
+		os << "    {\"name\": \"" << pass.GetName() << "\", \"depends_on\": [";
+		bool isFirst = true;
+		for (const UpdatePassType dependencyType : pass.GetDependsOnPasses())
+		{
+			if (const UpdatePass* dependency = UpdatePass::GetUpdatePass(dependencyType))
+			{
+				os << (isFirst ? "" : ", ") << "\"" << dependency->GetName() << "\"";
+				isFirst = false;
+			}
+		}
+		os << "]}" << (i + 1 < OrderedUpdatePasses.size() ? "," : "") << "\n";
+	}
+	os << "  ],\n  \"jobs\": [\n";
+	for (size_t i = 0; i < OrderedJobs.size(); ++i)
+	{
+		const JobNodeDescriptor& job = *OrderedJobs[i];
+		os << "    {\"name\": \"" << job.JobName << "\", \"pass\": \"" << job.ParentUpdatePass->UpdatePassName << "\", \"dependents\": [";
+		for (size_t j = 0; j < job.DependentJobs.size(); ++j)
+		{
+			os << (j > 0 ? ", " : "") << "\"" << job.DependentJobs[j]->JobName << "\"";
+		}
+		os << "]";
+
+		if (job.Job)
+		{
+			os << ", \"static_weight\": " << job.Job->GetStaticWeight();
+			os << ", \"components\": {\"read\": ";
+			WriteTypeIds(os, job.Job->GetReadComponents());
+			os << ", \"write\": ";
+			WriteTypeIds(os, job.Job->GetWriteComponents());
+			os << ", \"add\": ";
+			WriteTypeIds(os, job.Job->GetAddComponents());
+			os << ", \"delete\": ";
+			WriteTypeIds(os, job.Job->GetDeleteComponents());
+			os << "}, \"resources\": {\"read\": ";
+			WriteTypeIds(os, job.Job->GetReadResources());
+			os << ", \"write\": ";
+			WriteTypeIds(os, job.Job->GetWriteResources());
+			os << ", \"add\": ";
+			WriteTypeIds(os, job.Job->GetAddResources());
+			os << ", \"delete\": ";
+			WriteTypeIds(os, job.Job->GetDeleteResources());
+			os << "}";
+		}
+
+		if (HasTelemetry)
+		{
+			os << ", \"samples\": " << job.Timing.SampleCount;
+			os << ", \"p50_us\": ";
+			WriteMicroseconds(os, job.Timing.P50ExecutionTimeNs);
+			os << ", \"p99_us\": ";
+			WriteMicroseconds(os, job.Timing.P99ExecutionTimeNs);
+			os << ", \"queue_wait_p50_us\": ";
+			WriteMicroseconds(os, job.Timing.P50QueueWaitNs);
+			os << ", \"queue_wait_p99_us\": ";
+			WriteMicroseconds(os, job.Timing.P99QueueWaitNs);
+			os << ", \"stolen_ratio\": " << std::setprecision(2) << job.Timing.StolenRatio;
+			os << ", \"critical_path\": " << (job.IsOnCriticalPath ? "true" : "false");
+		}
+
+		os << "}" << (i + 1 < OrderedJobs.size() ? "," : "") << "\n";
+	}
+	os << "  ]\n}\n";
+}
+
+void JobVisualizer::FindCriticalPath()
+{
+	// Same longest path search as the scheduler does, but on measured p50 durations
+	for (auto it = OrderedJobs.rbegin(); it != OrderedJobs.rend(); ++it)
+	{
+		JobNodeDescriptor* job = *it;
+		for (JobNodeDescriptor* dependentJob : job->DependentJobs)
+		{
+			if (!job->CriticalDependentJob || dependentJob->RemainingPathCost > job->CriticalDependentJob->RemainingPathCost)
+			{
+				job->CriticalDependentJob = dependentJob;
+			}
+		}
+
+		job->RemainingPathCost = job->Timing.P50ExecutionTimeNs + (job->CriticalDependentJob ? job->CriticalDependentJob->RemainingPathCost : 0);
+	}
+
+	JobNodeDescriptor* pathJob = nullptr;
+	for (JobNodeDescriptor* job : StartingJobs)
+	{
+		if (!pathJob || job->RemainingPathCost > pathJob->RemainingPathCost)
+		{
+			pathJob = job;
+		}
+	}
+
+	for (; pathJob; pathJob = pathJob->CriticalDependentJob)
+	{
+		pathJob->IsOnCriticalPath = true;
+	}
+}
+
 void JobVisualizer::WriteUpdatePass(std::ostream& Stream, const UpdatePassDescriptor& Descriptor)
 {
 	Stream << "subgraph cluster_" << Descriptor.UpdatePassName << " {\n";
@@ -102,7 +249,22 @@ void JobVisualizer::WriteUpdatePass(std::ostream& Stream, const UpdatePassDescri
 
 	for (const auto& job : Descriptor.Jobs)
 	{
-		Stream << "Job_" << job->JobName << "[label=\"" << job->JobName << "\"];\n";
+		Stream << "Job_" << job->JobName << "[label=\"" << job->JobName;
+		if (HasTelemetry)
+		{
+			Stream << "\\np50 ";
+			WriteMicroseconds(Stream, job->Timing.P50ExecutionTimeNs);
+			Stream << "us / p99 ";
+			WriteMicroseconds(Stream, job->Timing.P99ExecutionTimeNs);
+			Stream << "us";
+		}
+		Stream << "\"";
+
+		if (job->IsOnCriticalPath)
+		{
+			Stream << ", color=red, penwidth=3";
+		}
+		Stream << "];\n";
 	}
 
 	Stream << "}\n";
@@ -118,7 +280,12 @@ void JobVisualizer::WriteJob(std::ostream& Stream, const JobNodeDescriptor& Desc
 	Stream << "\n";
 	for (JobNodeDescriptor* job : Descriptor.DependentJobs)
 	{
-		Stream << "Job_" << Descriptor.JobName << " -> " << "Job_" << job->JobName << ";\n";
+		Stream << "Job_" << Descriptor.JobName << " -> " << "Job_" << job->JobName;
+		if (Descriptor.IsOnCriticalPath && Descriptor.CriticalDependentJob == job)
+		{
+			Stream << " [color=red, penwidth=3]";
+		}
+		Stream << ";\n";
 	}
 	Stream << "\n";
 }
@@ -150,10 +317,12 @@ JobVisualizer::UpdatePassDescriptor* JobVisualizer::GetCreateUpdatePassDescripto
 	{
 		descriptor = new UpdatePassDescriptor;
 		const UpdatePass* updatePass = UpdatePass::GetUpdatePass(PassType);
+		descriptor->Pass = updatePass;
 		descriptor->UpdatePassName = updatePass->GetName();
 		descriptor->Color = updatePass->GetDebugColor();
 
 		UpdatePasses[PassType] = descriptor;
+		OrderedUpdatePasses.push_back(descriptor);
 	}
 
 	return descriptor;
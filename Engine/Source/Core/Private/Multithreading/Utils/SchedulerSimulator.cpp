@@ -0,0 +1,288 @@
+#include "Multithreading/Utils/SchedulerSimulator.h"
+
+#include <array>
+#include <deque>
+#include <numeric>
+#include <queue>
+
+#include "Math/Math.h"
+#include "Multithreading/JobNode.h"
+
+namespace LE
+{
+namespace
+{
+	constexpr uint32 GNoJob = Constants<uint32>::CMax;
+
+	struct SimulatedThread
+	{
+		std::array<std::deque<uint32>, JOB_PRIORITY_COUNT> Queues; // Main thread only has queued jobs if there are no workers
+		uint64 ReadyAtNs = 0; // Push costs delay the next job of the pushing thread
+		uint32 Continuation = GNoJob;
+		bool IsRunning = false;
+	};
+
+	struct CompletionEvent
+	{
+		uint64 TimeNs;
+		uint16 ThreadIdx;
+		uint32 JobIndex;
+
+		bool operator>(const CompletionEvent& Other) const
+		{
+			return TimeNs != Other.TimeNs ? TimeNs > Other.TimeNs : ThreadIdx > Other.ThreadIdx;
+		}
+	};
+}
+
+float SchedulerSimulationResult::GetAverageUtilisation() const
+{
+	const size_t threadCount = ThreadBusyNs.size() - (MainThreadHelped ? 0 : 1);
+	if (FrameTimeNs == 0 || threadCount == 0)
+	{
+		return 0.f;
+	}
+
+	uint64 totalBusyNs = 0;
+	for (size_t threadIdx = MainThreadHelped ? 0 : 1; threadIdx < ThreadBusyNs.size(); ++threadIdx)
+	{
+		totalBusyNs += ThreadBusyNs[threadIdx];
+	}
+
+	return static_cast<float>(totalBusyNs) / static_cast<float>(FrameTimeNs * threadCount);
+}
+
+std::vector<uint64> SchedulerSimulator::GetJobCosts(const JobGraph& Graph)
+{
+	std::vector<uint64> costs(Graph.GetJobCount());
+	for (uint32 jobIndex = 0; jobIndex < Graph.GetJobCount(); ++jobIndex)
+	{
+		costs[jobIndex] = Graph.GetJob(jobIndex)->GetCost();
+	}
+
+	return costs;
+}
+
+uint64 SchedulerSimulator::GetCriticalPath(const JobGraph& Graph, std::span<const uint64> JobCostsNs, std::vector<uint32>& OutCriticalPath)
+{
+	OutCriticalPath.clear();
+	const uint32 jobCount = Graph.GetJobCount();
+	if (jobCount == 0)
+	{
+		return 0;
+	}
+
+	// Same backward sweep as the scheduler does, remembering the next job on the path
+	std::vector<uint64> remainingPathCosts(jobCount, 0);
+	std::vector<uint32> criticalDependents(jobCount, GNoJob);
+	for (uint32 jobIndex = jobCount; jobIndex-- > 0;)
+	{
+		uint64 longestDependentPath = 0;
+		for (const uint32 dependentIndex : Graph.GetDependents(jobIndex))
+		{
+			if (criticalDependents[jobIndex] == GNoJob || remainingPathCosts[dependentIndex] > longestDependentPath)
+			{
+				longestDependentPath = remainingPathCosts[dependentIndex];
+				criticalDependents[jobIndex] = dependentIndex;
+			}
+		}
+
+		remainingPathCosts[jobIndex] = JobCostsNs[jobIndex] + longestDependentPath;
+	}
+
+	uint32 pathJob = GNoJob;
+	for (uint32 jobIndex = 0; jobIndex < jobCount; ++jobIndex)
+	{
+		if (Graph.GetDependencyCount(jobIndex) == 0 && (pathJob == GNoJob || remainingPathCosts[jobIndex] > remainingPathCosts[pathJob]))
+		{
+			pathJob = jobIndex;
+		}
+	}
+
+	const uint64 pathCostNs = remainingPathCosts[pathJob];
+	for (; pathJob != GNoJob; pathJob = criticalDependents[pathJob])
+	{
+		OutCriticalPath.push_back(pathJob);
+	}
+
+	return pathCostNs;
+}
+
+SchedulerSimulationResult SchedulerSimulator::Simulate(const JobGraph& Graph, std::span<const uint64> JobCostsNs,
+                                                       const SchedulerSimulationSettings& Settings)
+{
+	LE_ASSERT_DESC(JobCostsNs.size() == Graph.GetJobCount(), "Expected {} job costs, got {}", Graph.GetJobCount(), JobCostsNs.size())
+	LE_ASSERT_DESC(Settings.WorkerThreadCount > 0 || Settings.MainThreadHelps, "Simulation needs at least one thread running jobs")
+
+	SchedulerSimulationResult result;
+	result.ThreadBusyNs.assign(Settings.WorkerThreadCount + 1u, 0);
+	result.MainThreadHelped = Settings.MainThreadHelps;
+
+	const uint32 jobCount = Graph.GetJobCount();
+	if (jobCount == 0)
+	{
+		return result;
+	}
+
+	result.TotalWorkNs = std::accumulate(JobCostsNs.begin(), JobCostsNs.end(), uint64{0});
+	result.CriticalPathCostNs = GetCriticalPath(Graph, JobCostsNs, result.CriticalPath);
+
+	const uint16 workerCount = Settings.WorkerThreadCount;
+	std::vector<SimulatedThread> threads(workerCount + 1u);
+	std::vector<uint32> remainingDependencies(jobCount);
+	std::vector<uint32> readyJobs;
+	for (uint32 jobIndex = 0; jobIndex < jobCount; ++jobIndex)
+	{
+		remainingDependencies[jobIndex] = Graph.GetDependencyCount(jobIndex);
+		if (remainingDependencies[jobIndex] == 0)
+		{
+			readyJobs.push_back(jobIndex);
+		}
+	}
+
+	auto getQueueIdx = [&](uint32 JobIndex)
+	{
+		return static_cast<size_t>(Settings.UsePriorities ? Graph.GetJob(JobIndex)->GetPriority() : JobPriority::Normal);
+	};
+
+	// Mirrors JobScheduler::PushJobs: workers keep what they make ready, the main thread deals jobs out in contiguous slices
+	uint32 nextPushThreadIdx = 0;
+	auto pushJobs = [&](uint16 PushingThreadIdx, uint64 NowNs, std::span<const uint32> JobsToPush)
+	{
+		if (JobsToPush.empty())
+		{
+			return;
+		}
+
+		SimulatedThread& pushingThread = threads[PushingThreadIdx];
+		const uint64 pushCostNs = Settings.PushCostNs * JobsToPush.size();
+		pushingThread.ReadyAtNs = Max(pushingThread.ReadyAtNs, NowNs) + pushCostNs;
+		result.ThreadBusyNs[PushingThreadIdx] += pushCostNs;
+
+		if (PushingThreadIdx > 0 || workerCount == 0)
+		{
+			for (const uint32 jobIndex : JobsToPush)
+			{
+				pushingThread.Queues[getQueueIdx(jobIndex)].push_back(jobIndex);
+			}
+			return;
+		}
+
+		const uint32 sliceCount = Min<uint32>(static_cast<uint32>(JobsToPush.size()), workerCount);
+		const uint32 firstThreadIdx = nextPushThreadIdx + 1;
+		nextPushThreadIdx += sliceCount;
+		for (uint32 slice = 0; slice < sliceCount; ++slice)
+		{
+			const size_t sliceBegin = JobsToPush.size() * slice / sliceCount;
+			const size_t sliceEnd = JobsToPush.size() * (slice + 1) / sliceCount;
+			SimulatedThread& targetThread = threads[(firstThreadIdx + slice) % workerCount + 1];
+			for (size_t i = sliceBegin; i < sliceEnd; ++i)
+			{
+				targetThread.Queues[getQueueIdx(JobsToPush[i])].push_back(JobsToPush[i]);
+			}
+		}
+	};
+
+	// Continuation first, then own queues popped from the back, then victims' queues from the front, higher priorities first
+	auto takeJob = [&](uint16 ThreadIdx, uint32& OutJobIndex, bool& OutIsStolen)
+	{
+		SimulatedThread& thread = threads[ThreadIdx];
+		OutIsStolen = false;
+		if (thread.Continuation != GNoJob)
+		{
+			OutJobIndex = thread.Continuation;
+			thread.Continuation = GNoJob;
+			return true;
+		}
+
+		for (std::deque<uint32>& queue : thread.Queues)
+		{
+			if (!queue.empty())
+			{
+				OutJobIndex = queue.back();
+				queue.pop_back();
+				return true;
+			}
+		}
+
+		OutIsStolen = true;
+		for (size_t queueIdx = 0; queueIdx < JOB_PRIORITY_COUNT; ++queueIdx)
+		{
+			for (uint16 i = 0; i < workerCount; ++i)
+			{
+				const uint16 victimIdx = static_cast<uint16>((ThreadIdx + i) % workerCount + 1);
+				std::deque<uint32>& queue = threads[victimIdx].Queues[queueIdx];
+				if (victimIdx != ThreadIdx && !queue.empty())
+				{
+					OutJobIndex = queue.front();
+					queue.pop_front();
+					return true;
+				}
+			}
+		}
+
+		return false;
+	};
+
+	std::priority_queue<CompletionEvent, std::vector<CompletionEvent>, std::greater<>> events;
+	auto startIdleThreads = [&](uint64 NowNs)
+	{
+		for (uint16 threadIdx = Settings.MainThreadHelps ? 0 : 1; threadIdx <= workerCount; ++threadIdx)
+		{
+			SimulatedThread& thread = threads[threadIdx];
+			uint32 jobIndex = GNoJob;
+			bool isStolen = false;
+			if (thread.IsRunning || !takeJob(threadIdx, jobIndex, isStolen))
+			{
+				continue;
+			}
+
+			const uint64 stealCostNs = isStolen ? Settings.StealCostNs : 0;
+			const uint64 endNs = Max(NowNs, thread.ReadyAtNs) + stealCostNs + JobCostsNs[jobIndex];
+			result.ThreadBusyNs[threadIdx] += stealCostNs + JobCostsNs[jobIndex];
+			result.StealCount += isStolen ? 1 : 0;
+			thread.IsRunning = true;
+			events.push({endNs, threadIdx, jobIndex});
+		}
+	};
+
+	pushJobs(0, 0, readyJobs);
+	startIdleThreads(0);
+
+	uint32 completedJobCount = 0;
+	while (!events.empty())
+	{
+		const CompletionEvent event = events.top();
+		events.pop();
+		++completedJobCount;
+		result.FrameTimeNs = Max(result.FrameTimeNs, event.TimeNs);
+
+		SimulatedThread& thread = threads[event.ThreadIdx];
+		thread.IsRunning = false;
+		thread.ReadyAtNs = Max(thread.ReadyAtNs, event.TimeNs);
+
+		readyJobs.clear();
+		for (const uint32 dependentIndex : Graph.GetDependents(event.JobIndex))
+		{
+			if (--remainingDependencies[dependentIndex] == 0)
+			{
+				readyJobs.push_back(dependentIndex);
+			}
+		}
+
+		std::span<const uint32> jobsToPush = readyJobs;
+		if (Settings.RunContinuations && !jobsToPush.empty())
+		{
+			thread.Continuation = jobsToPush.front();
+			jobsToPush = jobsToPush.subspan(1);
+			++result.ContinuationCount;
+		}
+		pushJobs(event.ThreadIdx, event.TimeNs, jobsToPush);
+
+		startIdleThreads(event.TimeNs);
+	}
+
+	LE_ASSERT_DESC(completedJobCount == jobCount, "Only {} of {} jobs ran in the simulation, the graph has a cycle", completedJobCount, jobCount)
+	return result;
+}
+}
\ No newline at end of file
@@ -0,0 +1,446 @@
+#include "Multithreading/Utils/UpdateGraphDescription.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <variant>
+
+#include "Math/Math.h"
+
+namespace LE
+{
+namespace
+{
+	// Just enough JSON for the dumps the scheduler writes
+	struct JsonValue
+	{
+		using Array = std::vector<JsonValue>;
+		using Object = std::map<std::string, JsonValue, std::less<>>;
+
+		std::variant<std::nullptr_t, bool, double, std::string, Array, Object> Value;
+
+		const JsonValue* Find(std::string_view Key) const
+		{
+			const Object* object = std::get_if<Object>(&Value);
+			if (!object)
+			{
+				return nullptr;
+			}
+
+			const auto it = object->find(Key);
+			return it != object->end() ? &it->second : nullptr;
+		}
+
+		double GetNumber(std::string_view Key, double Default = 0.0) const
+		{
+			const JsonValue* value = Find(Key);
+			const double* number = value ? std::get_if<double>(&value->Value) : nullptr;
+			return number ? *number : Default;
+		}
+
+		std::string GetString(std::string_view Key) const
+		{
+			const JsonValue* value = Find(Key);
+			const std::string* string = value ? std::get_if<std::string>(&value->Value) : nullptr;
+			return string ? *string : std::string();
+		}
+
+		const Array& GetArray(std::string_view Key) const
+		{
+			static const Array emptyArray;
+			const JsonValue* value = Find(Key);
+			const Array* array = value ? std::get_if<Array>(&value->Value) : nullptr;
+			return array ? *array : emptyArray;
+		}
+	};
+
+	class JsonParser
+	{
+	public:
+		explicit JsonParser(std::string_view InText)
+			: Text(InText)
+		{
+		}
+
+		bool Parse(JsonValue& OutValue)
+		{
+			return ParseValue(OutValue) && (SkipWhitespace(), Position == Text.size());
+		}
+
+	private:
+		void SkipWhitespace()
+		{
+			while (Position < Text.size() && std::isspace(static_cast<unsigned char>(Text[Position])))
+			{
+				++Position;
+			}
+		}
+
+		bool Consume(char Character)
+		{
+			SkipWhitespace();
+			if (Position < Text.size() && Text[Position] == Character)
+			{
+				++Position;
+				return true;
+			}
+
+			return false;
+		}
+
+		bool ConsumeLiteral(std::string_view Literal)
+		{
+			if (Text.substr(Position, Literal.size()) != Literal)
+			{
+				return false;
+			}
+
+			Position += Literal.size();
+			return true;
+		}
+
+		bool ParseValue(JsonValue& OutValue)
+		{
+			SkipWhitespace();
+			if (Position >= Text.size())
+			{
+				return false;
+			}
+
+			switch (Text[Position])
+			{
+			case '{':
+				return ParseObject(OutValue);
+			case '[':
+				return ParseArray(OutValue);
+			case '"':
+			{
+				std::string string;
+				if (!ParseString(string))
+				{
+					return false;
+				}
+
+				OutValue.Value = std::move(string);
+				return true;
+			}
+			case 't':
+				OutValue.Value = true;
+				return ConsumeLiteral("true");
+			case 'f':
+				OutValue.Value = false;
+				return ConsumeLiteral("false");
+			case 'n':
+				OutValue.Value = nullptr;
+				return ConsumeLiteral("null");
+			default:
+				return ParseNumber(OutValue);
+			}
+		}
+
+		bool ParseObject(JsonValue& OutValue)
+		{
+			JsonValue::Object object;
+			++Position;
+			if (!Consume('}'))
+			{
+				do
+				{
+					std::string key;
+					JsonValue value;
+					SkipWhitespace();
+					if (!ParseString(key) || !Consume(':') || !ParseValue(value))
+					{
+						return false;
+					}
+
+					object.emplace(std::move(key), std::move(value));
+				}
+				while (Consume(','));
+
+				if (!Consume('}'))
+				{
+					return false;
+				}
+			}
+
+			OutValue.Value = std::move(object);
+			return true;
+		}
+
+		bool ParseArray(JsonValue& OutValue)
+		{
+			JsonValue::Array array;
+			++Position;
+			if (!Consume(']'))
+			{
+				do
+				{
+					JsonValue value;
+					if (!ParseValue(value))
+					{
+						return false;
+					}
+
+					array.push_back(std::move(value));
+				}
+				while (Consume(','));
+
+				if (!Consume(']'))
+				{
+					return false;
+				}
+			}
+
+			OutValue.Value = std::move(array);
+			return true;
+		}
+
+		bool ParseString(std::string& OutString)
+		{
+			if (Position >= Text.size() || Text[Position] != '"')
+			{
+				return false;
+			}
+
+			for (++Position; Position < Text.size(); ++Position)
+			{
+				const char character = Text[Position];
+				if (character == '"')
+				{
+					++Position;
+					return true;
+				}
+
+				if (character == '\\' && Position + 1 < Text.size())
+				{
+					++Position;
+				}
+				OutString.push_back(Text[Position]);
+			}
+
+			return false;
+		}
+
+		bool ParseNumber(JsonValue& OutValue)
+		{
+			double number = 0.0;
+			const auto [end, error] = std::from_chars(Text.data() + Position, Text.data() + Text.size(), number);
+			if (error != std::errc())
+			{
+				return false;
+			}
+
+			Position = static_cast<size_t>(end - Text.data());
+			OutValue.Value = number;
+			return true;
+		}
+
+		std::string_view Text;
+		size_t Position = 0;
+	};
+
+	uint64 MicrosecondsToNs(double Microseconds)
+	{
+		return static_cast<uint64>(Microseconds * 1000.0 + 0.5);
+	}
+
+	void LoadAccessSets(const JsonValue* Value, AccessSets& OutSets)
+	{
+		if (!Value)
+		{
+			return;
+		}
+
+		constexpr std::array<std::string_view, 4> operationNames = {"read", "write", "add", "delete"};
+		for (size_t operation = 0; operation < operationNames.size(); ++operation)
+		{
+			for (const JsonValue& typeId : Value->GetArray(operationNames[operation]))
+			{
+				if (const double* number = std::get_if<double>(&typeId.Value))
+				{
+					OutSets[operation].push_back(static_cast<uint32>(*number));
+				}
+			}
+		}
+	}
+}
+
+struct DescribedUpdatePass : UpdatePass
+{
+	explicit DescribedUpdatePass(const UpdatePassDescription& Description)
+	{
+		Name = Description.Name;
+		Type = FNV1AHash(Name);
+		for (const std::string& dependency : Description.DependsOn)
+		{
+			DependsOn.emplace(FNV1AHash(dependency));
+		}
+		GetUpdatePassMap()[Type] = this;
+	}
+};
+
+// Does nothing when run, so frames of a described graph measure the scheduler alone
+struct DescribedUpdateJob : UpdateJob
+{
+	explicit DescribedUpdateJob(const UpdateJobDescription& Description)
+		: JobName(Description.Name)
+		  , JobType(FNV1AHash(JobName))
+	{
+		UpdateFunction.Attach<&DescribedUpdateJob::Update>(this);
+		StaticWeight = Description.StaticWeight;
+		for (size_t operation = 0; operation < static_cast<size_t>(Operation::Count); ++operation)
+		{
+			for (const uint32 componentType : Description.Components[operation])
+			{
+				AddComponentOperation(componentType, static_cast<Operation>(operation));
+			}
+
+			for (const uint32 resourceType : Description.Resources[operation])
+			{
+				AddResourceOperation(resourceType, static_cast<Operation>(operation));
+			}
+		}
+	}
+
+	std::string_view GetName() const override
+	{
+		return JobName;
+	}
+
+	UpdateJobType GetType() const override
+	{
+		return JobType;
+	}
+
+	void Update(const float)
+	{
+	}
+
+	std::string JobName;
+	UpdateJobType JobType;
+};
+
+bool UpdateGraphDescription::Load(const Path& JsonPath)
+{
+	std::ifstream file(JsonPath);
+	if (!file)
+	{
+		LE_ERROR("Couldn't open {}", JsonPath.string());
+		return false;
+	}
+
+	std::stringstream contents;
+	contents << file.rdbuf();
+	const std::string text = contents.str();
+
+	JsonValue root;
+	if (!JsonParser(text).Parse(root))
+	{
+		LE_ERROR("{} is not valid JSON", JsonPath.string());
+		return false;
+	}
+
+	for (const JsonValue& pass : root.GetArray("passes"))
+	{
+		UpdatePassDescription& description = Passes.emplace_back();
+		description.Name = pass.GetString("name");
+		for (const JsonValue& dependency : pass.GetArray("depends_on"))
+		{
+			if (const std::string* dependencyName = std::get_if<std::string>(&dependency.Value))
+			{
+				description.DependsOn.push_back(*dependencyName);
+			}
+		}
+	}
+
+	for (const JsonValue& job : root.GetArray("jobs"))
+	{
+		UpdateJobDescription& description = Jobs.emplace_back();
+		description.Name = job.GetString("name");
+		description.PassName = job.GetString("pass");
+		description.StaticWeight = static_cast<uint32>(job.GetNumber("static_weight", 1.0));
+		description.P50ExecutionTimeNs = MicrosecondsToNs(job.GetNumber("p50_us"));
+		description.P99ExecutionTimeNs = MicrosecondsToNs(job.GetNumber("p99_us"));
+		LoadAccessSets(job.Find("components"), description.Components);
+		LoadAccessSets(job.Find("resources"), description.Resources);
+	}
+
+	if (Passes.empty() && !Jobs.empty())
+	{
+		LE_ERROR("{} has no passes, it was written before access sets were dumped", JsonPath.string());
+		return false;
+	}
+
+	return true;
+}
+
+bool UpdateGraphDescription::SplitJob(std::string_view JobName, uint32 PartCount)
+{
+	auto it = std::find_if(Jobs.begin(), Jobs.end(), [JobName](const UpdateJobDescription& Job)
+	{
+		return Job.Name == JobName;
+	});
+	if (it == Jobs.end() || PartCount == 0)
+	{
+		return false;
+	}
+
+	UpdateJobDescription job = std::move(*it);
+	it = Jobs.erase(it);
+	for (uint32 part = 0; part < PartCount; ++part)
+	{
+		UpdateJobDescription partJob = job;
+		partJob.Name = std::format("{}_Part{}", job.Name, part);
+		partJob.StaticWeight = Max<uint32>(job.StaticWeight / PartCount, 1);
+		partJob.P50ExecutionTimeNs = job.P50ExecutionTimeNs / PartCount;
+		partJob.P99ExecutionTimeNs = job.P99ExecutionTimeNs / PartCount;
+		it = std::next(Jobs.insert(it, std::move(partJob)));
+	}
+
+	return true;
+}
+
+const UpdateJobDescription* UpdateGraphDescription::FindJob(UpdateJobType JobType) const
+{
+	for (const UpdateJobDescription& job : Jobs)
+	{
+		if (FNV1AHash(job.Name) == JobType)
+		{
+			return &job;
+		}
+	}
+
+	return nullptr;
+}
+
+UpdateGraphInstance::UpdateGraphInstance(const UpdateGraphDescription& Description)
+{
+	for (const UpdatePassDescription& passDescription : Description.Passes)
+	{
+		Passes.push_back(std::make_unique<DescribedUpdatePass>(passDescription));
+	}
+
+	for (const UpdateJobDescription& jobDescription : Description.Jobs)
+	{
+		auto pass = std::find_if(Passes.begin(), Passes.end(), [&jobDescription](const UniquePtr<DescribedUpdatePass>& Pass)
+		{
+			return Pass->GetName() == jobDescription.PassName;
+		});
+		if (pass == Passes.end())
+		{
+			LE_WARN("Job {} belongs to unknown pass {}, it will be skipped", jobDescription.Name, jobDescription.PassName);
+			continue;
+		}
+
+		Jobs.push_back(std::make_unique<DescribedUpdateJob>(jobDescription));
+		(*pass)->AddJob(Jobs.back()->GetType(), Jobs.back().get());
+	}
+}
+
+UpdateGraphInstance::~UpdateGraphInstance() = default;
+}
\ No newline at end of file
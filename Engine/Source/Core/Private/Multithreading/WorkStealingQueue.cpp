@@ -0,0 +1,5 @@
+#include "Multithreading/WorkStealingQueue.h"
+
+namespace LE
+{
+}
\ No newline at end of file
@@ -1,4 +1,7 @@
 #pragma once
+#include <cstring>
+
+#include "PageAllocator.h"
 #include "SparseSet.h"
 #include "ECS/EcsComponent.h"
 #include "ECS/EcsSignals.h"
@@ -119,27 +122,124 @@ private:
 	difference_type Offset;
 };
 
+// Reference to a component stored in columns. Reading gathers the component from its columns and assigning scatters it back,
+// Get<Column>() touches only the one column
+template <typename ComponentType, uint64 PageSize, bool IsConst>
+class EcsColumnarReference
+{
+	using Layout = EcsColumnLayout<ComponentType, PageSize>;
+	using byte_type = std::conditional_t<IsConst, const std::byte, std::byte>;
+
+	template <size_t Column>
+	using ColumnTypeAt = std::conditional_t<IsConst, const typename Layout::template ColumnType<Column>, typename Layout::template ColumnType<Column>>;
+
+public:
+	EcsColumnarReference(byte_type* InPage, const size_t InSlot) noexcept
+		: Page(InPage)
+		  , Slot(InSlot)
+	{
+	}
+
+	EcsColumnarReference(const EcsColumnarReference<ComponentType, PageSize, false>& Other) noexcept requires IsConst
+		: Page(Other.Page)
+		  , Slot(Other.Slot)
+	{
+	}
+
+	EcsColumnarReference(const EcsColumnarReference&) noexcept = default;
+
+	template <size_t Column>
+	ColumnTypeAt<Column>& Get() const noexcept
+	{
+		return reinterpret_cast<ColumnTypeAt<Column>*>(Page + Layout::GetColumnPageOffset(Column))[Slot];
+	}
+
+	ComponentType Load() const noexcept
+	{
+		alignas(ComponentType) std::array<std::byte, sizeof(ComponentType)> bytes;
+		for (size_t column = 0; column < Layout::ColumnCount; ++column)
+		{
+			std::memcpy(bytes.data() + Layout::Offsets[column], GetColumnSlot(column), Layout::Sizes[column]);
+		}
+		return std::bit_cast<ComponentType>(bytes);
+	}
+
+	operator ComponentType() const noexcept
+	{
+		return Load();
+	}
+
+	const EcsColumnarReference& operator=(const ComponentType& Component) const noexcept requires (!IsConst)
+	{
+		const std::byte* bytes = reinterpret_cast<const std::byte*>(std::addressof(Component));
+		for (size_t column = 0; column < Layout::ColumnCount; ++column)
+		{
+			std::memcpy(GetColumnSlot(column), bytes + Layout::Offsets[column], Layout::Sizes[column]);
+		}
+		return *this;
+	}
+
+	// Copies the component, like assigning a plain reference would
+	const EcsColumnarReference& operator=(const EcsColumnarReference& Other) const noexcept requires (!IsConst)
+	{
+		return *this = Other.Load();
+	}
+
+private:
+	friend EcsColumnarReference<ComponentType, PageSize, true>;
+
+	byte_type* GetColumnSlot(const size_t Column) const noexcept
+	{
+		return Page + Layout::GetColumnPageOffset(Column) + Slot * Layout::Sizes[Column];
+	}
+
+	byte_type* Page;
+	size_t Slot;
+};
+
+template <typename Entity>
+using EcsComponentStorageFactory = UniquePtr<SparseSet<Entity>> (*)();
+
+// Every component storage that is used registers how to create it, so snapshots can be loaded into registries
+// that haven't used all of their components yet
+template <typename Entity>
+std::vector<EcsComponentStorageFactory<Entity>>& GetEcsComponentStorageFactories()
+{
+	static std::vector<EcsComponentStorageFactory<Entity>> factories; // Indexed by EcsComponentIndex
+	return factories;
+}
+
 template <typename ComponentType, typename Entity>
 class EcsComponentStorage : public SparseSet<Entity>
 {
 	using Traits = EcsComponentTraits<ComponentType, Entity>;
+	using Layout = EcsColumnLayout<ComponentType, Traits::PageSize>;
+	using page_type = std::conditional_t<Layout::IsColumnar, std::byte, ComponentType>; // Pages of columnar components are raw bytes
 
 public:
+	static constexpr bool IsColumnar = Layout::IsColumnar;
+
 	using value_type = ComponentType;
 	using base_type = SparseSet<Entity>;
 	using size_type = std::size_t;
-	using reference = ComponentType&;
-	using const_reference = const ComponentType&;
+	using reference = std::conditional_t<IsColumnar, EcsColumnarReference<ComponentType, Traits::PageSize, false>, ComponentType&>;
+	using const_reference = std::conditional_t<IsColumnar, EcsColumnarReference<ComponentType, Traits::PageSize, true>, const ComponentType&>;
+	template <size_type Column>
+	using column_type = typename Layout::template ColumnType<Column>;
 	using difference_type = std::ptrdiff_t;
 	using iterator = EcsStorageIterator<std::vector<ComponentType*>, Traits::PageSize>;
 	using const_iterator = iterator;
 	using reverse_iterator = std::reverse_iterator<iterator>;
 	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 	using signal_type = Signal<void(const Entity)>;
+	using batch_signal_type = Signal<void(std::span<const Entity>)>;
+
+	static constexpr size_type ComponentsPerPage = Traits::PageSize;
 
 	EcsComponentStorage()
 		: base_type(base_type::Usage::Component)
 	{
+		(void)IsFactoryRegistered;
 	}
 
 	EcsComponentStorage(const EcsComponentStorage&) = delete;
@@ -149,7 +249,8 @@ public:
 		  , ComponentContainer(std::move(Other.ComponentContainer))
 		  , AddedSignal(std::move(Other.AddedSignal))
 		  , RemovedSignal(std::move(Other.RemovedSignal))
-		  , UpdatedSignal(std::move(Other.UpdatedSignal))
+		  , BatchAddedSignal(std::move(Other.BatchAddedSignal))
+		  , BatchRemovedSignal(std::move(Other.BatchRemovedSignal))
 	{
 	}
 
@@ -171,7 +272,8 @@ public:
 		std::swap(ComponentContainer, Other.ComponentContainer);
 		std::swap(AddedSignal, Other.AddedSignal);
 		std::swap(RemovedSignal, Other.RemovedSignal);
-		std::swap(UpdatedSignal, Other.UpdatedSignal);
+		std::swap(BatchAddedSignal, Other.BatchAddedSignal);
+		std::swap(BatchRemovedSignal, Other.BatchRemovedSignal);
 		base_type::Swap(Other);
 	}
 
@@ -183,7 +285,19 @@ public:
 		}
 
 		base_type::Reserve(Count);
-		GetCreateComponentSlot(Count);
+		AllocateComponentPages(Count - 1);
+	}
+
+	// Gives the pages past the last component back to the shared free list
+	void ShrinkToFit() override
+	{
+		const size_type usedPageCount = (static_cast<size_type>(base_type::Count()) + Traits::PageSize - 1) / Traits::PageSize;
+		for (size_type page = usedPageCount; page < ComponentContainer.size(); ++page)
+		{
+			FreeComponentPage(ComponentContainer[page]);
+		}
+		ComponentContainer.resize(usedPageCount);
+		base_type::ShrinkToFit();
 	}
 
 	uint64 Capacity() const noexcept override
@@ -191,11 +305,144 @@ public:
 		return ComponentContainer.size() * Traits::PageSize;
 	}
 
+	// Trivially copyable components are written as a raw block per page, or per column of a page, the others go through EcsComponentSerializer
+	void SaveSnapshot(EcsSnapshotWriter& Writer) const override
+	{
+		LE_ASSERT_DESC(IsSnapshotSupported || base_type::Empty(),
+		               "Component can't be snapshotted, make it trivially copyable or specialize EcsComponentSerializer for it")
+
+		base_type::SaveSnapshot(Writer);
+		Writer.WriteValue<uint64>(sizeof(ComponentType));
+		const size_type count = static_cast<size_type>(base_type::Count());
+		if constexpr (std::is_trivially_copyable_v<ComponentType>)
+		{
+			for (size_type pageBegin = 0; pageBegin < count; pageBegin += Traits::PageSize)
+			{
+				const page_type* page = ComponentContainer[pageBegin / Traits::PageSize];
+				const size_type pageCount = Min<size_type>(count - pageBegin, Traits::PageSize);
+				if constexpr (IsColumnar)
+				{
+					for (size_type column = 0; column < Layout::ColumnCount; ++column)
+					{
+						Writer.Write(page + Layout::GetColumnPageOffset(column), pageCount * Layout::Sizes[column]);
+					}
+				}
+				else
+				{
+					Writer.Write(page, pageCount * sizeof(ComponentType));
+				}
+			}
+		}
+		else if constexpr (EcsSerializableComponent<ComponentType>)
+		{
+			for (size_type position = 0; position < count; ++position)
+			{
+				EcsComponentSerializer<ComponentType>::Save(Writer, GetComponentRef(position));
+			}
+		}
+	}
+
+	// Components written by a serializer are counted as their in-memory size
+	uint64 GetSnapshotSize() const override
+	{
+		return base_type::GetSnapshotSize() + sizeof(uint64) + base_type::Count() * sizeof(ComponentType);
+	}
+
+	// Replaces the components without per entity signals, batch listeners get all the removed and then all the loaded entities at once.
+	// The storage is left empty if the snapshot is broken
+	bool LoadSnapshot(EcsSnapshotReader& Reader) override
+	{
+		BatchRemovedSignal.Dispatch(std::span<const Entity>(base_type::Data(), base_type::Count()));
+		DestroyComponents();
+
+		uint64 componentSize = 0;
+		if (!base_type::LoadSnapshot(Reader) || !Reader.ReadValue(componentSize) || componentSize != sizeof(ComponentType))
+		{
+			base_type::ResetToEmpty();
+			return false;
+		}
+
+		const size_type count = static_cast<size_type>(base_type::Count());
+		if (count > 0)
+		{
+			AllocateComponentPages(count - 1);
+		}
+
+		if constexpr (std::is_trivially_copyable_v<ComponentType>)
+		{
+			for (size_type pageBegin = 0; pageBegin < count; pageBegin += Traits::PageSize)
+			{
+				page_type* page = ComponentContainer[pageBegin / Traits::PageSize];
+				const size_type pageCount = Min<size_type>(count - pageBegin, Traits::PageSize);
+				if constexpr (IsColumnar)
+				{
+					for (size_type column = 0; column < Layout::ColumnCount; ++column)
+					{
+						if (!Reader.Read(page + Layout::GetColumnPageOffset(column), pageCount * Layout::Sizes[column]))
+						{
+							base_type::ResetToEmpty();
+							return false;
+						}
+					}
+				}
+				else if (!Reader.Read(page, pageCount * sizeof(ComponentType)))
+				{
+					base_type::ResetToEmpty();
+					return false;
+				}
+			}
+		}
+		else if constexpr (EcsSerializableComponent<ComponentType>)
+		{
+			// Serializers return a component even after the reader failed, so every slot is constructed either way
+			for (size_type position = 0; position < count; ++position)
+			{
+				std::construct_at(std::addressof(GetComponentRef(position)), EcsComponentSerializer<ComponentType>::Load(Reader));
+			}
+
+			if (!Reader.IsValid())
+			{
+				DestroyComponents();
+				base_type::ResetToEmpty();
+				return false;
+			}
+		}
+		else if (count > 0)
+		{
+			base_type::ResetToEmpty();
+			return false;
+		}
+
+		BatchAddedSignal.Dispatch(std::span<const Entity>(base_type::Data(), base_type::Count()));
+		return true;
+	}
+
 	ComponentType* Raw() noexcept
 	{
 		return ComponentContainer.data();
 	}
 
+	// Components of the packed positions [PageIndex * ComponentsPerPage, (PageIndex + 1) * ComponentsPerPage)
+	ComponentType* GetComponentPage(const size_type PageIndex) const noexcept
+	{
+		static_assert(!IsColumnar, "Component is stored in columns, use GetColumnPage");
+		return ComponentContainer[PageIndex];
+	}
+
+	// One column of the components of the page, the same positions as GetComponentPage
+	template <size_type Column>
+	column_type<Column>* GetColumnPage(const size_type PageIndex) const noexcept
+	{
+		static_assert(IsColumnar, "Component isn't stored in columns, use GetComponentPage");
+		return reinterpret_cast<column_type<Column>*>(ComponentContainer[PageIndex] + Layout::GetColumnPageOffset(Column));
+	}
+
+	// Component at the packed position, it's not marked as changed
+	reference GetComponentAt(const size_type Position) const noexcept
+	{
+		return GetComponentRef(Position);
+	}
+
 	iterator begin() const noexcept
 	{
 		const difference_type pos = static_cast<difference_type>(base_type::Count());
@@ -237,65 +484,69 @@ public:
 		return rend();
 	}
 
-	const ComponentType& GetComponent(const Entity EcsEntity) const noexcept
+	const_reference GetComponent(const Entity EcsEntity) const noexcept
 	{
 		return GetComponentRef(base_type::GetSparseIndex(EcsEntity));
 	}
 
-	ComponentType& GetComponent(const Entity EcsEntity) noexcept
+	// Mutable access only stamps the component with the current change tick, it's not checked whether anything was written
+	reference GetComponent(const Entity EcsEntity) noexcept
 	{
-		UpdatedSignal.Dispatch(EcsEntity);
-		return GetComponentRef(base_type::GetSparseIndex(EcsEntity));
+		const size_type index = base_type::GetSparseIndex(EcsEntity);
+		base_type::SetChangedTickAt(index, GetEcsChangeTick());
+		return GetComponentRef(index);
 	}
 
-	std::tuple<const ComponentType&> GetComponentAsTuple(const Entity EcsEntity) const noexcept
+	std::tuple<const_reference> GetComponentAsTuple(const Entity EcsEntity) const noexcept
 	{
-		return std::forward_as_tuple(GetComponent(EcsEntity));
+		return std::tuple<const_reference>(GetComponent(EcsEntity));
 	}
 
-	std::tuple<ComponentType&> GetComponentAsTuple(const Entity EcsEntity) noexcept
+	std::tuple<reference> GetComponentAsTuple(const Entity EcsEntity) noexcept
 	{
-		UpdatedSignal.Dispatch(EcsEntity);
-		return std::forward_as_tuple(GetComponent(EcsEntity));
+		return std::tuple<reference>(GetComponent(EcsEntity));
 	}
 
 	template <typename... Args>
-	ComponentType& CreateComponent(const Entity EcsEntity, Args&&... InArgs)
+	reference CreateComponent(const Entity EcsEntity, Args&&... InArgs)
 	{
-		const typename base_type::iterator it = CreateComponentImpl(EcsEntity, std::forward<Args>(InArgs)...);
+		CreateComponentImpl(EcsEntity, std::forward<Args>(InArgs)...);
+		BatchAddedSignal.Dispatch(std::span<const Entity>(&EcsEntity, 1));
 		AddedSignal.Dispatch(EcsEntity);
-		return GetComponentRef(it.Index());
+		// Listeners, like groups, may have moved the component
+		return GetComponentRef(base_type::GetSparseIndex(EcsEntity));
 	}
 
+	// Components of the whole range are created before anybody is notified, batch listeners get them in one call
 	template <typename EntityIterator>
-	iterator CreateComponent(EntityIterator FirstEntity, EntityIterator LastEntity, const ComponentType& Component = {})
+	void CreateComponent(EntityIterator FirstEntity, EntityIterator LastEntity, const ComponentType& Component = {})
 	{
+		const size_type firstIndex = ReserveForRange(FirstEntity, LastEntity);
 		for (EntityIterator current = FirstEntity; current != LastEntity; ++current)
 		{
-			CreateComponent(*current, Component);
+			CreateComponentImpl(*current, Component);
 		}
-
-		return begin();
+		NotifyAdded(firstIndex, FirstEntity, LastEntity);
 	}
 
 	template <typename EntityIterator, typename ComponentIterator, typename = std::enable_if<std::is_same_v<
 		          typename std::iterator_traits<ComponentIterator>::value_type, ComponentType>>>
-	iterator CreateComponents(EntityIterator FirstEntity, EntityIterator LastEntity, ComponentIterator FirstComponent)
+	void CreateComponents(EntityIterator FirstEntity, EntityIterator LastEntity, ComponentIterator FirstComponent)
 	{
+		const size_type firstIndex = ReserveForRange(FirstEntity, LastEntity);
 		for (EntityIterator current = FirstEntity; current != LastEntity; ++current, ++FirstComponent)
 		{
-			CreateComponent(*current, *FirstComponent);
+			CreateComponentImpl(*current, *FirstComponent);
 		}
-
-		return begin();
+		NotifyAdded(firstIndex, FirstEntity, LastEntity);
 	}
 
 	template <typename... Func>
-	ComponentType& RunOnComponent(const Entity EcsEntity, Func&&... InFunc)
+	reference RunOnComponent(const Entity EcsEntity, Func&&... InFunc)
 	{
-		UpdatedSignal.Dispatch(EcsEntity);
 		const size_type idx = base_type::GetSparseIndex(EcsEntity);
-		ComponentType& component = GetComponentRef(idx);
+		base_type::SetChangedTickAt(idx, GetEcsChangeTick());
+		reference component = GetComponentRef(idx);
 		(std::forward<Func>(InFunc)(component), ...);
 		return component;
 	}
@@ -310,9 +561,17 @@ public:
 		return Sink{ RemovedSignal };
 	}
 
-	auto GetOnUpdatedSink() noexcept
+	// Batch listeners are called once per bulk operation, and with a single entity otherwise. They run before the per entity ones,
+	// while the batch is still packed together
+	auto GetOnBatchAddedSink() noexcept
 	{
-		return Sink{ UpdatedSignal };
+		return Sink{ BatchAddedSignal };
+	}
+
+	// Called before the components are removed
+	auto GetOnBatchRemovedSink() noexcept
+	{
+		return Sink{ BatchRemovedSignal };
 	}
 
 protected:
@@ -320,42 +579,155 @@ protected:
 	{
 		for (typename base_type::iterator current = Begin; current != End; ++current)
 		{
-			RemovedSignal.Dispatch(*current);
-			ComponentType& component = GetComponentRef(base_type::GetSparseIndex(*current));
-			ComponentType& lastComponent = GetComponentRef(static_cast<size_type>(base_type::Count() - 1));
-			std::exchange(component, std::move(lastComponent));
-			std::destroy_at(std::addressof(component));
-			base_type::SwapPop(current);
+			const Entity entity = *current;
+			BatchRemovedSignal.Dispatch(std::span<const Entity>(&entity, 1));
+			PopComponent(entity);
+		}
+	}
+
+	void PopEntities(std::span<const Entity> Entities) override
+	{
+		BatchRemovedSignal.Dispatch(Entities);
+		for (const Entity entity : Entities)
+		{
+			PopComponent(entity);
+		}
+	}
+
+	void SwapPayloads(const size_type Lhs, const size_type Rhs) override
+	{
+		if constexpr (IsColumnar)
+		{
+			for (size_type column = 0; column < Layout::ColumnCount; ++column)
+			{
+				std::swap_ranges(GetColumnSlot(column, Lhs), GetColumnSlot(column, Lhs) + Layout::Sizes[column], GetColumnSlot(column, Rhs));
+			}
+		}
+		else
+		{
+			std::swap(GetComponentRef(Lhs), GetComponentRef(Rhs));
 		}
 	}
 
 	void PopAll() override
 	{
+		BatchRemovedSignal.Dispatch(std::span<const Entity>(base_type::Data(), base_type::Count()));
 		for (typename base_type::iterator current = base_type::begin(); current.Index() >= 0; ++current)
 		{
 			RemovedSignal.Dispatch(*current);
 			base_type::SwapPop(current);
-			ComponentType& component = GetComponentRef(current.Index());
-			std::destroy_at(std::addressof(component));
+			if constexpr (!IsColumnar)
+			{
+				std::destroy_at(std::addressof(GetComponentRef(current.Index())));
+			}
 		}
 	}
 
 private:
+	void PopComponent(const Entity EcsEntity)
+	{
+		// Listeners, like groups, may move the entity, so it's looked up again after the dispatch
+		RemovedSignal.Dispatch(EcsEntity);
+		const size_type index = base_type::GetSparseIndex(EcsEntity);
+		const size_type lastIndex = static_cast<size_type>(base_type::Count() - 1);
+		if constexpr (IsColumnar)
+		{
+			if (index != lastIndex)
+			{
+				for (size_type column = 0; column < Layout::ColumnCount; ++column)
+				{
+					std::memcpy(GetColumnSlot(column, index), GetColumnSlot(column, lastIndex), Layout::Sizes[column]);
+				}
+			}
+		}
+		else
+		{
+			ComponentType& lastComponent = GetComponentRef(lastIndex);
+			if (index != lastIndex)
+			{
+				GetComponentRef(index) = std::move(lastComponent);
+			}
+			std::destroy_at(std::addressof(lastComponent));
+		}
+		base_type::SwapPop(base_type::GetIterator(EcsEntity));
+	}
+
+	// Returns the packed index the range will start at
+	template <typename EntityIterator>
+	size_type ReserveForRange(EntityIterator FirstEntity, EntityIterator LastEntity)
+	{
+		const size_type firstIndex = static_cast<size_type>(base_type::Count());
+		Reserve(firstIndex + static_cast<size_type>(std::distance(FirstEntity, LastEntity)));
+		return firstIndex;
+	}
+
+	template <typename EntityIterator>
+	void NotifyAdded(const size_type FirstIndex, EntityIterator FirstEntity, EntityIterator LastEntity)
+	{
+		BatchAddedSignal.Dispatch(std::span<const Entity>(base_type::Data() + FirstIndex, base_type::Count() - FirstIndex));
+		if (!AddedSignal.IsEmpty())
+		{
+			// Listeners may reorder the packed entities, so the single ones are taken from the range
+			for (EntityIterator current = FirstEntity; current != LastEntity; ++current)
+			{
+				AddedSignal.Dispatch(*current);
+			}
+		}
+	}
+
+	// Pages are raw memory, only the slots holding components have something to destroy
+	void DestroyComponents()
+	{
+		if constexpr (!IsColumnar && !std::is_trivially_destructible_v<ComponentType>)
+		{
+			for (size_type position = 0; position < base_type::Count(); ++position)
+			{
+				std::destroy_at(std::addressof(GetComponentRef(position)));
+			}
+		}
+	}
+
 	void FreeComponentPages()
 	{
-		for (ComponentType* page : ComponentContainer)
+		DestroyComponents();
+		for (page_type*& page : ComponentContainer)
 		{
-			delete[] page;
+			FreeComponentPage(page);
 			page = nullptr;
 		}
 	}
 
-	ComponentType& GetComponentRef(const size_type Position)
+	static void FreeComponentPage(page_type* Page)
+	{
+		if constexpr (IsColumnar)
+		{
+			PageAllocator::Get().Free(Page, Layout::PageBytes);
+		}
+		else
+		{
+			PageAllocator::Get().FreePage(Page, Traits::PageSize);
+		}
+	}
+
+	reference GetComponentRef(const size_type Position) const
+	{
+		if constexpr (IsColumnar)
+		{
+			return reference(ComponentContainer[Position / Traits::PageSize], FastMod(Position, Traits::PageSize));
+		}
+		else
+		{
+			return ComponentContainer[Position / Traits::PageSize][FastMod(Position, Traits::PageSize)];
+		}
+	}
+
+	std::byte* GetColumnSlot(const size_type Column, const size_type Position) const
 	{
-		return ComponentContainer[Position / Traits::PageSize][FastMod(Position, Traits::PageSize)];
+		return ComponentContainer[Position / Traits::PageSize] + Layout::GetColumnPageOffset(Column)
+			+ FastMod(Position, Traits::PageSize) * Layout::Sizes[Column];
 	}
 
-	ComponentType* GetCreateComponentSlot(const size_type Position)
+	void AllocateComponentPages(const size_type Position)
 	{
 		const size_type pageIdx = Position / Traits::PageSize;
 		if (pageIdx >= ComponentContainer.size())
@@ -364,28 +736,64 @@ private:
 			ComponentContainer.resize(pageIdx + 1, nullptr);
 			for (; current < ComponentContainer.size(); ++current)
 			{
-				ComponentContainer[current] = new ComponentType[Traits::PageSize];
+				// Components are constructed when they are created, unused slots cost nothing but memory
+				if constexpr (IsColumnar)
+				{
+					ComponentContainer[current] = static_cast<std::byte*>(PageAllocator::Get().Allocate(Layout::PageBytes));
+				}
+				else
+				{
+					ComponentContainer[current] = PageAllocator::Get().AllocatePage<ComponentType>(Traits::PageSize);
+				}
 			}
 		}
-
-		return ComponentContainer[pageIdx] + FastMod(Position, Traits::PageSize);
 	}
 
 	template <typename... Args>
 	typename base_type::iterator CreateComponentImpl(const Entity EcsEntity, Args&&... InArgs)
 	{
 		typename base_type::iterator it = base_type::Add(EcsEntity);
-		ComponentType* component = std::to_address(GetCreateComponentSlot(static_cast<size_type>(it.Index())));
-		std::uninitialized_construct_using_allocator(component, ComponentContainer.get_allocator(), std::forward<Args>(InArgs)...);
+		const size_type position = static_cast<size_type>(it.Index());
+		AllocateComponentPages(position);
+		if constexpr (IsColumnar)
+		{
+			// Component is built whole and scattered into the columns
+			GetComponentRef(position) = std::make_obj_using_allocator<ComponentType>(ComponentContainer.get_allocator(), std::forward<Args>(InArgs)...);
+		}
+		else
+		{
+			std::uninitialized_construct_using_allocator(std::addressof(GetComponentRef(position)), ComponentContainer.get_allocator(),
+			                                             std::forward<Args>(InArgs)...);
+		}
 
 		return it;
 	}
 
+	static bool RegisterFactory()
+	{
+		std::vector<EcsComponentStorageFactory<Entity>>& factories = GetEcsComponentStorageFactories<Entity>();
+		const EcsComponentIndex componentIndex = ComponentTypeIdGetter<ComponentType>::GetIndex();
+		if (componentIndex >= factories.size())
+		{
+			factories.resize(componentIndex + 1, nullptr);
+		}
+
+		factories[componentIndex] = []() -> UniquePtr<SparseSet<Entity>>
+		{
+			return std::make_unique<EcsComponentStorage>();
+		};
+		return true;
+	}
+
+	static constexpr bool IsSnapshotSupported = std::is_trivially_copyable_v<ComponentType> || EcsSerializableComponent<ComponentType>;
+	static inline const bool IsFactoryRegistered = RegisterFactory(); // Referenced by the constructor, so it's registered on startup
+
 private:
-	std::vector<ComponentType*> ComponentContainer;
+	std::vector<page_type*> ComponentContainer;
 	signal_type AddedSignal;
 	signal_type RemovedSignal;
-	signal_type UpdatedSignal; // Doesn't handle iterator
+	batch_signal_type BatchAddedSignal;
+	batch_signal_type BatchRemovedSignal;
 };
 
 template <typename Entity>
@@ -406,6 +814,29 @@ public:
 	{
 	}
 
+	void SaveSnapshot(EcsSnapshotWriter& Writer) const override
+	{
+		base_type::SaveSnapshot(Writer);
+		Writer.WriteValue(EntityCounter);
+	}
+
+	uint64 GetSnapshotSize() const override
+	{
+		return base_type::GetSnapshotSize() + sizeof(EntityCounter);
+	}
+
+	bool LoadSnapshot(EcsSnapshotReader& Reader) override
+	{
+		if (!base_type::LoadSnapshot(Reader) || !Reader.ReadValue(EntityCounter))
+		{
+			base_type::ResetToEmpty();
+			EntityCounter = {};
+			return false;
+		}
+
+		return true;
+	}
+
 	Entity CreateEntity()
 	{
 		const size_t head = base_type::GetFreeListHead();
@@ -413,6 +844,24 @@ public:
 		return *base_type::TryAdd(entity);
 	}
 
+	// Recycles the free entities first, the packed array grows at most once for the rest
+	template <typename EntityIterator>
+	void CreateEntities(EntityIterator FirstEntity, EntityIterator LastEntity)
+	{
+		const size_type count = static_cast<size_type>(std::distance(FirstEntity, LastEntity));
+		const size_type packedCount = static_cast<size_type>(base_type::Count());
+		const size_type freeCount = packedCount - base_type::GetFreeListHead();
+		if (count > freeCount)
+		{
+			base_type::Reserve(packedCount + count - freeCount);
+		}
+
+		for (EntityIterator current = FirstEntity; current != LastEntity; ++current)
+		{
+			*current = CreateEntity();
+		}
+	}
+
 private:
 	Entity GetAvailableEntity()
 	{
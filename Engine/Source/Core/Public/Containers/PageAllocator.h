@@ -0,0 +1,63 @@
+#pragma once
+#include <mutex>
+#include <vector>
+
+#include "CoreDefinitions.h"
+
+namespace LE
+{
+// Raw memory pages for the ECS storages, nothing is constructed in them. Freed pages are kept in free lists shared
+// by all storages, one per page size, so storages that shrink and grow again don't go back to the OS
+class PageAllocator
+{
+public:
+	static constexpr size_t PageAlignment = CACHE_LINE_SIZE;
+	static constexpr size_t LargePageSize = 2 * 1024 * 1024;
+
+	static PageAllocator& Get(); // Never destroyed, storages owned by statics free their pages at exit
+
+	void* Allocate(size_t Size);
+	void Free(void* Page, size_t Size);
+
+	template <typename Type>
+	Type* AllocatePage(size_t Count)
+	{
+		static_assert(alignof(Type) <= PageAlignment, "Type needs bigger alignment than pages have");
+		return static_cast<Type*>(Allocate(Count * sizeof(Type)));
+	}
+
+	template <typename Type>
+	void FreePage(Type* Page, size_t Count)
+	{
+		Free(Page, Count * sizeof(Type));
+	}
+
+	// Gives the free pages back to the OS, e.g. after a level is unloaded
+	void ReleaseFreePages();
+
+	// Pages of at least LargePageSize are aligned to it and the OS is asked to back them with huge pages.
+	// Only Linux transparent huge pages are used, large pages on Windows need a privilege the game doesn't have
+	void SetUseLargePages(bool InUseLargePages);
+
+	size_t GetAllocatedBytes() const; // Both the pages in use and the free ones
+	size_t GetFreeBytes() const;
+
+private:
+	PageAllocator() = default;
+
+	struct FreeList
+	{
+		size_t Size;
+		std::vector<void*> Pages;
+	};
+
+	static void* AllocateFromSystem(size_t Size, bool IsLargePage);
+	static void FreeToSystem(void* Page);
+
+	mutable std::mutex Mutex;
+	std::vector<FreeList> FreeLists; // There are only a few page sizes, one per component size
+	size_t AllocatedBytes = 0;
+	size_t FreeBytes = 0;
+	bool UseLargePages = false;
+};
+}
\ No newline at end of file
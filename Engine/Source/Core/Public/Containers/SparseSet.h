@@ -1,6 +1,14 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <span>
+
 #include "CoreMinimum.h"
+#include "PageAllocator.h"
 #include "CoreConcepts.h"
+#include "ECS/EcsDefinitions.h"
+#include "ECS/EcsSnapshot.h"
 #include "Math/Math.h"
 
 
@@ -146,6 +154,16 @@ public:
 		Entity,
 	};
 
+	// Change ticks of a packed component, only component storages keep them
+	struct ComponentTicks
+	{
+		EcsTick Added;
+		EcsTick Changed;
+	};
+
+	// Packed positions sharing one newest changed tick, same as the component pages of the storages
+	static constexpr size_type ChangedTickPageSize = static_cast<size_type>(Traits::PageSize);
+
 	SparseSet(Usage Usage)
 		: Sparse({})
 		  , Packed({})
@@ -159,6 +177,8 @@ public:
 	SparseSet(SparseSet&& Other) noexcept
 		: Sparse(std::move(Other.Sparse))
 		  , Packed(std::move(Other.Packed))
+		  , Ticks(std::move(Other.Ticks))
+		  , ChangedPageTicks(std::move(Other.ChangedPageTicks))
 		  , CurrentUsage(Other.CurrentUsage)
 		  , Head(std::exchange(Other.Head, GetUsageHead()))
 	{
@@ -181,6 +201,8 @@ public:
 	{
 		std::swap(Sparse, Other.Sparse);
 		std::swap(Packed, Other.Packed);
+		std::swap(Ticks, Other.Ticks);
+		std::swap(ChangedPageTicks, Other.ChangedPageTicks);
 		std::swap(CurrentUsage, Other.CurrentUsage);
 		std::swap(Head, Other.Head);
 	}
@@ -188,6 +210,11 @@ public:
 	virtual void Reserve(const uint64 Count)
 	{
 		Packed.reserve(static_cast<size_t>(Count));
+		if (CurrentUsage == Usage::Component)
+		{
+			Ticks.reserve(static_cast<size_t>(Count));
+			ChangedPageTicks.reserve(static_cast<size_t>((Count + ChangedTickPageSize - 1) / ChangedTickPageSize));
+		}
 	}
 
 	virtual uint64 Capacity() const noexcept
@@ -195,6 +222,101 @@ public:
 		return static_cast<uint64>(Packed.capacity());
 	}
 
+	virtual void ShrinkToFit()
+	{
+		Packed.shrink_to_fit();
+		Ticks.shrink_to_fit();
+		ChangedPageTicks.shrink_to_fit();
+	}
+
+	// Writes the packed and sparse arrays as they are, loading them restores the same order and free list.
+	// Ticks aren't written, they belong to the run that took the snapshot
+	virtual void SaveSnapshot(EcsSnapshotWriter& Writer) const
+	{
+		Writer.WriteValue<uint64>(Head);
+		Writer.WriteArray(std::span<const Type>(Packed));
+
+		const uint64 pageCount = static_cast<uint64>(std::count_if(Sparse.begin(), Sparse.end(), [](const Type* Page) { return Page != nullptr; }));
+		Writer.WriteValue<uint64>(Sparse.size());
+		Writer.WriteValue(pageCount);
+		for (size_type page = 0; page < Sparse.size(); ++page)
+		{
+			if (Sparse[page])
+			{
+				Writer.WriteValue<uint64>(page);
+				Writer.Write(Sparse[page], Traits::PageSize * sizeof(Type));
+			}
+		}
+	}
+
+	// Bytes SaveSnapshot writes, exact unless a derived storage has to guess it
+	virtual uint64 GetSnapshotSize() const
+	{
+		const uint64 pageCount = static_cast<uint64>(std::count_if(Sparse.begin(), Sparse.end(), [](const Type* Page) { return Page != nullptr; }));
+		return 4 * sizeof(uint64) + Packed.size() * sizeof(Type) + pageCount * (sizeof(uint64) + Traits::PageSize * sizeof(Type));
+	}
+
+	// Replaces the contents without any signals. The snapshot is checked before anything is replaced, the set is left as it was
+	// if it's cut short or its packed and sparse arrays don't match. Loaded components count as added and changed at the current tick,
+	// so Changed views pick them up
+	virtual bool LoadSnapshot(EcsSnapshotReader& Reader)
+	{
+		uint64 head = 0;
+		std::vector<Type> packed;
+		uint64 sparseSize = 0;
+		uint64 pageCount = 0;
+		if (!Reader.ReadValue(head) || !Reader.ReadArray(packed) || !Reader.ReadValue(sparseSize) || !Reader.ReadValue(pageCount)
+			|| sparseSize > MaxSize / Traits::PageSize + 1 || pageCount > sparseSize)
+		{
+			return false;
+		}
+
+		// Pages are only copied out of the reader once the whole snapshot is known to be consistent
+		std::vector<const std::byte*> pageData(static_cast<size_type>(sparseSize), nullptr);
+		for (uint64 current = 0; current < pageCount; ++current)
+		{
+			uint64 page = 0;
+			if (!Reader.ReadValue(page) || page >= sparseSize || pageData[static_cast<size_type>(page)])
+			{
+				return false;
+			}
+
+			pageData[static_cast<size_type>(page)] = Reader.ReadBlock(Traits::PageSize * sizeof(Type));
+			if (!pageData[static_cast<size_type>(page)])
+			{
+				return false;
+			}
+		}
+
+		if (!IsSnapshotConsistent(head, packed, pageData))
+		{
+			return false;
+		}
+
+		// Pages already allocated are reused, the ones the snapshot doesn't have go back to the page allocator
+		std::vector<Type*> sparse(static_cast<size_type>(sparseSize), nullptr);
+		for (size_type page = 0; page < sparse.size(); ++page)
+		{
+			if (pageData[page])
+			{
+				sparse[page] = page < Sparse.size() && Sparse[page] ? std::exchange(Sparse[page], nullptr) : PageAllocator::Get().AllocatePage<Type>(Traits::PageSize);
+				std::memcpy(sparse[page], pageData[page], Traits::PageSize * sizeof(Type));
+			}
+		}
+
+		ReleaseSparsePages();
+		Sparse = std::move(sparse);
+		Packed = std::move(packed);
+		Head = static_cast<size_type>(head);
+		if (CurrentUsage == Usage::Component)
+		{
+			const EcsTick tick = GetEcsChangeTick();
+			Ticks.assign(Packed.size(), {tick, tick});
+			ChangedPageTicks.assign((Packed.size() + ChangedTickPageSize - 1) / ChangedTickPageSize, tick);
+		}
+		return true;
+	}
+
 	uint64 SparseSize() const noexcept
 	{
 		return static_cast<uint64>(Sparse.size()) * Traits::PageSize;
@@ -289,6 +411,12 @@ public:
 		Pop(it, it + 1);
 	}
 
+	// All of the Entities have to be in the set
+	void Delete(std::span<const Type> Entities)
+	{
+		PopEntities(Entities);
+	}
+
 	void Clear()
 	{
 		PopAll();
@@ -298,18 +426,7 @@ public:
 	bool Has(const Type Entity) const noexcept
 	{
 		const Type* sparsePtr = GetSparsePointer(Entity);
-		if (!sparsePtr)
-		{
-			return false;
-		}
-
-		constexpr typename Traits::IdType cap = Traits::IdMask; // Lower bits
-		constexpr typename Traits::ValueType generationMask = Traits::GetAsValue(EcsEntityNull) & ~cap; // To avoid shifting
-
-		auto nullCheck = generationMask & Entity;
-		auto genCheck = nullCheck ^ *sparsePtr;
-
-		return genCheck < cap; // Checks that Generation bits are the same, and that the entity is not null
+		return sparsePtr && IsSparseEntryOf(Entity, *sparsePtr);
 	}
 
 	const_iterator Find(const Type Entity)
@@ -324,6 +441,19 @@ public:
 		return GetEntityIndex(GetSparseRef(Entity));
 	}
 
+	// Has and GetSparseIndex with a single sparse lookup, for loops visiting entities that may not be in the set
+	bool TryGetSparseIndex(const Type Entity, size_type& OutIndex) const noexcept
+	{
+		const Type* sparsePtr = GetSparsePointer(Entity);
+		if (!sparsePtr || !IsSparseEntryOf(Entity, *sparsePtr))
+		{
+			return false;
+		}
+
+		OutIndex = GetEntityIndex(*sparsePtr);
+		return true;
+	}
+
 	typename Traits::GenerationType GetContainedEntityGeneration(const Type Entity)
 	{
 		if (const Type* sparsePtr = GetSparsePointer(Entity))
@@ -348,7 +478,63 @@ public:
 		return UpdateGeneration(newGenEntity);
 	}
 
+	EcsTick GetAddedTick(const Type Entity) const
+	{
+		return Ticks[GetSparseIndex(Entity)].Added;
+	}
+
+	EcsTick GetAddedTickAt(const size_type Index) const noexcept
+	{
+		return Ticks[Index].Added;
+	}
+
+	EcsTick GetChangedTick(const Type Entity) const
+	{
+		return Ticks[GetSparseIndex(Entity)].Changed;
+	}
+
+	EcsTick GetChangedTickAt(const size_type Index) const noexcept
+	{
+		return Ticks[Index].Changed;
+	}
+
+	// Newest changed tick of the page holding the packed position, no component of the page changed after it
+	EcsTick GetChangedPageTickAt(const size_type Index) const noexcept
+	{
+		return std::atomic_ref<EcsTick>(const_cast<EcsTick&>(ChangedPageTicks[Index / ChangedTickPageSize])).load(std::memory_order_relaxed);
+	}
+
+	// Mutable component access does it on its own, only needed for writes through pointers taken earlier
+	void MarkChanged(const Type Entity)
+	{
+		SetChangedTickAt(GetSparseIndex(Entity), GetEcsChangeTick());
+	}
+
+	void SetChangedTickAt(const size_type Index, const EcsTick Tick) noexcept
+	{
+		Ticks[Index].Changed = Tick;
+		MarkPageChanged(Index, Tick);
+	}
+
+	// Exchanges the packed positions of two contained entities, together with whatever derived storages keep for them
+	void SwapElements(const Type Lhs, const Type Rhs)
+	{
+		const size_type lhsIndex = GetSparseIndex(Lhs);
+		const size_type rhsIndex = GetSparseIndex(Rhs);
+		if (lhsIndex == rhsIndex)
+		{
+			return;
+		}
+
+		SwapPayloads(lhsIndex, rhsIndex);
+		SwapAt(lhsIndex, rhsIndex);
+	}
+
 protected:
+	virtual void SwapPayloads([[maybe_unused]] const size_type Lhs, [[maybe_unused]] const size_type Rhs)
+	{
+	}
+
 	virtual iterator TryAdd(const Type Entity)
 	{
 		LE_ASSERT_DESC(Entity != EcsEntityNull, "Invalid Entity")
@@ -360,11 +546,15 @@ protected:
 		{
 			LE_ASSERT_DESC(sparseElement == EcsEntityNull, "Slot is occupied")
 			Packed.push_back(Entity);
+			if (CurrentUsage == Usage::Component)
+			{
+				PushTicks(GetEcsChangeTick());
+			}
 			sparseElement = Traits::CreateCombined(static_cast<typename Traits::ValueType>(packedIndex), Traits::GetGenerationAsValue(Entity));
 		}
 		else
 		{
-			LE_ASSERT_DESC(Traits::GetId(sparseElement) < Head, "Slot is occupied")
+			LE_ASSERT_DESC(Traits::GetId(sparseElement) >= Head, "Slot is occupied")
 			UpdateGeneration(Entity);
 		}
 
@@ -397,6 +587,15 @@ protected:
 		
 	}
 
+	virtual void PopEntities(std::span<const Type> Entities)
+	{
+		for (const Type entity : Entities)
+		{
+			const iterator it = GetIterator(entity);
+			Pop(it, it + 1);
+		}
+	}
+
 	virtual void PopAll()
 	{
 		for (Type& entity : Packed)
@@ -405,6 +604,8 @@ protected:
 		}
 		Head = GetUsageHead();
 		Packed.clear();
+		Ticks.clear();
+		ChangedPageTicks.clear();
 	}
 
 	void SwapPop(const iterator Iterator)
@@ -419,8 +620,11 @@ protected:
 		Packed[deletePos] = Packed.back();
 		Packed.back() = EcsEntityNull;
 		entityToDelete = EcsEntityNull;
+		Ticks[deletePos] = Ticks.back();
+		MarkPageChanged(deletePos, Ticks[deletePos].Changed);
 
 		Packed.pop_back();
+		Ticks.pop_back();
 	}
 
 	void SwapOnly(const iterator Iterator)
@@ -433,11 +637,21 @@ protected:
 		SwapAt(idx, Head);
 	}
 
+	void ResetToEmpty()
+	{
+		ReleaseSparsePages();
+		Sparse.clear();
+		Packed.clear();
+		Ticks.clear();
+		ChangedPageTicks.clear();
+		Head = GetUsageHead();
+	}
+
 	void ReleaseSparsePages()
 	{
 		for (auto& page : Sparse)
 		{
-			free(page);
+			PageAllocator::Get().FreePage(page, Traits::PageSize);
 			page = nullptr;
 		}
 	}
@@ -452,6 +666,17 @@ protected:
 		return static_cast<size_type>(Traits::GetId(Entity));
 	}
 
+	static bool IsSparseEntryOf(const Type Entity, const Type SparseEntry) noexcept
+	{
+		constexpr typename Traits::IdType cap = Traits::IdMask; // Lower bits
+		constexpr typename Traits::ValueType generationMask = Traits::GetAsValue(EcsEntityNull) & ~cap; // To avoid shifting
+
+		auto nullCheck = generationMask & Entity;
+		auto genCheck = nullCheck ^ SparseEntry;
+
+		return genCheck < cap; // Checks that Generation bits are the same, and that the entity is not null
+	}
+
 	Type* GetSparsePointer(const Type Entity) const noexcept
 	{
 		const size_type sparseIndex = GetEntityIndex(Entity);
@@ -491,6 +716,35 @@ protected:
 		GetSparseRef(to) = Traits::CreateCombined(static_cast<typename Traits::ValueType>(Lhs), Traits::GetGenerationAsValue(to));
 
 		std::swap(from, to);
+		if (CurrentUsage == Usage::Component)
+		{
+			std::swap(Ticks[Lhs], Ticks[Rhs]);
+			MarkPageChanged(Lhs, Ticks[Lhs].Changed);
+			MarkPageChanged(Rhs, Ticks[Rhs].Changed);
+		}
+	}
+
+	void PushTicks(const EcsTick Tick)
+	{
+		Ticks.push_back({Tick, Tick});
+		if (ChangedPageTicks.size() * ChangedTickPageSize < Ticks.size())
+		{
+			ChangedPageTicks.push_back(Tick);
+		}
+		else
+		{
+			MarkPageChanged(Ticks.size() - 1, Tick);
+		}
+	}
+
+	// Components of a page can be written from several jobs at once, the page tick is only ever moved forward
+	void MarkPageChanged(const size_type Index, const EcsTick Tick) noexcept
+	{
+		std::atomic_ref<EcsTick> pageTick(ChangedPageTicks[Index / ChangedTickPageSize]);
+		if (IsEcsTickNewer(Tick, pageTick.load(std::memory_order_relaxed)))
+		{
+			pageTick.store(Tick, std::memory_order_relaxed);
+		}
 	}
 
 	Type& GetCreateSparseElement(const Type Entity)
@@ -504,7 +758,7 @@ protected:
 
 		if (!Sparse[pageIndex])
 		{
-			Sparse[pageIndex] = static_cast<Type*>(malloc(Traits::PageSize * sizeof(Type)));
+			Sparse[pageIndex] = PageAllocator::Get().AllocatePage<Type>(Traits::PageSize);
 
 			constexpr Type nullEntity = EcsEntityNull;
 			std::uninitialized_fill(Sparse[pageIndex], Sparse[pageIndex] + Traits::PageSize, nullEntity);
@@ -518,9 +772,48 @@ protected:
 		return MaxSize * static_cast<size_type>(CurrentUsage != Usage::Entity);
 	}
 
+	// Each sparse entry has to point at a packed entity with its index and generation, and each packed entity has to be reached
+	// from its own entry. Lookups of a loaded set don't check bounds, so a snapshot that breaks this is never loaded
+	bool IsSnapshotConsistent(const uint64 SnapshotHead, const std::vector<Type>& SnapshotPacked, std::span<const std::byte* const> SparsePages) const
+	{
+		const bool isHeadValid = CurrentUsage == Usage::Entity ? SnapshotHead <= SnapshotPacked.size() : SnapshotHead == GetUsageHead();
+		if (!isHeadValid || SnapshotPacked.size() > MaxSize)
+		{
+			return false;
+		}
+
+		size_type sparseEntryCount = 0;
+		for (size_type page = 0; page < SparsePages.size(); ++page)
+		{
+			for (size_type offset = 0; SparsePages[page] && offset < Traits::PageSize; ++offset)
+			{
+				// Pages sit in the snapshot at any alignment
+				Type sparseEntry;
+				std::memcpy(&sparseEntry, SparsePages[page] + offset * sizeof(Type), sizeof(Type));
+				if (sparseEntry == EcsEntityNull)
+				{
+					continue;
+				}
+
+				const size_type packedIndex = GetEntityIndex(sparseEntry);
+				if (packedIndex >= SnapshotPacked.size() || GetEntityIndex(SnapshotPacked[packedIndex]) != page * Traits::PageSize + offset
+					|| Traits::GetGeneration(SnapshotPacked[packedIndex]) != Traits::GetGeneration(sparseEntry))
+				{
+					return false;
+				}
+				++sparseEntryCount;
+			}
+		}
+
+		// Entries of different sparse slots can't point at the same packed entity, so matching counts mean every one of them is reached
+		return sparseEntryCount == SnapshotPacked.size();
+	}
+
 private:
 	std::vector<Type*> Sparse;
 	std::vector<Type> Packed;
+	std::vector<ComponentTicks> Ticks; // Parallel to Packed
+	std::vector<EcsTick> ChangedPageTicks; // Newest changed tick per ChangedTickPageSize packed positions, never fewer pages than Ticks has
 	Usage CurrentUsage;
 	size_type Head;
 };
@@ -13,6 +13,10 @@ namespace LE
 
 #define ENTITY_SPARSE_PAGE 4096
 
+#define ECS_MAX_COMPONENT_TYPES 256 // Width of the per entity component masks, multiple of 64
+
+#define CACHE_LINE_SIZE 64
+
 template <typename T>
 using UniquePtr = std::unique_ptr<T>;
 
@@ -5,6 +5,7 @@
 #include "EcsEntity.h"
 #include "EcsModule.h"
 #include "EcsObserver.h"
+#include "EcsSnapshot.h"
 
 namespace LE
 {
@@ -41,8 +42,36 @@ static bool DeleteEntityByEntityHandle(const EcsEntity Entity)
 	return false;
 }
 
+template <typename EntityIterator>
+static void CreateEntities(EntityIterator FirstEntity, EntityIterator LastEntity)
+{
+	GetECSModule().GetRegistry()->CreateEntities(FirstEntity, LastEntity);
+}
+
+template <typename EntityIterator>
+static void DeleteEntities(EntityIterator FirstEntity, EntityIterator LastEntity)
+{
+	GetECSModule().GetRegistry()->DeleteEntities(FirstEntity, LastEntity);
+}
+
+static void SaveSnapshot(EcsSnapshotWriter& Writer)
+{
+	GetECSModule().GetRegistry()->SaveSnapshot(Writer);
+}
+
+static bool LoadSnapshot(EcsSnapshotReader& Reader)
+{
+	return GetECSModule().GetRegistry()->LoadSnapshot(Reader);
+}
+
+template <typename ComponentType, typename EntityIterator>
+static void AddComponentToEntities(EntityIterator FirstEntity, EntityIterator LastEntity, const ComponentType& Component = {})
+{
+	GetECSModule().GetRegistry()->CreateComponent(FirstEntity, LastEntity, Component);
+}
+
 template <typename ComponentType, typename... ComponentArgs>
-static ComponentType& AddComponentToEntity(const EcsEntity Entity, ComponentArgs&&... Args)
+static decltype(auto) AddComponentToEntity(const EcsEntity Entity, ComponentArgs&&... Args)
 {
 	return GetECSModule().GetRegistry()->AddComponentToEntity<ComponentType>(Entity, std::forward<ComponentArgs>(Args)...);
 }
@@ -78,6 +107,22 @@ static EcsStorageView<IncludedComponentTypes<ComponentStorageForType<ComponentTy
 	return GetECSModule().GetRegistry()->View<ComponentType...>(ExcludedComponentTypes<ExcludedComponents...>{});
 }
 
+// Entities whose ChangedComponents were mutably accessed since the last run of the calling update job, e.g.
+// ViewComponents<TransformComponent, StaticMeshComponent>(Changed<TransformComponent>)
+template <typename... ComponentType, typename... ChangedComponents, typename... ExcludedComponents>
+static EcsStorageView<IncludedComponentTypes<ComponentStorageForType<ComponentType>...>, ExcludedComponentTypes<ComponentStorageForType<ExcludedComponents>...>>
+	ViewComponents(ChangedComponentTypes<ChangedComponents...>, ExcludedComponentTypes<ExcludedComponents...>  = ExcludedComponentTypes{})
+{
+	return GetECSModule().GetRegistry()->View<ComponentType...>(ChangedComponentTypes<ChangedComponents...>{}, GetSystemLastRunTick(),
+	                                                            ExcludedComponentTypes<ExcludedComponents...>{});
+}
+
+template <typename... OwnedComponents>
+static EcsGroup<ComponentStorageForType<OwnedComponents>...> GroupComponents()
+{
+	return GetECSModule().GetRegistry()->Group<OwnedComponents...>();
+}
+
 template <typename... ComponentType, typename... ExcludedComponents>
 static EcsObserver<IncludedComponentTypes<ComponentStorageForType<ComponentType>...>, ExcludedComponentTypes<ComponentStorageForType<ExcludedComponents>...>>
 	ObserveComponents(ComponentChangeType InObserverType, ExcludedComponentTypes<ExcludedComponents...> = ExcludedComponentTypes{})
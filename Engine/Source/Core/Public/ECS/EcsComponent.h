@@ -1,4 +1,9 @@
 #pragma once
+#include <array>
+#include <bit>
+#include <tuple>
+#include <type_traits>
+
 #include "CoreDefinitions.h"
 #include "Math/Math.h"
 
@@ -6,6 +11,109 @@
 namespace LE
 {
 using EcsComponentType = uint32;
+using EcsComponentIndex = uint32;
+
+// Gives the component the next dense index, registries keep their storages in an array indexed by it.
+// TypeKey tells component types apart, registering two types with the same name or with colliding name hashes is an error
+EcsComponentIndex RegisterEcsComponentType(std::string_view TypeName, EcsComponentType TypeId, const void* TypeKey);
+uint32 GetRegisteredEcsComponentCount();
+
+// Indices depend on the registration order, snapshots refer to components by their type and map them back with these
+constexpr EcsComponentIndex InvalidEcsComponentIndex = ~EcsComponentIndex{0};
+EcsComponentType GetEcsComponentType(EcsComponentIndex Index);
+EcsComponentIndex FindEcsComponentIndex(EcsComponentType TypeId); // InvalidEcsComponentIndex if the type isn't registered
+
+// Bit per component index, registries keep one for every entity
+class EcsComponentMask
+{
+	static constexpr uint32 WordCount = ECS_MAX_COMPONENT_TYPES / 64;
+	static_assert(ECS_MAX_COMPONENT_TYPES % 64 == 0, "Component mask is made of 64 bit words");
+
+public:
+	void Set(const EcsComponentIndex Index) noexcept
+	{
+		Words[Index / 64] |= uint64{1} << (Index % 64);
+	}
+
+	void Reset(const EcsComponentIndex Index) noexcept
+	{
+		Words[Index / 64] &= ~(uint64{1} << (Index % 64));
+	}
+
+	void Clear() noexcept
+	{
+		Words.fill(0u);
+	}
+
+	bool Test(const EcsComponentIndex Index) const noexcept
+	{
+		return (Words[Index / 64] & (uint64{1} << (Index % 64))) != 0u;
+	}
+
+	bool IsEmpty() const noexcept
+	{
+		for (const uint64 word : Words)
+		{
+			if (word != 0u)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool HasAll(const EcsComponentMask& Other) const noexcept
+	{
+		for (uint32 word = 0; word < WordCount; ++word)
+		{
+			if ((Words[word] & Other.Words[word]) != Other.Words[word])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool HasAny(const EcsComponentMask& Other) const noexcept
+	{
+		for (uint32 word = 0; word < WordCount; ++word)
+		{
+			if ((Words[word] & Other.Words[word]) != 0u)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	EcsComponentMask& operator|=(const EcsComponentMask& Other) noexcept
+	{
+		for (uint32 word = 0; word < WordCount; ++word)
+		{
+			Words[word] |= Other.Words[word];
+		}
+
+		return *this;
+	}
+
+	template <typename Func>
+	void ForEachIndex(Func&& Function) const
+	{
+		for (uint32 word = 0; word < WordCount; ++word)
+		{
+			for (uint64 bits = Words[word]; bits != 0; bits &= bits - 1)
+			{
+				Function(static_cast<EcsComponentIndex>(word * 64 + std::countr_zero(bits)));
+			}
+		}
+	}
+
+private:
+	std::array<uint64, WordCount> Words = {};
+};
 
 template <typename Component, typename Entity>
 struct EcsComponentTraits
@@ -16,6 +124,82 @@ struct EcsComponentTraits
 	static constexpr uint64 PageSize = ENTITY_SPARSE_PAGE;
 };
 
+// Member of a component that is stored in its own column, Offset is where it starts in the component
+template <typename InColumnType, size_t InOffset>
+struct EcsColumn
+{
+	using ColumnType = InColumnType;
+	static constexpr size_t Offset = InOffset;
+};
+
+template <typename... Columns>
+struct EcsColumnList
+{
+};
+
+// Components are stored as arrays of structs, unless columns are registered for them with ECS_REGISTER_COMPONENT_COLUMNS
+template <typename ComponentType>
+struct EcsComponentColumns
+{
+	using Type = void;
+};
+
+template <typename ComponentType, uint64 PageSize, typename Columns = typename EcsComponentColumns<ComponentType>::Type>
+struct EcsColumnLayout
+{
+	static constexpr bool IsColumnar = false;
+
+	template <size_t Column>
+	using ColumnType = void;
+};
+
+template <typename ComponentType, typename... Columns>
+constexpr bool AreEcsColumnsCoveringComponent()
+{
+	constexpr std::array<size_t, sizeof...(Columns)> offsets = {Columns::Offset...};
+	constexpr std::array<size_t, sizeof...(Columns)> sizes = {sizeof(typename Columns::ColumnType)...};
+	size_t offset = 0;
+	for (size_t column = 0; column < sizeof...(Columns); ++column)
+	{
+		if (offsets[column] != offset)
+		{
+			return false;
+		}
+		offset += sizes[column];
+	}
+	return offset == sizeof(ComponentType);
+}
+
+// Page of a columnar component holds its columns one after another, every column starts on a new cache line
+template <typename ComponentType, uint64 PageSize, typename... Columns>
+struct EcsColumnLayout<ComponentType, PageSize, EcsColumnList<Columns...>>
+{
+	static constexpr bool IsColumnar = true;
+	static constexpr size_t ColumnCount = sizeof...(Columns);
+	static constexpr std::array<size_t, ColumnCount> Offsets = {Columns::Offset...};
+	static constexpr std::array<size_t, ColumnCount> Sizes = {sizeof(typename Columns::ColumnType)...};
+
+	template <size_t Column>
+	using ColumnType = typename std::tuple_element_t<Column, std::tuple<Columns...>>::ColumnType;
+
+	static constexpr size_t GetColumnPageOffset(const size_t Column)
+	{
+		size_t offset = 0;
+		for (size_t column = 0; column < Column; ++column)
+		{
+			offset += (Sizes[column] * PageSize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+		}
+		return offset;
+	}
+
+	static constexpr size_t PageBytes = (((sizeof(typename Columns::ColumnType) * PageSize + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE) + ...);
+
+	static_assert(std::is_trivially_copyable_v<ComponentType> && (std::is_trivially_copyable_v<typename Columns::ColumnType> && ...),
+	              "Components are split into columns and put back together by copying bytes");
+	static_assert(AreEcsColumnsCoveringComponent<ComponentType, Columns...>(), "Columns have to cover the whole component in order, padding included");
+	static_assert(((alignof(typename Columns::ColumnType) <= CACHE_LINE_SIZE) && ...), "Columns can't need bigger alignment than pages have");
+};
+
 template <class ComponentType>
 struct ComponentRegistration;
 
@@ -24,12 +208,43 @@ struct ComponentTypeIdGetter
 {
 	static constexpr std::string_view TypeName = ComponentRegistration<ComponentType>::Value;
 	static constexpr EcsComponentType Value = FNV1AHash(TypeName);
+
+	// Function static, so the index is valid even when it's used by other static initializers
+	static EcsComponentIndex GetIndex()
+	{
+		static const EcsComponentIndex index = RegisterEcsComponentType(TypeName, Value, &ComponentRegistration<ComponentType>::Value);
+		return index;
+	}
 };
 
+template <typename... ComponentType>
+const EcsComponentMask& GetEcsComponentMask()
+{
+	static const EcsComponentMask mask = []
+	{
+		EcsComponentMask result;
+		(result.Set(ComponentTypeIdGetter<ComponentType>::GetIndex()), ...);
+		return result;
+	}();
+	return mask;
+}
+
+// Registers the component on startup, so hash collisions are reported even for components that are never used
 #define ECS_REGISTER_COMPONENT(ComponentType, ComponentName) \
 	template<> \
 	struct ComponentRegistration<ComponentType> \
 	{ \
 		static constexpr std::string_view Value = ComponentName; \
+		static inline const EcsComponentIndex Index = RegisterEcsComponentType(Value, FNV1AHash(Value), &Value); \
+	};
+
+// Stores the component as columns, e.g. ECS_REGISTER_COMPONENT_COLUMNS(Particle, EcsColumn<Vector3F, 0>, EcsColumn<float, 12>).
+// Loops touching only some of the members then don't pull the rest of the component into the cache. Members are accessed
+// with EachColumns of views or through EcsColumnarReference, the storage can't hand out plain references to the component
+#define ECS_REGISTER_COMPONENT_COLUMNS(ComponentType, ...) \
+	template<> \
+	struct EcsComponentColumns<ComponentType> \
+	{ \
+		using Type = EcsColumnList<__VA_ARGS__>; \
 	};
 }
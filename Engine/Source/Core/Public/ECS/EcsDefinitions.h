@@ -10,4 +10,21 @@ enum class ComponentChangeType : uint8
 	ComponentRemoved,
 	ComponentUpdated
 };
+
+using EcsTick = uint32;
+
+// Components are stamped with the current change tick when they are added or mutably accessed.
+// Every update job run advances it, so a job can tell which components changed since its previous run
+EcsTick GetEcsChangeTick();
+EcsTick AdvanceEcsChangeTick(); // Returns the tick from before the advance
+
+// Last change tick of the update job running on the calling thread, child jobs use the one of the update job that spawned them.
+// It's 0 outside of update jobs, so every component counts as changed
+EcsTick GetSystemLastRunTick();
+
+// Ticks wrap around, a tick is newer if it's less than half of the range ahead
+constexpr bool IsEcsTickNewer(const EcsTick Tick, const EcsTick SinceTick)
+{
+	return static_cast<int32>(Tick - SinceTick) > 0;
+}
 }
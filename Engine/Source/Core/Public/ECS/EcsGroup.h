@@ -0,0 +1,368 @@
+#pragma once
+#include <algorithm>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include "EcsComponent.h"
+#include "Containers/ECSStorage.h"
+#include "Templates/TypeHelpers.h"
+
+namespace LE
+{
+class EcsGroupHandlerBase
+{
+public:
+	using size_type = std::size_t;
+
+	virtual ~EcsGroupHandlerBase() = default;
+
+	size_type GetSize() const noexcept
+	{
+		return GroupSize;
+	}
+
+	const std::vector<EcsComponentType>& GetOwnedComponentTypes() const noexcept
+	{
+		return OwnedComponentTypes;
+	}
+
+	bool Owns(const EcsComponentType ComponentType) const noexcept
+	{
+		return std::find(OwnedComponentTypes.begin(), OwnedComponentTypes.end(), ComponentType) != OwnedComponentTypes.end();
+	}
+
+	// Forgets the members, so per entity signals sent while the owned storages are being replaced don't reorder them.
+	// Refresh finds the members again afterwards
+	void Reset() noexcept
+	{
+		GroupSize = 0;
+	}
+
+	// Finds the members again, for when the owned storages were replaced without per entity signals, e.g. by a snapshot
+	virtual void Refresh() = 0;
+
+protected:
+	explicit EcsGroupHandlerBase(std::vector<EcsComponentType> InOwnedComponentTypes)
+		: OwnedComponentTypes(std::move(InOwnedComponentTypes))
+		  , GroupSize(0)
+	{
+	}
+
+protected:
+	std::vector<EcsComponentType> OwnedComponentTypes;
+	size_type GroupSize; // Entities having all of the owned components, they take the first GroupSize slots of every owned storage
+};
+
+// Keeps the owned storages sorted, so entities having all owned components are packed at the front of each storage in the same order.
+// Owned storages are reordered on every add and remove, a storage can be owned by a single group only
+template <typename... OwnedStorages>
+class EcsGroupHandler : public EcsGroupHandlerBase
+{
+	using common_type = std::common_type_t<typename OwnedStorages::base_type...>;
+
+public:
+	using entity_type = typename common_type::value_type;
+
+	explicit EcsGroupHandler(OwnedStorages&... Storages)
+		: EcsGroupHandlerBase({ComponentTypeIdGetter<typename OwnedStorages::value_type>::Value...})
+		  , Storages(&Storages...)
+	{
+		std::apply([this](auto*... storage)
+		{
+			((storage->GetOnAddedSink().template Attach<&EcsGroupHandler::OnComponentAdded>(this)), ...);
+			((storage->GetOnRemovedSink().template Attach<&EcsGroupHandler::OnComponentRemoved>(this)), ...);
+		}, this->Storages);
+
+		Refresh();
+	}
+
+	EcsGroupHandler(const EcsGroupHandler&) = delete;
+	EcsGroupHandler& operator=(const EcsGroupHandler&) = delete;
+
+	~EcsGroupHandler() override
+	{
+		std::apply([this](auto*... storage)
+		{
+			((storage->GetOnAddedSink().template Detach<&EcsGroupHandler::OnComponentAdded>(this)), ...);
+			((storage->GetOnRemovedSink().template Detach<&EcsGroupHandler::OnComponentRemoved>(this)), ...);
+		}, Storages);
+	}
+
+	const std::tuple<OwnedStorages*...>& GetStorages() const noexcept
+	{
+		return Storages;
+	}
+
+	void Refresh() override
+	{
+		// Members only ever move to slots that were already visited, so a single forward pass picks up all of them
+		GroupSize = 0;
+		const common_type& firstStorage = *std::get<0>(Storages);
+		for (size_type current = 0; current < firstStorage.Count(); ++current)
+		{
+			OnComponentAdded(firstStorage.Data()[current]);
+		}
+	}
+
+	void OnComponentAdded(const entity_type Entity)
+	{
+		if (IsMember(Entity) || !std::apply([Entity](auto*... storage) { return (storage->Has(Entity) && ...); }, Storages))
+		{
+			return;
+		}
+
+		const size_type position = GroupSize++;
+		std::apply([Entity, position](auto*... storage)
+		{
+			((storage->SwapElements(storage->Data()[position], Entity)), ...);
+		}, Storages);
+	}
+
+	// Called before the component is removed, while the entity is still in every owned storage
+	void OnComponentRemoved(const entity_type Entity)
+	{
+		if (!IsMember(Entity))
+		{
+			return;
+		}
+
+		const size_type position = --GroupSize;
+		std::apply([Entity, position](auto*... storage)
+		{
+			((storage->SwapElements(storage->Data()[position], Entity)), ...);
+		}, Storages);
+	}
+
+private:
+	bool IsMember(const entity_type Entity) const noexcept
+	{
+		const common_type& firstStorage = *std::get<0>(Storages);
+		return firstStorage.Has(Entity) && firstStorage.GetSparseIndex(Entity) < GroupSize;
+	}
+
+	std::tuple<OwnedStorages*...> Storages;
+};
+
+// Entities having all of the owned components. Their components sit at the same positions of every owned storage,
+// so iterating the group is a linear walk over the component pages without sparse lookups
+template <typename... OwnedStorages>
+class EcsGroup
+{
+	using common_type = std::common_type_t<typename OwnedStorages::base_type...>;
+	using handler_type = EcsGroupHandler<OwnedStorages...>;
+
+	template <std::size_t Index>
+	using StorageTypeAt = std::tuple_element_t<Index, std::tuple<OwnedStorages...>>;
+
+	template <std::size_t Index>
+	using ComponentTypeAt = typename StorageTypeAt<Index>::value_type;
+
+public:
+	using entity_type = typename common_type::value_type;
+	using size_type = std::size_t;
+	using iterator = typename common_type::iterator;
+
+	EcsGroup() noexcept
+		: Handler(nullptr)
+	{
+	}
+
+	explicit EcsGroup(const handler_type& InHandler) noexcept
+		: Handler(&InHandler)
+	{
+	}
+
+	size_type Size() const noexcept
+	{
+		return Handler ? Handler->GetSize() : 0u;
+	}
+
+	bool IsEmpty() const noexcept
+	{
+		return Size() == 0u;
+	}
+
+	// Same order as views, from the last member to the first one
+	iterator begin() const noexcept
+	{
+		return Handler ? GetFirstStorage().end() - static_cast<typename iterator::difference_type>(Size()) : iterator{};
+	}
+
+	iterator end() const noexcept
+	{
+		return Handler ? GetFirstStorage().end() : iterator{};
+	}
+
+	bool Has(const entity_type Entity) const noexcept
+	{
+		return Handler && GetFirstStorage().Has(Entity) && GetFirstStorage().GetSparseIndex(Entity) < Size();
+	}
+
+	template <typename ComponentType>
+	auto* GetComponentStorage() const noexcept
+	{
+		return std::get<ComponentStorageIndex<ComponentType>>(Handler->GetStorages());
+	}
+
+	template <typename ComponentType, typename... OtherComponentTypes>
+	decltype(auto) GetComponents(const entity_type Entity) const
+	{
+		if constexpr (sizeof...(OtherComponentTypes) == 0)
+		{
+			return GetComponentStorage<ComponentType>()->GetComponent(Entity);
+		}
+		else
+		{
+			return std::tuple_cat(GetComponentStorage<ComponentType>()->GetComponentAsTuple(Entity),
+			                      GetComponentStorage<OtherComponentTypes>()->GetComponentAsTuple(Entity)...);
+		}
+	}
+
+	// Same as GetComponents, but the components are const and aren't marked as changed
+	template <typename ComponentType, typename... OtherComponentTypes>
+	decltype(auto) ReadComponents(const entity_type Entity) const
+	{
+		if constexpr (sizeof...(OtherComponentTypes) == 0)
+		{
+			return std::as_const(*GetComponentStorage<ComponentType>()).GetComponent(Entity);
+		}
+		else
+		{
+			return std::tuple_cat(std::as_const(*GetComponentStorage<ComponentType>()).GetComponentAsTuple(Entity),
+			                      std::as_const(*GetComponentStorage<OtherComponentTypes>()).GetComponentAsTuple(Entity)...);
+		}
+	}
+
+	// Calls Function(Entity, OwnedComponents&...) for every member, walking the component pages directly. Components taken
+	// as const references aren't marked as changed. Owned components shouldn't be added or removed meanwhile,
+	// except for removing them from the current entity
+	template <typename Func>
+	void Each(Func&& Function) const
+	{
+		EachImpl(Function, std::index_sequence_for<OwnedStorages...>{});
+	}
+
+	// Calls Function(Entities, OwnedComponentSpans...) with spans of a page at most, in the packed order. Members are at the same
+	// positions of every owned storage, so the spans line up and inner loops can be vectorised. Spans of const aren't marked as changed
+	template <typename Func>
+	void EachChunk(Func&& Function) const
+	{
+		EachChunkImpl(Function, std::index_sequence_for<OwnedStorages...>{});
+	}
+
+private:
+	static constexpr size_type PageSize = StorageTypeAt<0>::ComponentsPerPage;
+	static_assert(((OwnedStorages::ComponentsPerPage == PageSize) && ...), "Grouped components have to use the same page size");
+
+	template <typename Func, size_type... Index>
+	void EachImpl(Func& Function, std::index_sequence<Index...>) const
+	{
+		if (!Handler)
+		{
+			return;
+		}
+
+		const entity_type* entities = GetFirstStorage().Data();
+		const EcsTick changeTick = GetEcsChangeTick();
+		for (size_type pageEnd = Size(); pageEnd > 0;)
+		{
+			const size_type pageIndex = (pageEnd - 1) / PageSize;
+			const size_type pageBegin = pageIndex * PageSize;
+			const auto pages = std::make_tuple(std::get<Index>(Handler->GetStorages())->GetComponentPage(pageIndex)...);
+
+			for (size_type position = pageEnd; position-- > pageBegin;)
+			{
+				((MarkChanged<Index, !IsReadOnlyInEach<Func, Index>(std::index_sequence_for<OwnedStorages...>{})>(position, changeTick)), ...);
+				Function(entities[position], GetEachComponent<Func, Index>(std::get<Index>(pages)[position - pageBegin])...);
+			}
+
+			pageEnd = pageBegin;
+		}
+	}
+
+	template <typename Func, size_type... Index>
+	void EachChunkImpl(Func& Function, std::index_sequence<Index...>) const
+	{
+		if (!Handler)
+		{
+			return;
+		}
+
+		const entity_type* entities = GetFirstStorage().Data();
+		const EcsTick changeTick = GetEcsChangeTick();
+		for (size_type pageBegin = 0; pageBegin < Size(); pageBegin += PageSize)
+		{
+			const size_type pageIndex = pageBegin / PageSize;
+			const size_type chunkSize = Min<size_type>(PageSize, Size() - pageBegin);
+			for (size_type position = pageBegin; position < pageBegin + chunkSize; ++position)
+			{
+				((MarkChanged<Index, !IsReadOnlyInChunk<Func, Index>(std::index_sequence_for<OwnedStorages...>{})>(position, changeTick)), ...);
+			}
+
+			Function(std::span<const entity_type>(entities + pageBegin, chunkSize),
+			         GetChunkSpan<Func, Index>(std::get<Index>(Handler->GetStorages())->GetComponentPage(pageIndex), chunkSize)...);
+		}
+	}
+
+	template <size_type Index, bool IsWritten>
+	void MarkChanged(const size_type Position, const EcsTick ChangeTick) const
+	{
+		if constexpr (IsWritten)
+		{
+			std::get<Index>(Handler->GetStorages())->SetChangedTickAt(Position, ChangeTick);
+		}
+	}
+
+	template <typename Func, size_type Index>
+	static decltype(auto) GetEachComponent(ComponentTypeAt<Index>& Component)
+	{
+		if constexpr (IsReadOnlyInEach<Func, Index>(std::index_sequence_for<OwnedStorages...>{}))
+		{
+			return std::as_const(Component);
+		}
+		else
+		{
+			return (Component);
+		}
+	}
+
+	template <typename Func, size_type Index>
+	static auto GetChunkSpan(ComponentTypeAt<Index>* Page, const size_type ChunkSize)
+	{
+		if constexpr (IsReadOnlyInChunk<Func, Index>(std::index_sequence_for<OwnedStorages...>{}))
+		{
+			return std::span<const ComponentTypeAt<Index>>(Page, ChunkSize);
+		}
+		else
+		{
+			return std::span<ComponentTypeAt<Index>>(Page, ChunkSize);
+		}
+	}
+
+	// Component is read only if Function can take it as a const reference, or as a span of const
+	template <typename Func, size_type Index, size_type... Other>
+	static constexpr bool IsReadOnlyInEach(std::index_sequence<Other...>)
+	{
+		return std::is_invocable_v<Func&, entity_type, std::conditional_t<Other == Index, const ComponentTypeAt<Other>&, ComponentTypeAt<Other>&>...>;
+	}
+
+	template <typename Func, size_type Index, size_type... Other>
+	static constexpr bool IsReadOnlyInChunk(std::index_sequence<Other...>)
+	{
+		return std::is_invocable_v<Func&, std::span<const entity_type>, std::conditional_t<
+			                           Other == Index, std::span<const ComponentTypeAt<Other>>, std::span<ComponentTypeAt<Other>>>...>;
+	}
+
+	const common_type& GetFirstStorage() const noexcept
+	{
+		return *std::get<0>(Handler->GetStorages());
+	}
+
+	template <typename ComponentType>
+	static constexpr size_type ComponentStorageIndex = ComponentIndexInList<
+		ComponentType, ComponentTypeList<typename OwnedStorages::value_type...>>;
+
+	const handler_type* Handler;
+};
+}
\ No newline at end of file
@@ -1,48 +1,96 @@
 #pragma once
 #include "EcsDefinitions.h"
 #include "EcsSignals.h"
-#include <set>
-#include <map>
+#include "Containers/SparseSet.h"
+#include <span>
 
 namespace LE
 {
-template <typename Iterator, typename Entity>
-bool EachButExcludedContainerHas(Iterator FirstContainer, Iterator LastContainer, const Entity EcsEntity,
-                                 const std::unordered_map<Entity, std::set<std::size_t>>& ExcludedComponentIndices) noexcept
+// Entities recorded by an observer. Each one keeps a bit per observed component it was removed from,
+// storages of those components aren't checked when the entity is read
+template <typename Entity>
+class EcsObservedEntities : public SparseSet<Entity>
 {
-	auto begin = FirstContainer;
-	auto end = LastContainer;
+	using base_type = SparseSet<Entity>;
 
-	const auto it = ExcludedComponentIndices.find(EcsEntity);
-	if (it != ExcludedComponentIndices.end())
+public:
+	using size_type = typename base_type::size_type;
+	using iterator = typename base_type::iterator;
+
+	EcsObservedEntities()
+		: base_type(base_type::Usage::Component)
+	{
+	}
+
+	void Swap(EcsObservedEntities& Other) noexcept
+	{
+		std::swap(RemovedMasks, Other.RemovedMasks);
+		base_type::Swap(Other);
+	}
+
+	void Reserve(const uint64 Count) override
 	{
-		auto first = begin;
-		for (std::size_t index : it->second)
+		base_type::Reserve(Count);
+		RemovedMasks.reserve(static_cast<size_t>(Count));
+	}
+
+	void Record(const Entity InEntity, const uint64 RemovedMask = 0u)
+	{
+		if (!base_type::Has(InEntity))
 		{
-			auto last = begin + index;
-			if (!EachContainerHas(first, last, EcsEntity))
-			{
-				return false;
-			}
+			base_type::Add(InEntity);
+		}
 
-			if (last == end)
-			{
-				return true;
-			}
+		RemovedMasks[base_type::GetSparseIndex(InEntity)] |= RemovedMask;
+	}
 
-			first = last + 1;
+	uint64 GetRemovedMask(const Entity InEntity) const
+	{
+		return RemovedMasks[base_type::GetSparseIndex(InEntity)];
+	}
+
+	uint64 GetRemovedMaskAt(const size_type Index) const noexcept
+	{
+		return RemovedMasks[Index];
+	}
+
+protected:
+	iterator TryAdd(const Entity InEntity) override
+	{
+		RemovedMasks.push_back(0u);
+		return base_type::TryAdd(InEntity);
+	}
+
+	void Pop(const iterator Begin, const iterator End) override
+	{
+		for (iterator current = Begin; current != End; ++current)
+		{
+			RemovedMasks[base_type::GetSparseIndex(*current)] = RemovedMasks.back();
+			RemovedMasks.pop_back();
+			base_type::SwapPop(current);
 		}
+	}
 
-		return EachContainerHas(first, end, EcsEntity);
+	void PopAll() override
+	{
+		RemovedMasks.clear();
+		base_type::PopAll();
 	}
 
-	return EachContainerHas(begin, end, EcsEntity);
-}
+	void SwapPayloads(const size_type Lhs, const size_type Rhs) override
+	{
+		std::swap(RemovedMasks[Lhs], RemovedMasks[Rhs]);
+	}
+
+private:
+	std::vector<uint64> RemovedMasks; // Parallel to Packed, bit per observed storage index
+};
 
 template <typename BaseStorageType, std::size_t ObservedNumber, std::size_t FilteredNumber>
 class EcsObserverIterator
 {
-	using iterator_type = typename std::set<typename BaseStorageType::value_type>::const_iterator;
+	using entity_set_type = EcsObservedEntities<typename BaseStorageType::value_type>;
+	using iterator_type = typename entity_set_type::iterator;
 	using iterator_traits = std::iterator_traits<iterator_type>;
 
 public:
@@ -57,19 +105,17 @@ public:
 		  , LastIterator()
 		  , ObservedComponentStorages()
 		  , FilteredComponentStorages()
-		  , ExcludedComponentIndices(nullptr)
+		  , ObservedEntities(nullptr)
 	{
-		Advance();
 	}
 
 	EcsObserverIterator(iterator_type First, iterator_type Last, std::array<const BaseStorageType*, ObservedNumber> Storages,
-	                    std::array<const BaseStorageType*, FilteredNumber> ExcludedStorages,
-	                    const std::unordered_map<value_type, std::set<std::size_t>>* ExcludedIndices)
+	                    std::array<const BaseStorageType*, FilteredNumber> ExcludedStorages, const entity_set_type* Entities)
 		: Iterator(First)
 		  , LastIterator(Last)
 		  , ObservedComponentStorages(Storages)
 		  , FilteredComponentStorages(ExcludedStorages)
-		  , ExcludedComponentIndices(ExcludedIndices)
+		  , ObservedEntities(Entities)
 	{
 		Advance();
 	}
@@ -105,17 +151,19 @@ public:
 private:
 	void Advance()
 	{
-		for (; Iterator != LastIterator && !IsValid(*Iterator); ++Iterator)
+		for (; Iterator != LastIterator && !IsValid(*Iterator, ObservedEntities->GetRemovedMaskAt(Iterator.Index())); ++Iterator)
 		{
 		}
 	}
 
-	bool IsValid(const value_type Entity) const noexcept
+	bool IsValid(const value_type Entity, const uint64 RemovedMask) const noexcept
 	{
-		if (!EachButExcludedContainerHas(ObservedComponentStorages.begin(), ObservedComponentStorages.end(), Entity,
-		                                 *ExcludedComponentIndices))
+		for (std::size_t index = 0; index < ObservedNumber; ++index)
 		{
-			return false;
+			if ((RemovedMask & (uint64{1} << index)) == 0u && !ObservedComponentStorages[index]->Has(Entity))
+			{
+				return false;
+			}
 		}
 
 		if (FilteredNumber != 0u)
@@ -134,7 +182,7 @@ private:
 	iterator_type LastIterator;
 	std::array<const BaseStorageType*, ObservedNumber> ObservedComponentStorages;
 	std::array<const BaseStorageType*, FilteredNumber> FilteredComponentStorages;
-	const std::unordered_map<value_type, std::set<std::size_t>>* ExcludedComponentIndices;
+	const entity_set_type* ObservedEntities;
 };
 
 template <typename LhsType, auto... LhsArgs, typename RhsType, auto... RhsArgs>
@@ -154,6 +202,8 @@ template <typename LhsType, auto... LhsArgs, typename RhsType, auto... RhsArgs>
 template <typename BaseStorageType, std::size_t ObservedNumber, std::size_t FilteredNumber>
 class EcsObserverBase
 {
+	static_assert(ObservedNumber <= 64, "Removed components of an entity are kept as a 64 bit mask");
+
 public:
 	using base_storage_type = BaseStorageType;
 	using entity_type = typename BaseStorageType::value_type;
@@ -163,7 +213,7 @@ public:
 
 	size_type Count() const noexcept
 	{
-		return ObservedEntities.size();
+		return ObservedEntities.Count();
 	}
 
 	bool IsEmpty() const noexcept
@@ -173,23 +223,21 @@ public:
 
 	bool Has(entity_type Entity) const noexcept
 	{
-		if (!ObservedEntities.contains(Entity))
+		if (!ObservedEntities.Has(Entity))
 		{
 			return false;
 		}
 
-		if (!EachButExcludedContainerHas(ObservedComponentStorages.begin(), ObservedComponentStorages.end(), Entity,
-		                                 ExcludedComponentIndices))
+		const uint64 removedMask = ObservedEntities.GetRemovedMask(Entity);
+		for (size_type index = 0; index < ObservedNumber; ++index)
 		{
-			return false;
-		}
-
-		if (!NoneOfContainersHas(FilteredComponentStorages.begin(), FilteredComponentStorages.end(), Entity))
-		{
-			return false;
+			if ((removedMask & (uint64{1} << index)) == 0u && !ObservedComponentStorages[index]->Has(Entity))
+			{
+				return false;
+			}
 		}
 
-		return true;
+		return NoneOfContainersHas(FilteredComponentStorages.begin(), FilteredComponentStorages.end(), Entity);
 	}
 
 	iterator begin() const noexcept
@@ -199,7 +247,7 @@ public:
 			return {};
 		}
 
-		return {ObservedEntities.begin(), ObservedEntities.end(), ObservedComponentStorages, FilteredComponentStorages, &ExcludedComponentIndices};
+		return {ObservedEntities.begin(), ObservedEntities.end(), ObservedComponentStorages, FilteredComponentStorages, &ObservedEntities};
 	}
 
 	iterator end() const noexcept
@@ -209,13 +257,12 @@ public:
 			return {};
 		}
 
-		return {ObservedEntities.end(), ObservedEntities.end(), ObservedComponentStorages, FilteredComponentStorages, &ExcludedComponentIndices};
+		return {ObservedEntities.end(), ObservedEntities.end(), ObservedComponentStorages, FilteredComponentStorages, &ObservedEntities};
 	}
 
 	void ResetObservedEntities()
 	{
-		ObservedEntities.clear();
-		ExcludedComponentIndices.clear();
+		ObservedEntities.Clear();
 	}
 
 	void Swap(EcsObserverBase& Other)
@@ -223,13 +270,14 @@ public:
 		std::swap(ObserverType, Other.ObserverType);
 		std::swap(ObservedComponentStorages, Other.ObservedComponentStorages);
 		std::swap(FilteredComponentStorages, Other.FilteredComponentStorages);
-		std::swap(ObservedEntities, Other.ObservedEntities);
-		std::swap(ExcludedComponentIndices, Other.ExcludedComponentIndices);
+		ObservedEntities.Swap(Other.ObservedEntities);
+		std::swap(CollectedTick, Other.CollectedTick);
 	}
 
 protected:
 	EcsObserverBase() noexcept
 		: ObserverType(ComponentChangeType::None)
+		  , CollectedTick(0u)
 	{
 	}
 
@@ -238,6 +286,7 @@ protected:
 		: ObserverType(InType)
 		  , ObservedComponentStorages(ObservedStorages)
 		  , FilteredComponentStorages(FilteredStorages)
+		  , CollectedTick(InType == ComponentChangeType::ComponentUpdated ? AdvanceEcsChangeTick() : 0u) // Earlier changes aren't observed
 	{
 	}
 
@@ -250,8 +299,8 @@ protected:
 	ComponentChangeType ObserverType;
 	std::array<const BaseStorageType*, ObservedNumber> ObservedComponentStorages;
 	std::array<const BaseStorageType*, FilteredNumber> FilteredComponentStorages;
-	std::set<entity_type> ObservedEntities;
-	std::unordered_map<entity_type, std::set<size_type>> ExcludedComponentIndices;
+	EcsObservedEntities<entity_type> ObservedEntities;
+	EcsTick CollectedTick; // Updated components are only collected if they changed after it
 };
 
 template <typename, typename>
@@ -337,19 +386,77 @@ public:
 		}
 	}
 
+	// Same as GetComponents, but the components are const and aren't marked as changed
+	template <typename ComponentType, typename... OtherComponentTypes>
+	decltype(auto) ReadComponents(const entity_type Entity) const
+	{
+		if constexpr (sizeof...(OtherComponentTypes) == 0)
+		{
+			return std::as_const(*GetComponentStorage<ComponentType>()).GetComponent(Entity);
+		}
+		else
+		{
+			return std::tuple_cat(std::as_const(*GetComponentStorage<ComponentType>()).GetComponentAsTuple(Entity),
+			                      std::as_const(*GetComponentStorage<OtherComponentTypes>()).GetComponentAsTuple(Entity)...);
+		}
+	}
+
+	// Updated components aren't signaled, mutable access only bumps their change ticks. Observers of updates pick up
+	// the entities changed since the previous call, so it has to be called before the observer is read.
+	// Components added since the previous call aren't updates, even if they were changed after being added
+	void CollectUpdatedEntities()
+	{
+		if (this->ObserverType != ComponentChangeType::ComponentUpdated)
+		{
+			return;
+		}
+
+		// Changes made from now on are stamped with a newer tick, so they are picked up by the next call
+		const EcsTick sinceTick = std::exchange(this->CollectedTick, AdvanceEcsChangeTick());
+		constexpr size_type pageSize = common_type::ChangedTickPageSize;
+		for (const common_type* storage : this->ObservedComponentStorages)
+		{
+			const entity_type* entities = storage->Data();
+			const size_type count = storage->Count();
+			for (size_type pageBegin = 0; pageBegin < count; pageBegin += pageSize)
+			{
+				// Pages nothing was written to since the previous call are skipped as a whole
+				if (!IsEcsTickNewer(storage->GetChangedPageTickAt(pageBegin), sinceTick))
+				{
+					continue;
+				}
+
+				const size_type pageEnd = Min<size_type>(pageBegin + pageSize, count);
+				for (size_type current = pageBegin; current < pageEnd; ++current)
+				{
+					if (IsEcsTickNewer(storage->GetChangedTickAt(current), sinceTick) && !IsEcsTickNewer(storage->GetAddedTickAt(current), sinceTick))
+					{
+						this->ObservedEntities.Record(entities[current]);
+					}
+				}
+			}
+		}
+	}
+
 	template <std::size_t Index>
-	void OnStorageChange(const entity_type Entity)
+	void OnStorageChange(std::span<const entity_type> Entities)
 	{
-		this->ObservedEntities.insert(Entity);
-		if (this->ObserverType == ComponentChangeType::ComponentRemoved)
+		const uint64 removedMask = this->ObserverType == ComponentChangeType::ComponentRemoved ? uint64{1} << Index : 0u;
+		for (const entity_type entity : Entities)
 		{
-			this->ExcludedComponentIndices[Entity].insert(Index);
+			this->ObservedEntities.Record(entity, removedMask);
 		}
 	}
 
-	void OnFromStorageRemoved(const entity_type Entity)
+	void OnFromStorageRemoved(std::span<const entity_type> Entities)
 	{
-		this->ObservedEntities.erase(Entity);
+		for (const entity_type entity : Entities)
+		{
+			if (this->ObservedEntities.Has(entity))
+			{
+				this->ObservedEntities.Delete(entity);
+			}
+		}
 	}
 
 private:
@@ -370,27 +477,29 @@ private:
 		switch (this->ObserverType)
 		{
 		case ComponentChangeType::ComponentAdded:
-			((ComponentsSinks.emplace_back((*GetComponentStorage<typename Components::value_type>()).GetOnAddedSink())),
+			((ComponentsSinks.emplace_back((*GetComponentStorage<typename Components::value_type>()).GetOnBatchAddedSink())),
 				...);
 			break;
 		case ComponentChangeType::ComponentRemoved:
-			((ComponentsSinks.emplace_back((*GetComponentStorage<typename Components::value_type>()).GetOnRemovedSink()))
+			((ComponentsSinks.emplace_back((*GetComponentStorage<typename Components::value_type>()).GetOnBatchRemovedSink()))
 				, ...);
 			break;
 		case ComponentChangeType::ComponentUpdated:
-			((ComponentsSinks.emplace_back((*GetComponentStorage<typename Components::value_type>()).GetOnUpdatedSink()))
-				, ...);
+			// Collected from the change ticks, see CollectUpdatedEntities
 			break;
 		case ComponentChangeType::None:
 			LE_ASSERT_DESC(false, "Uninitialized Ecs Observer")
 			break;
 		}
 
-		((SubscribeStorage<ComponentStorageIndex<typename Components::value_type>>()), ...);
+		if (!ComponentsSinks.empty())
+		{
+			((SubscribeStorage<ComponentStorageIndex<typename Components::value_type>>()), ...);
+		}
 
 		if (this->ObserverType != ComponentChangeType::ComponentRemoved)
 		{
-			((RemovedSinks.emplace_back((*GetComponentStorage<typename Components::value_type>()).GetOnRemovedSink())),
+			((RemovedSinks.emplace_back((*GetComponentStorage<typename Components::value_type>()).GetOnBatchRemovedSink())),
 				...);
 			for (auto& sink : RemovedSinks)
 			{
@@ -422,7 +531,7 @@ private:
 	static constexpr size_type ComponentStorageIndex = ComponentIndexInList<
 		ComponentType, ComponentTypeList<typename Components::value_type...>>;
 
-	std::vector<Sink<Signal<void(const entity_type)>>> ComponentsSinks;
-	std::vector<Sink<Signal<void(const entity_type)>>> RemovedSinks;
+	std::vector<Sink<Signal<void(std::span<const entity_type>)>>> ComponentsSinks;
+	std::vector<Sink<Signal<void(std::span<const entity_type>)>>> RemovedSinks;
 };
 }
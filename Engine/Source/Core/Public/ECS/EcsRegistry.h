@@ -2,7 +2,9 @@
 #include <algorithm>
 
 #include "EcsDefinitions.h"
+#include "EcsGroup.h"
 #include "EcsObserver.h"
+#include "EcsSnapshot.h"
 #include "EcsStorageView.h"
 #include "Containers/ECSStorage.h"
 #include "Containers/SparseSet.h"
@@ -18,20 +20,22 @@ public:
 	using size_type = std::size_t;
 
 	EcsRegistry()
-		: EcsRegistry(0)
+		: EcsRegistry(GetRegisteredEcsComponentCount())
 	{
 	}
 
 	EcsRegistry(const size_type ComponentTypeCount)
 	{
-		ComponentStorages.reserve(ComponentTypeCount);
+		ComponentStorages.resize(ComponentTypeCount);
 	}
 
 	EcsRegistry(const EcsRegistry&) = delete;
 
 	EcsRegistry(EcsRegistry&& Other) noexcept
 		: EntityStorage(std::move(Other.EntityStorage))
+		  , ComponentMasks(std::move(Other.ComponentMasks))
 		  , ComponentStorages(std::move(Other.ComponentStorages))
+		  , Groups(std::move(Other.Groups))
 	{
 	}
 
@@ -48,7 +52,9 @@ public:
 	void Swap(EcsRegistry& Other) noexcept
 	{
 		std::swap(EntityStorage, Other.EntityStorage);
+		std::swap(ComponentMasks, Other.ComponentMasks);
 		std::swap(ComponentStorages, Other.ComponentStorages);
+		std::swap(Groups, Other.Groups);
 	}
 
 	bool IsEntityValid(const Entity EcsEntity)
@@ -58,26 +64,76 @@ public:
 
 	Entity CreateEntity()
 	{
-		return EntityStorage.CreateEntity();
+		const Entity entity = EntityStorage.CreateEntity();
+		ReserveComponentMasks(entity);
+		return entity;
 	}
 
+	// Only the storages the entity has a component in are touched
 	void DeleteEntity(const Entity EcsEntity)
 	{
 		LE_ASSERT_DESC(IsEntityValid(EcsEntity), "Attempting to delete an invalid Entity")
-		for (auto& storage : ComponentStorages)
+		// Removed listeners still see the mask of the entity, it's cleared once every component is gone
+		const EcsComponentMask ownedComponents = GetComponentMask(EcsEntity);
+		ownedComponents.ForEachIndex([this, EcsEntity](const EcsComponentIndex ComponentIndex)
 		{
-			if (storage.second->Has(EcsEntity))
+			ComponentStorages[ComponentIndex]->Delete(EcsEntity);
+		});
+		GetComponentMask(EcsEntity).Clear();
+		return EntityStorage.Delete(EcsEntity);
+	}
+
+	template <typename EntityIterator>
+	void CreateEntities(EntityIterator FirstEntity, EntityIterator LastEntity)
+	{
+		EntityStorage.CreateEntities(FirstEntity, LastEntity);
+		if (FirstEntity != LastEntity)
+		{
+			ReserveComponentMasks(*std::max_element(FirstEntity, LastEntity, [](const Entity Lhs, const Entity Rhs)
 			{
-				storage.second->Delete(EcsEntity);
-			}
+				return EcsTraits<Entity>::GetId(Lhs) < EcsTraits<Entity>::GetId(Rhs);
+			}));
+		}
+	}
+
+	// Every storage is visited once, its batch listeners get all of the deleted entities that had the component in one call
+	template <typename EntityIterator>
+	void DeleteEntities(EntityIterator FirstEntity, EntityIterator LastEntity)
+	{
+		LE_ASSERT_DESC(std::all_of(FirstEntity, LastEntity, [this](const Entity EcsEntity) { return IsEntityValid(EcsEntity); }),
+		               "Attempting to delete an invalid Entity")
+
+		EcsComponentMask ownedComponents;
+		for (EntityIterator current = FirstEntity; current != LastEntity; ++current)
+		{
+			ownedComponents |= GetComponentMask(*current);
+		}
+
+		std::vector<Entity> storageEntities;
+		storageEntities.reserve(static_cast<size_type>(std::distance(FirstEntity, LastEntity)));
+		ownedComponents.ForEachIndex([&](const EcsComponentIndex ComponentIndex)
+		{
+			storageEntities.clear();
+			std::copy_if(FirstEntity, LastEntity, std::back_inserter(storageEntities), [this, ComponentIndex](const Entity EcsEntity)
+			{
+				return GetComponentMask(EcsEntity).Test(ComponentIndex);
+			});
+			ComponentStorages[ComponentIndex]->Delete(std::span<const Entity>(storageEntities));
+		});
+
+		for (EntityIterator current = FirstEntity; current != LastEntity; ++current)
+		{
+			GetComponentMask(*current).Clear();
+			EntityStorage.Delete(*current);
 		}
-		return EntityStorage.Delete(EcsEntity);
 	}
 
 	template <typename ComponentType, typename... ComponentArgs>
-	ComponentType& AddComponentToEntity(const Entity EcsEntity, ComponentArgs&&... Args)
+	decltype(auto) AddComponentToEntity(const Entity EcsEntity, ComponentArgs&&... Args)
 	{
 		LE_ASSERT_DESC(IsEntityValid(EcsEntity), "Attempting to add component to an invalid Entity")
+		// Set before the storage notifies its listeners
+		GetComponentMask(EcsEntity).Set(ComponentTypeIdGetter<ComponentType>::GetIndex());
 		return GetCreateComponentStorage<ComponentType>().CreateComponent(EcsEntity, std::forward<ComponentArgs>(Args)...);
 	}
 
@@ -87,6 +143,7 @@ public:
 		LE_ASSERT_DESC(std::all_of(FirstEntity, LastEntity, [this](const Entity EcsEntity) { return IsEntityValid(EcsEntity); }),
 		               "Attempting to add component to an invalid Entity")
 
+		SetComponentMasks<ComponentType>(FirstEntity, LastEntity);
 		GetCreateComponentStorage<ComponentType>().CreateComponent(FirstEntity, LastEntity, Component);
 	}
 
@@ -97,30 +154,32 @@ public:
 		LE_ASSERT_DESC(std::all_of(FirstEntity, LastEntity, [this](const Entity EcsEntity) { return IsEntityValid(EcsEntity); }),
 		               "Attempting to add component to an invalid Entity")
 
-		GetCreateComponentStorage<ComponentType>().CreateComponent(FirstEntity, LastEntity, FirstComponent);
+		SetComponentMasks<ComponentType>(FirstEntity, LastEntity);
+		GetCreateComponentStorage<ComponentType>().CreateComponents(FirstEntity, LastEntity, FirstComponent);
 	}
 
 	template <typename ComponentType, typename... ComponentArgs>
-	ComponentType& AddReplaceComponentToEntity(const Entity EcsEntity, ComponentArgs&&... Args)
+	decltype(auto) AddReplaceComponentToEntity(const Entity EcsEntity, ComponentArgs&&... Args)
 	{
 		LE_ASSERT_DESC(IsEntityValid(EcsEntity), "Attempting to add component to an invalid Entity")
 
 		EcsComponentStorage<ComponentType, Entity>& storage = GetCreateComponentStorage<ComponentType>();
 		if (storage.Has(EcsEntity))
 		{
-			return storage.RunOnComponent([&Args...](auto&... current)
+			return storage.RunOnComponent(EcsEntity, [&Args...](auto& current)
 			{
-				((current = ComponentType{std::forward<ComponentArgs>(Args)...}), ...);
+				current = ComponentType{std::forward<ComponentArgs>(Args)...};
 			});
 		}
 		else
 		{
+			GetComponentMask(EcsEntity).Set(ComponentTypeIdGetter<ComponentType>::GetIndex());
 			return storage.CreateComponent(EcsEntity, std::forward<ComponentArgs>(Args)...);
 		}
 	}
 
 	template <typename ComponentType, typename... Func>
-	ComponentType& RunOnComponent(const Entity EcsEntity, Func&&... InFunc)
+	decltype(auto) RunOnComponent(const Entity EcsEntity, Func&&... InFunc)
 	{
 		LE_ASSERT_DESC(IsEntityValid(EcsEntity), "Invalid Entity")
 		return GetCreateComponentStorage<ComponentType>().RunOnComponent(EcsEntity, std::forward<Func>(InFunc)...);
@@ -131,24 +190,22 @@ public:
 	{
 		(GetCreateComponentStorage<ComponentType>().Delete(EcsEntity), (GetCreateComponentStorage<OtherComponents>().Delete(EcsEntity), ...
 		));
+		// Cleared after the removal, so removed listeners still see the components
+		EcsComponentMask& componentMask = GetComponentMask(EcsEntity);
+		componentMask.Reset(ComponentTypeIdGetter<ComponentType>::GetIndex());
+		(componentMask.Reset(ComponentTypeIdGetter<OtherComponents>::GetIndex()), ...);
 	}
 
 	template <typename... ComponentType>
 	bool HasAllComponents(const Entity EcsEntity) const
 	{
-		if constexpr (sizeof...(ComponentType) == 1u)
-		{
-			auto* storage = GetComponentStorage<ComponentType...>();
-			return storage && storage->Has(EcsEntity);
-		}
-
-		return (HasAllComponents<ComponentType>(EcsEntity) && ...);
+		return EntityStorage.Has(EcsEntity) && GetComponentMask(EcsEntity).HasAll(GetEcsComponentMask<ComponentType...>());
 	}
 
 	template <typename... ComponentType>
 	bool HasAnyComponents(const Entity EcsEntity) const
 	{
-		return (HasAllComponents<ComponentType>() || ...);
+		return EntityStorage.Has(EcsEntity) && GetComponentMask(EcsEntity).HasAny(GetEcsComponentMask<ComponentType...>());
 	}
 
 	template <typename... ComponentType>
@@ -158,8 +215,25 @@ public:
 		{
 			return (GetComponentStorage<ComponentType>()->GetComponent(EcsEntity), ...);
 		}
+		else
+		{
+			// Components stored in columns are returned as EcsColumnarReference values, they can't be forwarded as references
+			return std::tuple<decltype(GetComponent<ComponentType>(EcsEntity))...>(GetComponent<ComponentType>(EcsEntity)...);
+		}
+	}
 
-		return std::forward_as_tuple(GetComponent<ComponentType>(EcsEntity)...);
+	// Marks the components as changed, use the const overload to only read them
+	template <typename... ComponentType>
+	decltype(auto) GetComponent(const Entity EcsEntity)
+	{
+		if constexpr (sizeof...(ComponentType) == 1u)
+		{
+			return (GetCreateComponentStorage<ComponentType>().GetComponent(EcsEntity), ...);
+		}
+		else
+		{
+			return std::tuple<decltype(GetComponent<ComponentType>(EcsEntity))...>(GetComponent<ComponentType>(EcsEntity)...);
+		}
 	}
 
 	template <typename... ComponentType, typename... ExcludedComponents>
@@ -170,6 +244,44 @@ public:
 		return { GetCreateComponentStorage<ComponentType>()..., GetCreateComponentStorage<ExcludedComponents>()... };
 	}
 
+	// Only entities whose ChangedComponents were mutably accessed after SinceTick
+	template <typename... ComponentType, typename... ChangedComponents, typename... ExcludedComponents>
+	EcsStorageView<IncludedComponentTypes<EcsComponentStorage<ComponentType, Entity>...>, ExcludedComponentTypes<EcsComponentStorage<
+		               ExcludedComponents, Entity>...>>
+	View(ChangedComponentTypes<ChangedComponents...>, const EcsTick SinceTick,
+	     ExcludedComponentTypes<ExcludedComponents...>  = ExcludedComponentTypes{})
+	{
+		auto view = View<ComponentType...>(ExcludedComponentTypes<ExcludedComponents...>{});
+		view.template FilterChanged<ChangedComponents...>(SinceTick);
+		return view;
+	}
+
+	// Owning group of the components, created on first use. Owned storages are kept sorted for the group,
+	// so a component can only be owned by one group, views over it keep working as before
+	template <typename... OwnedComponents>
+	EcsGroup<EcsComponentStorage<OwnedComponents, Entity>...> Group()
+	{
+		static_assert(sizeof...(OwnedComponents) > 1u, "A single component storage is already packed, use View instead");
+		using HandlerType = EcsGroupHandler<EcsComponentStorage<OwnedComponents, Entity>...>;
+
+		const std::vector<EcsComponentType> ownedTypes = {ComponentTypeIdGetter<OwnedComponents>::Value...};
+		for (const UniquePtr<EcsGroupHandlerBase>& group : Groups)
+		{
+			if (group->GetOwnedComponentTypes() == ownedTypes)
+			{
+				return EcsGroup<EcsComponentStorage<OwnedComponents, Entity>...>(static_cast<const HandlerType&>(*group));
+			}
+
+			LE_ASSERT_DESC(std::none_of(ownedTypes.begin(), ownedTypes.end(), [&group](const EcsComponentType ComponentType)
+			               {
+				               return group->Owns(ComponentType);
+			               }), "Component is already owned by another group")
+		}
+
+		Groups.push_back(std::make_unique<HandlerType>(GetCreateComponentStorage<OwnedComponents>()...));
+		return EcsGroup<EcsComponentStorage<OwnedComponents, Entity>...>(static_cast<const HandlerType&>(*Groups.back()));
+	}
+
 	template<typename ComponentType>
 	auto GetOnAddedSink()
 	{
@@ -183,9 +295,15 @@ public:
 	}
 
 	template<typename ComponentType>
-	auto GetOnUpdatedSink()
+	auto GetOnBatchAddedSink()
 	{
-		return GetCreateComponentStorage<ComponentType>().GetOnUpdatedSink();
+		return GetCreateComponentStorage<ComponentType>().GetOnBatchAddedSink();
+	}
+
+	template<typename ComponentType>
+	auto GetOnBatchRemovedSink()
+	{
+		return GetCreateComponentStorage<ComponentType>().GetOnBatchRemovedSink();
 	}
 
 	template <typename... ComponentType, typename... ExcludedComponents>
@@ -196,44 +314,220 @@ public:
 		return { InType , GetCreateComponentStorage<ComponentType>()..., GetCreateComponentStorage<ExcludedComponents>()... };
 	}
 
+	// Bytes SaveSnapshot writes, components written by serializers are counted as their in-memory size
+	uint64 GetSnapshotSize() const
+	{
+		uint64 size = sizeof(EcsSnapshotHeader) + EntityStorage.GetSnapshotSize() + sizeof(uint64) + ComponentMasks.size() * sizeof(EcsComponentMask)
+			+ sizeof(uint32);
+		for (const UniquePtr<SparseSet<Entity>>& storage : ComponentStorages)
+		{
+			if (storage)
+			{
+				size += sizeof(EcsComponentType) + sizeof(EcsComponentIndex) + storage->GetSnapshotSize();
+			}
+		}
+		return size;
+	}
+
+	// Writes the entities, their component masks and every component storage, mostly as raw blocks of the storage arrays.
+	// Groups and observers aren't part of it, they keep following the storages
+	void SaveSnapshot(EcsSnapshotWriter& Writer) const
+	{
+		// Writers that grow while the snapshot is written copy it several times, and the first snapshot into a new buffer
+		// spent most of its time on that
+		Writer.ReserveForWrite(static_cast<size_t>(GetSnapshotSize()));
+
+		EcsSnapshotHeader header;
+		header.EntitySize = sizeof(Entity);
+		header.ComponentMaskSize = sizeof(EcsComponentMask);
+		Writer.WriteValue(header);
+		EntityStorage.SaveSnapshot(Writer);
+		Writer.WriteArray(std::span<const EcsComponentMask>(ComponentMasks));
+
+		const uint32 storageCount = static_cast<uint32>(std::count_if(ComponentStorages.begin(), ComponentStorages.end(),
+		                                                              [](const UniquePtr<SparseSet<Entity>>& Storage) { return Storage != nullptr; }));
+		Writer.WriteValue(storageCount);
+		for (EcsComponentIndex componentIndex = 0; componentIndex < ComponentStorages.size(); ++componentIndex)
+		{
+			if (ComponentStorages[componentIndex])
+			{
+				// Indices depend on the registration order, the type is what identifies the storage in another run
+				Writer.WriteValue(GetEcsComponentType(componentIndex));
+				Writer.WriteValue(componentIndex);
+				ComponentStorages[componentIndex]->SaveSnapshot(Writer);
+			}
+		}
+	}
+
+	// Puts the registry back to the snapshot. Every storage is replaced as a whole and its batch listeners are called once with
+	// the removed and once with the loaded entities, per entity signals aren't sent. Groups find their members again afterwards.
+	// Returns false if the snapshot is broken or has components this build doesn't know, the registry is left empty then
+	bool LoadSnapshot(EcsSnapshotReader& Reader)
+	{
+		// Storages cleared below send per entity removed signals, groups mustn't act on members of the storages being replaced
+		for (const UniquePtr<EcsGroupHandlerBase>& group : Groups)
+		{
+			group->Reset();
+		}
+
+		EcsSnapshotHeader header;
+		bool isLoaded = Reader.ReadValue(header) && header.Magic == EcsSnapshotHeader::CurrentMagic && header.Version == EcsSnapshotHeader::CurrentVersion
+			&& header.EntitySize == sizeof(Entity) && header.ComponentMaskSize == sizeof(EcsComponentMask)
+			&& EntityStorage.LoadSnapshot(Reader) && Reader.ReadArray(ComponentMasks);
+
+		uint32 storageCount = 0;
+		isLoaded = isLoaded && Reader.ReadValue(storageCount);
+
+		std::vector<bool> loadedStorages(ComponentStorages.size(), false);
+		bool areIndicesSame = true;
+		for (uint32 storage = 0; isLoaded && storage < storageCount; ++storage)
+		{
+			EcsComponentType componentType = 0;
+			EcsComponentIndex savedIndex = 0;
+			const EcsComponentIndex componentIndex = Reader.ReadValue(componentType) && Reader.ReadValue(savedIndex)
+				                                         ? FindEcsComponentIndex(componentType)
+				                                         : InvalidEcsComponentIndex;
+			SparseSet<Entity>* componentStorage = componentIndex != InvalidEcsComponentIndex ? GetCreateComponentStorageAt(componentIndex) : nullptr;
+			isLoaded = componentStorage && componentStorage->LoadSnapshot(Reader);
+			if (isLoaded)
+			{
+				loadedStorages.resize(ComponentStorages.size(), false);
+				loadedStorages[componentIndex] = true;
+				areIndicesSame &= componentIndex == savedIndex;
+			}
+		}
+
+		// Storages the snapshot doesn't have were empty when it was taken
+		for (EcsComponentIndex componentIndex = 0; componentIndex < ComponentStorages.size(); ++componentIndex)
+		{
+			if (ComponentStorages[componentIndex] && (!isLoaded || !loadedStorages[componentIndex]))
+			{
+				ComponentStorages[componentIndex]->Clear();
+			}
+		}
+
+		if (!isLoaded)
+		{
+			EntityStorage.Clear();
+			ComponentMasks.clear();
+		}
+		else if (!areIndicesSame)
+		{
+			RebuildComponentMasks();
+		}
+
+		for (const UniquePtr<EcsGroupHandlerBase>& group : Groups)
+		{
+			group->Refresh();
+		}
+
+		return isLoaded;
+	}
+
 private:
+	EcsComponentMask& GetComponentMask(const Entity EcsEntity)
+	{
+		return ComponentMasks[EcsTraits<Entity>::GetId(EcsEntity)];
+	}
+
+	const EcsComponentMask& GetComponentMask(const Entity EcsEntity) const
+	{
+		return ComponentMasks[EcsTraits<Entity>::GetId(EcsEntity)];
+	}
+
+	void ReserveComponentMasks(const Entity LastEntity)
+	{
+		const size_type maskCount = static_cast<size_type>(EcsTraits<Entity>::GetId(LastEntity)) + 1;
+		if (ComponentMasks.size() < maskCount)
+		{
+			ComponentMasks.resize(maskCount);
+		}
+	}
+
+	// Masks of a snapshot taken by a build that registered the components in another order
+	void RebuildComponentMasks()
+	{
+		for (EcsComponentMask& componentMask : ComponentMasks)
+		{
+			componentMask.Clear();
+		}
+
+		for (EcsComponentIndex componentIndex = 0; componentIndex < ComponentStorages.size(); ++componentIndex)
+		{
+			if (const SparseSet<Entity>* storage = ComponentStorages[componentIndex].get())
+			{
+				for (const Entity entity : std::span<const Entity>(storage->Data(), storage->Count()))
+				{
+					GetComponentMask(entity).Set(componentIndex);
+				}
+			}
+		}
+	}
+
+	template <typename ComponentType, typename EntityIterator>
+	void SetComponentMasks(EntityIterator FirstEntity, EntityIterator LastEntity)
+	{
+		const EcsComponentIndex componentIndex = ComponentTypeIdGetter<ComponentType>::GetIndex();
+		for (EntityIterator current = FirstEntity; current != LastEntity; ++current)
+		{
+			GetComponentMask(*current).Set(componentIndex);
+		}
+	}
+
 	template <typename ComponentType>
-	EcsComponentStorage<ComponentType, Entity>& GetCreateComponentStorage(
-		EcsComponentType ComponentTypeId = ComponentTypeIdGetter<ComponentType>::Value)
+	EcsComponentStorage<ComponentType, Entity>& GetCreateComponentStorage()
 	{
 		static_assert(!std::is_same_v<ComponentType, Entity>, "Attempting to pass Entity as Component");
 		using ComponentStorageType = EcsComponentStorage<ComponentType, Entity>;
 
-		auto it = ComponentStorages.find(ComponentTypeId);
-		if (it != ComponentStorages.cend())
+		const EcsComponentIndex componentIndex = ComponentTypeIdGetter<ComponentType>::GetIndex();
+		if (componentIndex >= ComponentStorages.size())
 		{
-			return static_cast<ComponentStorageType&>(*it->second);
+			// Components registered after the registry was created, e.g. by modules loaded later
+			ComponentStorages.resize(Max<size_type>(componentIndex + 1, GetRegisteredEcsComponentCount()));
 		}
 
-		std::shared_ptr<SparseSet<Entity>> storage = std::make_shared<ComponentStorageType>();
-		ComponentStorages.emplace(ComponentTypeId, storage);
+		UniquePtr<SparseSet<Entity>>& storage = ComponentStorages[componentIndex];
+		if (!storage)
+		{
+			storage = std::make_unique<ComponentStorageType>();
+		}
 
 		return static_cast<ComponentStorageType&>(*storage);
 	}
 
-	template <typename ComponentType>
-	const EcsComponentStorage<ComponentType, Entity>& GetComponentStorage(
-		EcsComponentType ComponentTypeId = ComponentTypeIdGetter<ComponentType>::Value) const
+	// Storage of a component that may not have been used by this registry yet, null if the component never had a storage in this build
+	SparseSet<Entity>* GetCreateComponentStorageAt(const EcsComponentIndex ComponentIndex)
 	{
-		static_assert(!std::is_same_v<ComponentType, Entity>, "Attempting to pass Entity as Component");
-		using ComponentStorageType = EcsComponentStorage<ComponentType, Entity>;
+		if (ComponentIndex >= ComponentStorages.size())
+		{
+			ComponentStorages.resize(Max<size_type>(ComponentIndex + 1, GetRegisteredEcsComponentCount()));
+		}
 
-		auto it = ComponentStorages.find(ComponentTypeId);
-		if (it != ComponentStorages.cend())
+		UniquePtr<SparseSet<Entity>>& storage = ComponentStorages[ComponentIndex];
+		const std::vector<EcsComponentStorageFactory<Entity>>& factories = GetEcsComponentStorageFactories<Entity>();
+		if (!storage && ComponentIndex < factories.size() && factories[ComponentIndex])
 		{
-			return static_cast<ComponentStorageType&>(*it->second);
+			storage = factories[ComponentIndex]();
 		}
 
-		return nullptr;
+		return storage.get();
+	}
+
+	template <typename ComponentType>
+	const EcsComponentStorage<ComponentType, Entity>* GetComponentStorage() const
+	{
+		static_assert(!std::is_same_v<ComponentType, Entity>, "Attempting to pass Entity as Component");
+		using ComponentStorageType = EcsComponentStorage<ComponentType, Entity>;
+
+		const EcsComponentIndex componentIndex = ComponentTypeIdGetter<ComponentType>::GetIndex();
+		return componentIndex < ComponentStorages.size() ? static_cast<const ComponentStorageType*>(ComponentStorages[componentIndex].get()) : nullptr;
 	}
 
 private:
 	EcsEntityStorage<Entity> EntityStorage;
-	std::unordered_map<EcsComponentType, std::shared_ptr<SparseSet<Entity>>> ComponentStorages; // Stores pointers to EcsComponentStorage
+	std::vector<EcsComponentMask> ComponentMasks; // Components of every entity, indexed by entity id. Kept up to date by the registry calls
+	std::vector<UniquePtr<SparseSet<Entity>>> ComponentStorages; // EcsComponentStorages indexed by EcsComponentIndex, null till first used
+	std::vector<UniquePtr<EcsGroupHandlerBase>> Groups; // Declared after the storages, groups detach from them when destroyed
 };
 }
@@ -0,0 +1,149 @@
+#pragma once
+#include <concepts>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "CoreDefinitions.h"
+
+namespace LE
+{
+struct EcsSnapshotHeader
+{
+	static constexpr uint32 CurrentMagic = 0x4E53454C; // LESN
+	static constexpr uint32 CurrentVersion = 2;
+
+	uint32 Magic = CurrentMagic;
+	uint32 Version = CurrentVersion;
+	uint32 EntitySize = 0;
+	uint32 ComponentMaskSize = 0;
+};
+
+// Destination of registry snapshots. Storages write their arrays and component pages as a few large blocks,
+// so it's called per block and not per entity
+class EcsSnapshotWriter
+{
+public:
+	virtual ~EcsSnapshotWriter() = default;
+
+	virtual void Write(const void* Data, size_t Size) = 0;
+
+	// Called with the size of the snapshot before it's written, so writers can allocate once
+	virtual void ReserveForWrite([[maybe_unused]] size_t Size)
+	{
+	}
+
+	template <typename Type>
+	void WriteValue(const Type& Value)
+	{
+		static_assert(std::is_trivially_copyable_v<Type>, "Only trivially copyable values are written as bytes");
+		Write(&Value, sizeof(Type));
+	}
+
+	template <typename Type>
+	void WriteArray(std::span<const Type> Values)
+	{
+		static_assert(std::is_trivially_copyable_v<Type>, "Only trivially copyable values are written as bytes");
+		WriteValue<uint64>(Values.size());
+		Write(Values.data(), Values.size_bytes());
+	}
+};
+
+// Keeps the snapshot in memory. Reset keeps the buffer, so taking a snapshot every frame doesn't allocate
+class EcsSnapshotBufferWriter : public EcsSnapshotWriter
+{
+public:
+	void Write(const void* Data, size_t Size) override;
+
+	void ReserveForWrite(size_t Size) override
+	{
+		Reserve(BufferSize + Size);
+	}
+
+	void Reserve(size_t Capacity);
+
+	void Reset()
+	{
+		BufferSize = 0;
+	}
+
+	std::span<const std::byte> GetData() const
+	{
+		return {Buffer.get(), BufferSize};
+	}
+
+private:
+	UniquePtr<std::byte[]> Buffer; // Not value initialized, unlike a vector that would clear it before every grow
+	size_t BufferSize = 0;
+	size_t BufferCapacity = 0;
+};
+
+// Reads a snapshot from memory, like the data of EcsSnapshotBufferWriter or a memory mapped file. Reading past the end fails
+// and every read after it fails too, so loaders can check IsValid once at the end
+class EcsSnapshotReader
+{
+public:
+	explicit EcsSnapshotReader(std::span<const std::byte> InData)
+		: Data(InData)
+	{
+	}
+
+	// Returns the next Size bytes of the snapshot, or null if it's too short
+	const std::byte* ReadBlock(size_t Size);
+
+	bool Read(void* OutData, size_t Size);
+
+	template <typename Type>
+	bool ReadValue(Type& OutValue)
+	{
+		static_assert(std::is_trivially_copyable_v<Type>, "Only trivially copyable values are read as bytes");
+		return Read(&OutValue, sizeof(Type));
+	}
+
+	template <typename Type>
+	bool ReadArray(std::vector<Type>& OutValues)
+	{
+		static_assert(std::is_trivially_copyable_v<Type>, "Only trivially copyable values are read as bytes");
+		uint64 count = 0;
+		if (!ReadValue(count) || count > (Data.size() - Position) / sizeof(Type))
+		{
+			IsFailed = true;
+			return false;
+		}
+
+		OutValues.resize(static_cast<size_t>(count));
+		return Read(OutValues.data(), OutValues.size() * sizeof(Type));
+	}
+
+	bool IsValid() const
+	{
+		return !IsFailed;
+	}
+
+	bool IsAtEnd() const
+	{
+		return Position == Data.size();
+	}
+
+private:
+	std::span<const std::byte> Data;
+	size_t Position = 0;
+	bool IsFailed = false;
+};
+
+// Snapshots copy trivially copyable components as raw pages, other components need a serializer to be snapshotted:
+//	template <> struct EcsComponentSerializer<NameComponent>
+//	{
+//		static void Save(EcsSnapshotWriter& Writer, const NameComponent& Component);
+//		static NameComponent Load(EcsSnapshotReader& Reader); // Has to return a component even if the reader failed
+//	};
+template <typename ComponentType>
+struct EcsComponentSerializer;
+
+template <typename ComponentType>
+concept EcsSerializableComponent = requires(EcsSnapshotWriter& Writer, EcsSnapshotReader& Reader, const ComponentType& Component)
+{
+	EcsComponentSerializer<ComponentType>::Save(Writer, Component);
+	{ EcsComponentSerializer<ComponentType>::Load(Reader) } -> std::same_as<ComponentType>;
+};
+}
\ No newline at end of file
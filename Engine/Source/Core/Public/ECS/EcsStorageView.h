@@ -4,6 +4,7 @@
 #include "Containers/ECSStorage.h"
 
 #include <array>
+#include <span>
 
 #include "Templates/TypeHelpers.h"
 
@@ -27,15 +28,20 @@ public:
 		  , ComponentStorages{}
 		  , ExcludedComponentStorages{}
 		  , Index{}
+		  , ChangedStorageMask{}
+		  , ChangedSinceTick{}
 	{
 	}
 
 	EcsComponentStorageViewIterator(iterator_type First, std::array<const BaseStorageType*, Num> Storages,
-	                                std::array<const BaseStorageType*, ExcludeNum> ExcludedStorages, std::size_t IndexIn) noexcept
+	                                std::array<const BaseStorageType*, ExcludeNum> ExcludedStorages, std::size_t IndexIn,
+	                                uint64 InChangedStorageMask = 0u, EcsTick InChangedSinceTick = 0u) noexcept
 		: Iterator(First)
 		  , ComponentStorages(Storages)
 		  , ExcludedComponentStorages(ExcludedStorages)
 		  , Index(static_cast<difference_type>(IndexIn))
+		  , ChangedStorageMask(InChangedStorageMask)
+		  , ChangedSinceTick(InChangedSinceTick)
 	{
 		Advance();
 	}
@@ -87,6 +93,36 @@ private:
 			}
 		}
 
+		if (ChangedStorageMask != 0u)
+		{
+			if (!AllFilteredComponentsChanged(Entity))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool AllFilteredComponentsChanged(const typename iterator_traits::value_type Entity) const noexcept
+	{
+		for (std::size_t current = 0; current < Num; ++current)
+		{
+			if ((ChangedStorageMask & (uint64{1} << current)) == 0u)
+			{
+				continue;
+			}
+
+			// Leading storage is the one being iterated, its tick is read by position
+			const EcsTick changedTick = static_cast<difference_type>(current) == Index
+				                            ? ComponentStorages[current]->GetChangedTickAt(static_cast<std::size_t>(Iterator.Index()))
+				                            : ComponentStorages[current]->GetChangedTick(Entity);
+			if (!IsEcsTickNewer(changedTick, ChangedSinceTick))
+			{
+				return false;
+			}
+		}
+
 		return true;
 	}
 
@@ -109,6 +145,8 @@ private:
 	std::array<const BaseStorageType*, Num> ComponentStorages;
 	std::array<const BaseStorageType*, ExcludeNum> ExcludedComponentStorages;
 	difference_type Index;
+	uint64 ChangedStorageMask;
+	EcsTick ChangedSinceTick;
 };
 
 template <typename LhsType, auto... LhsArgs, typename RhsType, auto... RhsArgs>
@@ -158,6 +196,8 @@ public:
 		std::swap(ComponentStorages, Other.ComponentStorages);
 		std::swap(ExcludedComponentStorages, Other.ExcludedComponentStorages);
 		std::swap(LeadingStorageIndex, Other.LeadingStorageIndex);
+		std::swap(ChangedStorageMask, Other.ChangedStorageMask);
+		std::swap(ChangedSinceTick, Other.ChangedSinceTick);
 	}
 
 	const base_storage_type* GetLeadingStorage() const noexcept
@@ -179,7 +219,7 @@ public:
 
 		return {
 			GetLeadingStorage()->end() - static_cast<difference_type>(GetLeadingStorageSize()), ComponentStorages,
-			ExcludedComponentStorages, LeadingStorageIndex
+			ExcludedComponentStorages, LeadingStorageIndex, ChangedStorageMask, ChangedSinceTick
 		};
 	}
 
@@ -190,7 +230,7 @@ public:
 			return {};
 		}
 
-		return {GetLeadingStorage()->end(), ComponentStorages, ExcludedComponentStorages, LeadingStorageIndex};
+		return {GetLeadingStorage()->end(), ComponentStorages, ExcludedComponentStorages, LeadingStorageIndex, ChangedStorageMask, ChangedSinceTick};
 	}
 
 	entity_type front() const noexcept
@@ -216,6 +256,15 @@ public:
 			return false;
 		}
 
+		for (size_type current = 0; current < Num; ++current)
+		{
+			if ((ChangedStorageMask & (uint64{1} << current)) != 0u
+				&& !IsEcsTickNewer(ComponentStorages[current]->GetChangedTick(Entity), ChangedSinceTick))
+			{
+				return false;
+			}
+		}
+
 		return true;
 	}
 
@@ -226,7 +275,10 @@ public:
 			return end();
 		}
 
-		return {GetLeadingStorage()->Find(Entity), ComponentStorages, ExcludedComponentStorages, LeadingStorageIndex};
+		return {
+			GetLeadingStorage()->Find(Entity), ComponentStorages, ExcludedComponentStorages, LeadingStorageIndex, ChangedStorageMask,
+			ChangedSinceTick
+		};
 	}
 
 	explicit operator bool() const noexcept
@@ -237,6 +289,8 @@ public:
 protected:
 	EcsComponentStorageViewBase() noexcept
 		: LeadingStorageIndex(Num)
+		  , ChangedStorageMask(0u)
+		  , ChangedSinceTick(0u)
 	{
 	}
 
@@ -245,6 +299,8 @@ protected:
 		: ComponentStorages(Storages)
 		  , ExcludedComponentStorages(ExcludedStorages)
 		  , LeadingStorageIndex(Num)
+		  , ChangedStorageMask(0u)
+		  , ChangedSinceTick(0u)
 	{
 		UpdateLeadingStorageIndex();
 	}
@@ -277,6 +333,37 @@ protected:
 		LeadingStorageIndex = LeadingStorageIndex != Num ? Index : Num;
 	}
 
+	void SetChangedFilter(const uint64 StorageMask, const EcsTick SinceTick) noexcept
+	{
+		ChangedStorageMask = StorageMask;
+		ChangedSinceTick = SinceTick;
+	}
+
+	// Packed positions of the entity in every included storage, each storage is looked up once.
+	// False if the entity isn't in the view
+	bool FindEachPositions(const entity_type Entity, const size_type LeadingPosition, std::array<size_type, Num>& OutPositions) const noexcept
+	{
+		for (size_type current = 0; current < Num; ++current)
+		{
+			if (current == LeadingStorageIndex)
+			{
+				OutPositions[current] = LeadingPosition;
+			}
+			else if (!ComponentStorages[current]->TryGetSparseIndex(Entity, OutPositions[current]))
+			{
+				return false;
+			}
+
+			if ((ChangedStorageMask & (uint64{1} << current)) != 0u
+				&& !IsEcsTickNewer(ComponentStorages[current]->GetChangedTickAt(OutPositions[current]), ChangedSinceTick))
+			{
+				return false;
+			}
+		}
+
+		return NoneOfContainersHas(ExcludedComponentStorages.begin(), ExcludedComponentStorages.end(), Entity);
+	}
+
 private:
 	void UpdateLeadingStorageIndex() noexcept
 	{
@@ -302,6 +389,8 @@ protected:
 	std::array<const BaseStorageType*, Num> ComponentStorages;
 	std::array<const BaseStorageType*, ExcludeNum> ExcludedComponentStorages;
 	size_type LeadingStorageIndex;
+	uint64 ChangedStorageMask; // Bit per included storage, its component has to be changed after ChangedSinceTick
+	EcsTick ChangedSinceTick;
 };
 
 template <typename, typename>
@@ -318,6 +407,9 @@ class EcsStorageView<IncludedComponentTypes<Components...>, ExcludedComponentTyp
 	template <std::size_t Index>
 	using StorageTypeAt = ComponentStorageTypeAtIndex<Index, ComponentTypeList<Components..., ExcludedComponents...>>;
 
+	template <std::size_t Index>
+	using ComponentTypeAt = typename StorageTypeAt<Index>::value_type;
+
 public:
 	using common_type = typename base_type::base_storage_type;
 	using entity_type = typename base_type::entity_type;
@@ -325,6 +417,8 @@ public:
 	using difference_type = std::ptrdiff_t;
 	using iterator = typename base_type::iterator;
 
+	static_assert(sizeof...(Components) <= 64u, "Changed filter keeps a bit per included component");
+
 	EcsStorageView() noexcept = default;
 
 	EcsStorageView(Components&... ComponentsIn, ExcludedComponents&... Excluded) noexcept
@@ -338,6 +432,13 @@ public:
 		SetLeadingStorage(ComponentStorageIndex<ComponentType>);
 	}
 
+	// Skips entities unless all of ChangedComponents were mutably accessed after SinceTick, usually the last run of the job
+	template <typename... ChangedComponents>
+	void FilterChanged(const EcsTick SinceTick) noexcept
+	{
+		base_type::SetChangedFilter(((uint64{1} << ComponentStorageIndex<ChangedComponents>) | ... | 0u), SinceTick);
+	}
+
 	template <typename ComponentType>
 	auto* GetComponentStorage() const noexcept
 	{
@@ -370,7 +471,184 @@ public:
 		}
 	}
 
+	// Same as GetComponents, but the components are const and aren't marked as changed
+	template <typename ComponentType, typename... OtherComponentTypes>
+	decltype(auto) ReadComponents(const entity_type Entity) const
+	{
+		if constexpr (sizeof...(OtherComponentTypes) == 0)
+		{
+			return std::as_const(*GetComponentStorage<ComponentType>()).GetComponent(Entity);
+		}
+		else
+		{
+			return std::tuple_cat(std::as_const(*GetComponentStorage<ComponentType>()).GetComponentAsTuple(Entity),
+			                      std::as_const(*GetComponentStorage<OtherComponentTypes>()).GetComponentAsTuple(Entity)...);
+		}
+	}
+
+	// Calls Function(Entity, Components&...) for every entity of the view, in the same order as iterating it.
+	// Components taken as const references aren't marked as changed. The leading storage is walked by position,
+	// the other components are looked up once per entity
+	template <typename Func>
+	void Each(Func&& Function) const
+	{
+		EachImpl(Function, std::index_sequence_for<Components...>{});
+	}
+
+	// Calls Function(Entities, ComponentSpan) with spans that are contiguous in memory, so inner loops can be vectorised.
+	// Spans don't cross component pages and go in the packed order, components in spans of const aren't marked as changed.
+	// Components of different storages aren't kept in the same order, so it's only for views of a single component
+	template <typename Func>
+	void EachChunk(Func&& Function) const
+	{
+		static_assert(sizeof...(Components) == 1u && sizeof...(ExcludedComponents) == 0u,
+		              "Only single component views without excluded components can be chunked, use a group for more components");
+		using component_type = ComponentTypeAt<0>;
+		constexpr bool isReadOnly = std::is_invocable_v<Func&, std::span<const entity_type>, std::span<const component_type>>;
+
+		auto* storage = GetComponentStorage<0>();
+		EachChunkImpl<isReadOnly>([storage, &Function](const size_type PageIndex, const size_type PageOffset, std::span<const entity_type> Entities)
+		{
+			component_type* page = storage->GetComponentPage(PageIndex) + PageOffset;
+			if constexpr (isReadOnly)
+			{
+				Function(Entities, std::span<const component_type>(page, Entities.size()));
+			}
+			else
+			{
+				Function(Entities, std::span<component_type>(page, Entities.size()));
+			}
+		});
+	}
+
+	// EachChunk for components stored in columns, Function(Entities, ColumnSpans...) gets a span for each of Columns.
+	// Columns that aren't asked for are never touched, components are marked as changed unless all the spans are const
+	template <size_type... Columns, typename Func>
+	void EachColumns(Func&& Function) const
+	{
+		static_assert(sizeof...(Components) == 1u && sizeof...(ExcludedComponents) == 0u,
+		              "Only single component views without excluded components can be chunked");
+		using storage_type = StorageTypeAt<0>;
+		static_assert(storage_type::IsColumnar, "Component isn't stored in columns, use EachChunk");
+		constexpr bool isReadOnly = std::is_invocable_v<Func&, std::span<const entity_type>,
+		                                                std::span<const typename storage_type::template column_type<Columns>>...>;
+
+		auto* storage = GetComponentStorage<0>();
+		EachChunkImpl<isReadOnly>([storage, &Function](const size_type PageIndex, const size_type PageOffset, std::span<const entity_type> Entities)
+		{
+			if constexpr (isReadOnly)
+			{
+				Function(Entities, std::span<const typename storage_type::template column_type<Columns>>(
+					         storage->template GetColumnPage<Columns>(PageIndex) + PageOffset, Entities.size())...);
+			}
+			else
+			{
+				Function(Entities, std::span<typename storage_type::template column_type<Columns>>(
+					         storage->template GetColumnPage<Columns>(PageIndex) + PageOffset, Entities.size())...);
+			}
+		});
+	}
+
 private:
+	// Calls ChunkFunction(PageIndex, PageOffset, Entities) for the runs of the leading storage that pass the changed filter
+	// and don't cross pages. Runs are marked as changed before the call, unless IsReadOnly
+	template <bool IsReadOnly, typename Func>
+	void EachChunkImpl(Func&& ChunkFunction) const
+	{
+		constexpr size_type pageSize = StorageTypeAt<0>::ComponentsPerPage;
+
+		if (!*this)
+		{
+			return;
+		}
+
+		auto* storage = GetComponentStorage<0>();
+		const entity_type* entities = storage->Data();
+		const size_type count = storage->Count();
+		const bool isChangeFiltered = this->ChangedStorageMask != 0u;
+		const EcsTick changeTick = GetEcsChangeTick();
+		for (size_type pageBegin = 0; pageBegin < count; pageBegin += pageSize)
+		{
+			const size_type pageEnd = Min<size_type>(pageBegin + pageSize, count);
+			for (size_type chunkBegin = pageBegin; chunkBegin < pageEnd;)
+			{
+				// Changed filter splits the page into runs of changed components
+				size_type chunkEnd = pageEnd;
+				if (isChangeFiltered)
+				{
+					for (; chunkBegin < pageEnd && !IsEcsTickNewer(storage->GetChangedTickAt(chunkBegin), this->ChangedSinceTick); ++chunkBegin)
+					{
+					}
+
+					for (chunkEnd = chunkBegin; chunkEnd < pageEnd && IsEcsTickNewer(storage->GetChangedTickAt(chunkEnd), this->ChangedSinceTick); ++chunkEnd)
+					{
+					}
+
+					if (chunkBegin == chunkEnd)
+					{
+						break;
+					}
+				}
+
+				if constexpr (!IsReadOnly)
+				{
+					for (size_type position = chunkBegin; position < chunkEnd; ++position)
+					{
+						storage->SetChangedTickAt(position, changeTick);
+					}
+				}
+				ChunkFunction(pageBegin / pageSize, chunkBegin - pageBegin, std::span<const entity_type>(entities + chunkBegin, chunkEnd - chunkBegin));
+
+				chunkBegin = chunkEnd;
+			}
+		}
+	}
+
+	// Walks the leading storage by position from the back, like the iterator does
+	template <typename Func, size_type... Index>
+	void EachImpl(Func& Function, std::index_sequence<Index...>) const
+	{
+		if (!*this)
+		{
+			return;
+		}
+
+		const EcsTick changeTick = GetEcsChangeTick();
+		const common_type* leadingStorage = base_type::GetLeadingStorage();
+		std::array<size_type, sizeof...(Components)> positions;
+		for (size_type position = leadingStorage->Count(); position-- > 0u;)
+		{
+			const entity_type entity = leadingStorage->Data()[position];
+			if (base_type::FindEachPositions(entity, position, positions))
+			{
+				Function(entity, GetEachComponent<Func, Index>(positions[Index], changeTick)...);
+			}
+		}
+	}
+
+	template <typename Func, size_type Index>
+	decltype(auto) GetEachComponent(const size_type Position, const EcsTick ChangeTick) const
+	{
+		auto* storage = GetComponentStorage<Index>();
+		if constexpr (IsReadOnlyInEach<Func, Index>(std::index_sequence_for<Components...>{}))
+		{
+			return static_cast<typename StorageTypeAt<Index>::const_reference>(storage->GetComponentAt(Position));
+		}
+		else
+		{
+			storage->SetChangedTickAt(Position, ChangeTick);
+			return storage->GetComponentAt(Position);
+		}
+	}
+
+	// Component is read only if Function can take it as a const reference, components stored in columns are passed as EcsColumnarReference
+	template <typename Func, size_type Index, size_type... Other>
+	static constexpr bool IsReadOnlyInEach(std::index_sequence<Other...>)
+	{
+		return std::is_invocable_v<Func&, entity_type, std::conditional_t<Other == Index, typename StorageTypeAt<Other>::const_reference,
+		                                                                  typename StorageTypeAt<Other>::reference>...>;
+	}
+
 	template <typename ComponentType>
 	static constexpr size_type ComponentStorageIndex = ComponentIndexInList<
 		ComponentType, ComponentTypeList<typename Components::value_type...>>;
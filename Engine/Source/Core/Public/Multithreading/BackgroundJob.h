@@ -0,0 +1,129 @@
+#pragma once
+#include <atomic>
+#include <string>
+
+#include "Core.h"
+#include "CoreDefinitions.h"
+#include "Templates/RefCounters.h"
+
+namespace LE
+{
+class JobScheduler;
+
+enum class BackgroundJobState : uint8
+{
+	Queued = 0,
+	Running,
+	Completed,
+	Cancelled
+};
+
+// Work that can span several frames, like shader compiles or asset loads. It's not part of the frame, WaitForAll doesn't wait for it,
+// and workers only pick it up when they have no frame jobs to run
+class BackgroundJob : public RefCountableBase
+{
+	friend JobScheduler;
+
+public:
+	using WorkFunction = FunctionRef<void(BackgroundJob&)>;
+	using CompletionCallback = FunctionRef<void(BackgroundJobState)>; // Called on GT with Completed or Cancelled
+
+	BackgroundJob(JobScheduler* InOwner, std::string InName, WorkFunction InFunction, CompletionCallback InOnFinished)
+		: Function(std::move(InFunction))
+		  , OnFinished(std::move(InOnFinished))
+		  , Name(std::move(InName))
+		  , Owner(InOwner)
+		  , State(BackgroundJobState::Queued)
+		  , IsCancelRequested(false)
+	{
+	}
+
+	const std::string& GetName() const
+	{
+		return Name;
+	}
+
+	BackgroundJobState GetState() const
+	{
+		return State.load(std::memory_order_acquire);
+	}
+
+	bool IsFinished() const
+	{
+		const BackgroundJobState state = GetState();
+		return state == BackgroundJobState::Completed || state == BackgroundJobState::Cancelled;
+	}
+
+	// Queued job is dropped without running and finishes as Cancelled right away, a running one should poll IsCancellationRequested
+	// and return early. Job that returns after cancellation was requested finishes as Cancelled
+	void Cancel();
+
+	bool IsCancellationRequested() const
+	{
+		return IsCancelRequested.load(std::memory_order_acquire);
+	}
+
+	// Runs the frame jobs waiting on the worker executing this job. Long jobs should call it between their steps,
+	// so jobs dealt out to this worker don't have to wait for somebody to steal them
+	void YieldToFrameJobs();
+
+	// Blocks the calling thread till the job is finished. Completion callback may not have been called yet
+	void Wait() const;
+
+private:
+	void Run();
+
+	WorkFunction Function;
+	CompletionCallback OnFinished;
+	std::string Name; // Owned, the job may outlive whatever the name was built from
+	JobScheduler* Owner;
+	std::atomic<BackgroundJobState> State;
+	std::atomic<bool> IsCancelRequested;
+};
+
+// Shared handle to a submitted background job, empty handles are ignored
+class BackgroundJobHandle
+{
+public:
+	BackgroundJobHandle() = default;
+
+	explicit BackgroundJobHandle(RefCountingPtr<BackgroundJob> InJob)
+		: Job(std::move(InJob))
+	{
+	}
+
+	bool IsValid() const
+	{
+		return Job.IsValid();
+	}
+
+	BackgroundJobState GetState() const
+	{
+		return Job ? Job->GetState() : BackgroundJobState::Cancelled;
+	}
+
+	bool IsFinished() const
+	{
+		return !Job || Job->IsFinished();
+	}
+
+	void Cancel() const
+	{
+		if (Job)
+		{
+			Job->Cancel();
+		}
+	}
+
+	void Wait() const
+	{
+		if (Job)
+		{
+			Job->Wait();
+		}
+	}
+
+private:
+	RefCountingPtr<BackgroundJob> Job;
+};
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+#include <vector>
+
+#include "CoreDefinitions.h"
+
+namespace LE
+{
+struct LogicalCpuInfo
+{
+	uint32 LogicalId = 0; // Id the OS uses for affinity masks
+	uint32 CoreId = 0; // Physical core, unique across packages
+	uint32 PackageId = 0;
+	uint32 NumaNode = 0;
+	uint32 CacheDomainId = 0; // Last level cache the CPU shares with others, e.g. a CCX on AMD
+	uint32 SmtIndex = 0; // 0 for the first hardware thread of a core
+};
+
+enum class ThreadAffinityPolicy : uint8
+{
+	None = 0, // Threads are not pinned, OS decides
+	PhysicalCores, // One thread per physical core, SMT siblings stay free
+	Compact, // Fill cache domains one after another, SMT siblings included
+	Scatter, // Spread threads over NUMA nodes and cache domains, SMT siblings are used last
+};
+
+class CpuTopology
+{
+public:
+	static const CpuTopology& Get(); // Probed on first use
+
+	// False if the platform couldn't be queried, every logical CPU is then reported as a separate core
+	bool IsProbed() const
+	{
+		return Probed;
+	}
+
+	const std::vector<LogicalCpuInfo>& GetLogicalCpus() const
+	{
+		return LogicalCpus;
+	}
+
+	const LogicalCpuInfo* FindLogicalCpu(uint32 LogicalId) const;
+
+	uint32 GetLogicalCpuCount() const
+	{
+		return static_cast<uint32>(LogicalCpus.size());
+	}
+
+	uint32 GetPhysicalCoreCount() const
+	{
+		return PhysicalCoreCount;
+	}
+
+	uint32 GetNumaNodeCount() const
+	{
+		return NumaNodeCount;
+	}
+
+	// Logical CPUs in the order threads should be pinned to them, empty for ThreadAffinityPolicy::None or if topology is unknown
+	std::vector<uint32> GetAffinityOrder(ThreadAffinityPolicy Policy) const;
+
+private:
+	CpuTopology();
+
+	bool ProbePlatform();
+	void SetupFallback();
+	void FinalizeProbe();
+
+	std::vector<LogicalCpuInfo> LogicalCpus;
+	uint32 PhysicalCoreCount = 0;
+	uint32 NumaNodeCount = 0;
+	bool Probed = false;
+};
+}
\ No newline at end of file
@@ -0,0 +1,189 @@
+#pragma once
+#include <atomic>
+#include <coroutine>
+#include <exception>
+
+#include "JobNode.h"
+#include "JobWaitList.h"
+
+namespace LE
+{
+// Return type of coroutine jobs. Coroutine doesn't start on creation, it has to be handed over to JobScheduler::SpawnCoroutineJob.
+// While suspended on co_await it doesn't occupy a worker, it's resumed as a new job once the awaited object is signaled.
+// Job that spawned the coroutine completes only after the coroutine has finished
+class JobTask : public NonCopyable
+{
+public:
+	struct promise_type
+	{
+		JobTask get_return_object()
+		{
+			return JobTask(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+
+		std::suspend_always initial_suspend() noexcept
+		{
+			return {};
+		}
+
+		// Nobody waits for the result, frame is destroyed as soon as the coroutine is finished
+		std::suspend_never final_suspend() noexcept
+		{
+			return {};
+		}
+
+		void return_void()
+		{
+		}
+
+		void unhandled_exception()
+		{
+			std::terminate();
+		}
+	};
+
+	JobTask(JobTask&& Other) noexcept
+		: Handle(std::exchange(Other.Handle, nullptr))
+	{
+	}
+
+	JobTask& operator=(JobTask&& Other) noexcept
+	{
+		std::swap(Handle, Other.Handle);
+		return *this;
+	}
+
+	~JobTask()
+	{
+		if (Handle)
+		{
+			Handle.destroy();
+		}
+	}
+
+	std::coroutine_handle<> Release()
+	{
+		return std::exchange(Handle, nullptr);
+	}
+
+private:
+	explicit JobTask(std::coroutine_handle<promise_type> InHandle)
+		: Handle(InHandle)
+	{
+	}
+
+	std::coroutine_handle<promise_type> Handle;
+};
+
+// Suspends the coroutine till the wait list is signaled
+class JobWaitListAwaiter
+{
+public:
+	explicit JobWaitListAwaiter(JobWaitList& InWaitList)
+		: WaitList(InWaitList)
+	{
+	}
+
+	bool await_ready() const
+	{
+		return WaitList.IsSignaled();
+	}
+
+	bool await_suspend(std::coroutine_handle<> Handle);
+
+	void await_resume() const
+	{
+	}
+
+private:
+	JobWaitList& WaitList;
+	JobWaitList::Waiter Waiter;
+};
+
+// Counter that is signaled when it drops to zero
+class JobCounter : public NonCopyable
+{
+public:
+	explicit JobCounter(uint32 InitialValue = 0);
+
+	// Shouldn't race with somebody waiting for the counter to get to zero
+	void Add(uint32 Count = 1);
+	void Decrement();
+
+	uint32 GetValue() const
+	{
+		return Value.load(std::memory_order_acquire);
+	}
+
+	void Wait() const
+	{
+		WaitList.Wait();
+	}
+
+	JobWaitList& GetWaitList()
+	{
+		return WaitList;
+	}
+
+private:
+	std::atomic<uint32> Value;
+	JobWaitList WaitList;
+};
+
+class JobFence : public NonCopyable
+{
+public:
+	explicit JobFence(bool IsInitiallySignaled = false)
+	{
+		if (IsInitiallySignaled)
+		{
+			WaitList.Signal();
+		}
+	}
+
+	void Signal()
+	{
+		WaitList.Signal();
+	}
+
+	// Should only be called when nobody is waiting
+	void Reset()
+	{
+		WaitList.Reset();
+	}
+
+	bool IsSignaled() const
+	{
+		return WaitList.IsSignaled();
+	}
+
+	void Wait() const
+	{
+		WaitList.Wait();
+	}
+
+	JobWaitList& GetWaitList()
+	{
+		return WaitList;
+	}
+
+private:
+	JobWaitList WaitList;
+};
+
+// Job is signaled once it and all of its children have completed, graph jobs are reset at the start of every frame
+inline JobWaitListAwaiter operator co_await(JobNode& Job)
+{
+	return JobWaitListAwaiter(Job.GetCompletionWaitList());
+}
+
+inline JobWaitListAwaiter operator co_await(JobCounter& Counter)
+{
+	return JobWaitListAwaiter(Counter.GetWaitList());
+}
+
+inline JobWaitListAwaiter operator co_await(JobFence& Fence)
+{
+	return JobWaitListAwaiter(Fence.GetWaitList());
+}
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <span>
+
+#include "Core.h"
+#include "CoreDefinitions.h"
+#include "Templates/NonCopyable.h"
+
+namespace LE
+{
+class JobNode;
+
+// Update graph flattened after every (re)build. Jobs are addressed by their index in topological order, dependents of a job
+// are a span of indices, and the readiness counters of all jobs are one array. Everything lives in a single allocation,
+// so completing a job touches neither hash tables nor reference counts
+class JobGraph : public NonCopyable
+{
+public:
+	JobGraph() = default;
+
+	~JobGraph()
+	{
+		Reset();
+	}
+
+	// Jobs have to be topologically sorted, their build-time dependent lists are copied into the arrays.
+	// Jobs are borrowed, whoever owns them has to keep them alive while the graph is in use
+	void Compile(std::span<JobNode* const> InJobs);
+	void Reset();
+
+	uint32 GetJobCount() const
+	{
+		return JobCount;
+	}
+
+	JobNode* GetJob(uint32 JobIndex) const
+	{
+		return Jobs[JobIndex];
+	}
+
+	std::span<const uint32> GetDependents(uint32 JobIndex) const
+	{
+		return {Dependents + DependentOffsets[JobIndex], Dependents + DependentOffsets[JobIndex + 1]};
+	}
+
+	uint32 GetDependencyCount(uint32 JobIndex) const
+	{
+		return DependencyCounts[JobIndex];
+	}
+
+	uint32 GetRemainingDependencyCount(uint32 JobIndex) const
+	{
+		return RemainingDependencies[JobIndex].load(std::memory_order_acquire);
+	}
+
+	// Returns true if that was the last dependency the job was waiting for
+	bool OnDependencyCompleted(uint32 JobIndex)
+	{
+		return RemainingDependencies[JobIndex].fetch_sub(1, std::memory_order_acq_rel) == 1;
+	}
+
+	// Job is waiting for all of its dependencies again, called once the job completes so it's ready for the next frame
+	void ResetDependencies(uint32 JobIndex)
+	{
+		RemainingDependencies[JobIndex].store(DependencyCounts[JobIndex], std::memory_order_release);
+	}
+
+private:
+	void* Memory = nullptr;
+	uint32 JobCount = 0;
+	JobNode** Jobs = nullptr;
+	std::atomic<uint32>* RemainingDependencies = nullptr;
+	uint32* DependencyCounts = nullptr;
+	uint32* DependentOffsets = nullptr; // JobCount + 1 entries, dependents of job i are [DependentOffsets[i], DependentOffsets[i + 1])
+	uint32* Dependents = nullptr;
+};
+}
\ No newline at end of file
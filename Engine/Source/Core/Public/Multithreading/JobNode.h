@@ -1,6 +1,11 @@
 #pragma once
 
-#include <unordered_set>
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include "JobGraph.h"
+#include "JobWaitList.h"
 #include "Templates/RefCounters.h"
 #include "UpdatePasses.h"
 
@@ -8,10 +13,29 @@ namespace LE
 {
 class JobScheduler;
 
+// Every thread keeps a queue per priority, ready jobs are always taken from the highest non-empty one
+enum class JobPriority : uint8
+{
+	Critical = 0, // Job is on the critical path of the update graph, any delay makes the frame longer
+	High,
+	Normal,
+
+	Count
+};
+
+#define JOB_PRIORITY_COUNT static_cast<size_t>(JobPriority::Count)
+
+// Cost of a single static weight unit for jobs that were never measured
+#define JOB_STATIC_WEIGHT_UNIT_NS 10000
+#define JOB_EXECUTION_TIME_SMOOTHING_SHIFT 3
+// Dependents that become ready together are submitted in batches of up to this many jobs
+#define JOB_SUBMIT_BATCH_SIZE 64
+
 // Will probably need to split into Gameplay Work and Render Work
 class JobNode : public RefCountableBase
 {
 	friend JobScheduler;
+	friend JobGraph;
 
 public:
 	JobNode(JobScheduler* InOwner, std::string_view InJobName, Delegate<void(const float)> UpdateFunction, UpdateJobType InType,
@@ -22,42 +46,161 @@ public:
 		  , PassType(InPassType)
 		  , Owner(InOwner)
 		  , DefaultDependencies(0)
+		  , StaticWeight(1)
+		  , AverageExecutionTimeNs(0)
+		  , RemainingPathCost(0)
+		  , PrecedingPathCost(0)
+		  , Priority(JobPriority::Normal)
+		  , PendingChildren(0)
+		  , ReadyTimeNs(0)
+		  , StartTimeNs(0)
+		  , ExecutionTimeNs(0)
+		  , ExecutingThreadIndex(-1)
+		  , WasStolen(false)
+		  , GraphIndex(Constants<uint32>::CMax)
+		  , Graph(nullptr)
+		  , GraphJobIndex(0)
+		  , LastRunChangeTick(0)
 	{
 	}
 
+	// Job that is being executed on the calling thread, nullptr outside of a job
+	static JobNode* GetCurrentJob();
+
+	// Dependency links are only edited while the update graph is built, the scheduler then compiles them into a JobGraph
 	void AddDependentJob(JobNode& Job)
 	{
-		if (DependentJobs.contains(&Job))
+		if (std::find(DependentJobs.begin(), DependentJobs.end(), &Job) != DependentJobs.end())
 		{
 			return;
 		}
 
-		DependentJobs.emplace(&Job);
-		Job.IncrementDependencyCounter();
+		DependentJobs.push_back(&Job);
+		Job.PrecedingJobs.push_back(this);
 		++Job.DefaultDependencies;
 	}
 
 	void RemoveDependentJob(JobNode& Job)
 	{
-		if (!DependentJobs.contains(&Job))
+		auto it = std::find(DependentJobs.begin(), DependentJobs.end(), &Job);
+		if (it == DependentJobs.end())
 		{
 			return;
 		}
 
-		DependentJobs.erase(&Job);
+		DependentJobs.erase(it);
+		Job.PrecedingJobs.erase(std::find(Job.PrecedingJobs.begin(), Job.PrecedingJobs.end(), this));
 		--Job.DefaultDependencies;
 	}
 
+	// Update graph jobs are owned by the scheduler, transient jobs are kept alive by the queues they are in
+	bool IsGraphJob() const
+	{
+		return Graph != nullptr;
+	}
+
+	void AddQueueReference() const
+	{
+		if (!Graph)
+		{
+			AddRef();
+		}
+	}
+
+	// Runs a job taken from a queue, then the dependents it handed over to this thread as continuations.
+	// Graph jobs can be destroyed by the next rebuild as soon as they complete, so they aren't touched after Execute
+	static void ExecuteQueued(JobNode* Job);
+
+	void ReleaseQueueReference() const
+	{
+		if (!Graph)
+		{
+			Release();
+		}
+	}
+
+	uint32 GetGraphJobIndex() const
+	{
+		return GraphJobIndex;
+	}
+
 	bool IsReady() const
 	{
 		return GetCurrentRemainingJobCount() == 0;
 	}
 
+	// Job is completed, and its dependents fire, only after its own function and all of its child jobs have finished.
+	// Should be called from the job itself while it's running, or from one of its children
+	void AddChildJob(RefCountingPtr<JobNode> ChildJob);
+	// Same as AddChildJob, but the children are pushed as one batch, so every worker is woken up at most once
+	void AddChildJobs(std::span<JobNode* const> ChildJobs);
+
+	uint32 GetPendingChildCount() const
+	{
+		const uint32 pending = PendingChildren.load(std::memory_order_acquire);
+		return pending > 0 ? pending - 1 : 0;
+	}
+
+	JobNode* GetParent() const
+	{
+		return Parent.GetPointer();
+	}
+
+	// Keeps the job alive and incomplete till the matching ReleaseCompletion, used by coroutines suspended inside the job
+	void HoldCompletion()
+	{
+		AddRef();
+		PendingChildren.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void ReleaseCompletion()
+	{
+		OnChildCompleted();
+		Release();
+	}
+
+	// Signaled once the job and all of its children have completed
+	JobWaitList& GetCompletionWaitList()
+	{
+		return CompletionWaitList;
+	}
+
+	// Telemetry of the last execution
+	uint64 GetLastQueueWaitNs() const
+	{
+		return StartTimeNs > ReadyTimeNs ? StartTimeNs - ReadyTimeNs : 0;
+	}
+
+	uint64 GetLastExecutionTimeNs() const
+	{
+		return ExecutionTimeNs;
+	}
+
+	int16 GetLastExecutingThreadIndex() const // 0 is the main thread, workers start from 1
+	{
+		return ExecutingThreadIndex;
+	}
+
+	bool WasLastExecutionStolen() const
+	{
+		return WasStolen;
+	}
+
+	void OnPushed(uint64 TimeNs)
+	{
+		ReadyTimeNs = TimeNs;
+	}
+
+	void OnPickedUp(bool IsStolen)
+	{
+		WasStolen = IsStolen;
+	}
+
 	void Execute();
 
 	uint32 GetCurrentRemainingJobCount() const
 	{
-		return JobsTillReady.load(std::memory_order_acquire);
+		return Graph ? Graph->GetRemainingDependencyCount(GraphJobIndex) : 0;
 	}
 
 	uint32 GetDefaultRemainingJobCount() const
@@ -65,7 +208,7 @@ public:
 		return DefaultDependencies;
 	}
 
-	const std::unordered_set<RefCountingPtr<JobNode>>& GetDependentJobs() const
+	const std::vector<JobNode*>& GetDependentJobs() const
 	{
 		return DependentJobs;
 	}
@@ -85,19 +228,87 @@ public:
 		return PassType;
 	}
 
+	// Used as the job cost until it was executed at least once
+	void SetStaticWeight(uint32 InWeight)
+	{
+		StaticWeight = InWeight;
+	}
+
+	uint32 GetStaticWeight() const
+	{
+		return StaticWeight;
+	}
+
+	uint64 GetAverageExecutionTimeNs() const
+	{
+		return AverageExecutionTimeNs.load(std::memory_order_relaxed);
+	}
+
+	// Replaces the measured average, e.g. with costs loaded by offline tools. Next executions keep averaging from it
+	void SetAverageExecutionTimeNs(uint64 TimeNs)
+	{
+		AverageExecutionTimeNs.store(TimeNs, std::memory_order_relaxed);
+	}
+
+	uint64 GetCost() const;
+
+	// Longest path from the start of this job till the end of the frame, including the job itself
+	uint64 GetRemainingPathCost() const
+	{
+		return RemainingPathCost;
+	}
+
+	// Longest path from the start of the frame till this job can start
+	uint64 GetPrecedingPathCost() const
+	{
+		return PrecedingPathCost;
+	}
+
+	// Change tick taken when the last run of the update job completed, components changed after it are newer
+	EcsTick GetLastRunChangeTick() const
+	{
+		return LastRunChangeTick;
+	}
+
+	JobPriority GetPriority() const
+	{
+		return Priority;
+	}
+
+	void SetPriority(JobPriority InPriority)
+	{
+		Priority = InPriority;
+	}
+
 protected:
-	void IncrementDependencyCounter();
-	void DecrementDependencyCounter();
 	void OnCompleted();
+	void OnChildCompleted();
 
-private:
-	std::unordered_set<RefCountingPtr<JobNode>> DependentJobs;
+protected:
+	std::vector<JobNode*> DependentJobs; // Borrowed, graph jobs are owned by the scheduler
+	std::vector<JobNode*> PrecedingJobs; // Jobs this one directly depends on, so detaching it from the graph doesn't search other jobs
 	Delegate<void(const float)> Function;
 	std::string_view JobName;
 	UpdateJobType Type;
 	UpdatePassType PassType;
 	JobScheduler* Owner;
-	std::atomic_uint JobsTillReady;
 	uint32 DefaultDependencies;
+	uint32 StaticWeight;
+	std::atomic<uint64> AverageExecutionTimeNs; // Exponential moving average, only written by the executing thread
+	uint64 RemainingPathCost;
+	uint64 PrecedingPathCost;
+	JobPriority Priority;
+	RefCountingPtr<JobNode> Parent;
+	std::atomic<uint32> PendingChildren; // Children that haven't completed yet, plus one for the job's own function
+	JobWaitList CompletionWaitList;
+	uint64 ReadyTimeNs;
+	uint64 StartTimeNs;
+	uint64 ExecutionTimeNs;
+	int16 ExecutingThreadIndex;
+	bool WasStolen;
+	uint32 GraphIndex; // Slot in the scheduler's dependency bit sets, only set for update graph jobs
+	JobGraph* Graph; // Compiled graph the job belongs to, nullptr for transient jobs
+	uint32 GraphJobIndex;
+	EcsTick LastRunChangeTick; // Only advanced for update graph jobs
 };
-}
+}
\ No newline at end of file
@@ -1,51 +1,212 @@
 #pragma once
 #include <atomic>
+#include <deque>
+#include <mutex>
 #include <unordered_set>
 
 #include "Thread.h"
+#include "Multithreading/BackgroundJob.h"
+#include "Multithreading/CpuTopology.h"
+#include "Multithreading/JobCoroutine.h"
+#include "Multithreading/JobGraph.h"
 #include "Multithreading/JobNode.h"
+#include "Multithreading/JobTelemetry.h"
 
 #include "UpdatePasses.h"
 #include "ECS/EcsComponent.h"
+#include "Misc/Paths.h"
 #include "Templates/NonCopyable.h"
 #include "Templates/RefCounters.h"
 
 namespace LE
 {
+// Number of finalized frames the render thread can lag behind, game frame N + 2 simulates while frame N renders
 #define RENDER_THREAD_FRAME_BEHIND_MAX 2
 
+// Items per ParallelFor chunk are kept a power of two between these, so chunks don't share cache lines and stay within one storage page
+#define PARALLEL_FOR_MIN_CHUNK_SIZE CACHE_LINE_SIZE
+#define PARALLEL_FOR_MAX_CHUNK_SIZE ENTITY_SPARSE_PAGE
+#define PARALLEL_FOR_CHUNKS_PER_THREAD 4
+
+// Slack is how much a job can be delayed without making the frame longer, in percent of the critical path length
+#define JOB_CRITICAL_SLACK_PERCENT 10
+#define JOB_HIGH_PRIORITY_SLACK_PERCENT 50
+
+// Workers get a physical core each, SMT siblings are left to the OS and other processes
+#define JOB_SCHEDULER_DEFAULT_AFFINITY_POLICY ThreadAffinityPolicy::PhysicalCores
+
+// Share of the workers that can be busy with background jobs at the same time, at least one worker always can
+#define BACKGROUND_JOB_MAX_WORKERS_PERCENT 50
+
 struct UpdatePass;
 
 class JobScheduler : public NonCopyable
 {
+	friend JobNode;
+	friend BackgroundJob;
+
 public:
 	static JobScheduler* Get();
 
-	void Init(int8 WorkerThreadsNum);
+	// Number of workers that fills the CPUs the policy uses, leaving room for the main and render threads
+	static uint16 GetDefaultWorkerThreadCount(ThreadAffinityPolicy AffinityPolicy = JOB_SCHEDULER_DEFAULT_AFFINITY_POLICY);
+
+	// Main thread keeps the first CPU of the affinity order unpinned, the render thread gets the second one and workers the rest.
+	// Workers that don't fit into the order aren't pinned
+	void Init(uint16 WorkerThreadsNum, ThreadAffinityPolicy AffinityPolicy = JOB_SCHEDULER_DEFAULT_AFFINITY_POLICY);
 	void StartRenderThread();
 	void Shutdown();
 
 	void ConstructUpdateGraph();
+	// Applies passes and jobs that were added or removed at runtime, called at the start of every frame.
+	// Only the changed passes and the ones sharing components or resources with them get their dependencies recomputed
+	void RebuildChangedUpdatePasses();
+	// Recomputes path costs from measured execution times and assigns job priorities, called at the start of every frame
+	void UpdateCriticalPath();
+
+	uint64 GetCriticalPathCost() const
+	{
+		return CriticalPathCost;
+	}
+
+	// Update graph as it is scheduled, indices follow the topological order
+	const JobGraph& GetCompiledGraph() const
+	{
+		return CompiledGraph;
+	}
+
+	// Execution records of update graph jobs over the last frames, should be read on GT between frames
+	const JobTelemetry& GetJobTelemetry() const
+	{
+		return Telemetry;
+	}
+
+	void SetJobTelemetryHistorySize(uint32 Frames)
+	{
+		Telemetry.SetHistorySize(Frames);
+	}
+
+	// Writes the update graph to SavePath as DOT and next to it as JSON, optionally annotated with the collected telemetry
+	void DumpUpdateGraph(const Path& SavePath, bool AnnotateWithTelemetry = true) const;
 
 	void StartFrame();
 	void StartFrameRender(Delegate<void(const float)> Delegate);
 	void IncrementRenderThreadCount();
 
-	void OnJobBecameAvailable(RefCountingPtr<JobNode> JobNode);
+	void OnJobBecameAvailable(JobNode* JobNode);
+	void OnJobsBecameAvailable(std::span<JobNode* const> ReadyJobs);
+	// Job skips the queues and runs next on the thread that made it ready
+	void OnJobContinued(JobNode* JobNode);
 	void OnJobFinished();
 
 	bool AreAllFinished() const;
-	void WaitForAll();
+	void WaitForAll(); // Blocks on an atomic wait until the last job of the frame finishes
 	void HelpWorkerThreads(); // Should be called from MT. Do jobs till all are completed
 
-	bool TryStealJobFromThread(uint8 RequestingThreadIdx, RefCountingPtr<JobNode>& OutJob, ThreadType StealingType = ThreadType::Worker);
+	// Victims are visited from the closest to the furthest: same cache domain, same NUMA node, remote nodes
+	bool TryStealJobFromThread(uint16 RequestingThreadIdx, JobNode*& OutJob, ThreadType StealingType = ThreadType::Worker);
+
+	// Splits [0, Count) into chunks that run as child jobs of the running job, Function is called as Function(Begin, End).
+	// Returns right away, the running job completes and its dependents fire only once all chunks are finished, so Function is copied
+	// and shouldn't reference locals of the caller. Outside of jobs the calling thread takes part in the work and returns when it's done
+	template <typename Func>
+	void ParallelFor(uint64 Count, Func&& Function, uint64 ChunkSize = 0)
+	{
+		ParallelForImpl(Count, ChunkSize, std::forward<Func>(Function));
+	}
+
+	// Runs Function(Entity) for every Entity of the View, splitting the leading storage into chunks. View and Function are copied
+	template <typename ViewType, typename Func>
+	void ParallelEach(const ViewType& View, Func&& Function, uint64 ChunkSize = 0)
+	{
+		const auto* leadingStorage = View.GetLeadingStorage();
+		if (!leadingStorage)
+		{
+			return;
+		}
+
+		const auto* entities = leadingStorage->Data();
+		ParallelFor(leadingStorage->Count(), [View, Function = std::forward<Func>(Function), entities](const uint64 Begin, const uint64 End)
+		{
+			for (uint64 current = Begin; current < End; ++current)
+			{
+				if (View.Has(entities[current]))
+				{
+					Function(entities[current]);
+				}
+			}
+		}, ChunkSize);
+	}
+
+	uint64 GetParallelForChunkSize(uint64 Count) const;
+
+	// Forks Function into a child job of the job running on the calling thread. It doesn't block,
+	// the running job completes and its dependent jobs fire only once all of its children have finished
+	void SpawnChildJob(std::string_view Name, FunctionRef<void(const float)> Function);
+
+	// Starts the coroutine as a child job of the running job, or as a standalone job when called outside of jobs
+	void SpawnCoroutineJob(std::string_view Name, JobTask Task);
+	// Schedules a coroutine that was suspended inside SuspendedJob, takes over the completion hold of the suspended job
+	void ResumeCoroutine(JobNode& SuspendedJob, std::coroutine_handle<> Handle);
+
+	// Forks [0, Count) into child jobs of the running job, Function is called as Function(Begin, End)
+	template <typename Func>
+	void SpawnChildJobsForRange(uint64 Count, Func&& Function, uint64 ChunkSize = 0)
+	{
+		ChunkSize = ChunkSize != 0 ? ChunkSize : GetParallelForChunkSize(Count);
+		SharedPtr<std::decay_t<Func>> sharedFunction = std::make_shared<std::decay_t<Func>>(std::forward<Func>(Function));
+		for (uint64 begin = 0; begin < Count; begin += ChunkSize)
+		{
+			const uint64 end = Min(begin + ChunkSize, Count);
+			SpawnChildJob("Child Range Job", [sharedFunction, begin, end](const float)
+			{
+				(*sharedFunction)(begin, end);
+			});
+		}
+	}
+
+	// Queues Function on the background lane. OnFinished is called on GT at the start of the frame after the job completed or was cancelled.
+	// Background jobs run outside of the frame, so they shouldn't push frame jobs, use ParallelFor or spawn child jobs
+	BackgroundJobHandle SubmitBackgroundJob(std::string_view Name, BackgroundJob::WorkFunction Function,
+	                                        BackgroundJob::CompletionCallback OnFinished = {});
+	// Called by workers that ran out of frame jobs. Returns false if there is nothing queued or enough workers are busy with background jobs
+	bool TryRunBackgroundJob();
+	bool HasBackgroundJobsToRun() const;
+	// Runs the frame jobs queued on the calling worker, lets long background jobs make room for the frame
+	void RunPendingFrameJobs();
+
+	bool HasStealableJobs() const;
+	void OnWorkerParked();
+	void OnWorkerUnparked();
+
+	// Per worker idle stats, accumulated since the start of the current frame / for the whole previous frame
+	std::vector<ThreadIdleStats> GetWorkerIdleStats() const;
+	const std::vector<ThreadIdleStats>& GetLastFrameWorkerIdleStats() const
+	{
+		return LastFrameWorkerIdleStats;
+	}
 
 private:
-	void PushJob(RefCountingPtr<JobNode> JobNode);
+	void PushJob(JobNode* JobNode);
+	// Updates the active job count once, deals the jobs out across the worker queues and wakes every worker at most once
+	void PushJobs(std::span<JobNode* const> JobsToPush);
+	void WakeWorkers(uint32 Count, uint32 FirstThreadIdx); // Tries threads starting at FirstThreadIdx, wrapping around the pool
+	void ParallelForImpl(uint64 Count, uint64 ChunkSize, FunctionRef<void(uint64, uint64)> Function);
+	void DispatchBackgroundJobCallbacks(); // Called on GT
+	// Cancelled jobs that are still queued are finished right away, so they can be waited on. Only their callbacks wait for GT
+	void CancelBackgroundJobs();
+	void CancelQueuedBackgroundJob(BackgroundJob* Job);
+	void FinishCancelledBackgroundJob(RefCountingPtr<BackgroundJob> Job); // Needs BackgroundJobsMutex
+	uint32 GetMaxBackgroundWorkers() const;
 
 private:
 	JobScheduler()
-		: ThreadCount(0)
+		: ActiveJobs(0)
+		  , ParkedWorkers(0)
+		  , QueuedBackgroundJobCount(0)
+		  , RunningBackgroundJobCount(0)
+		  , CriticalPathCost(0)
+		  , ThreadCount(0)
 		  , FrameCounter(0)
 	{
 	}
@@ -58,29 +219,66 @@ private:
 		std::unordered_map<SharedResourceType, RefCountingPtr<JobNode>> LastModifyingJobPerResource;
 		std::unordered_map<EcsComponentType, RefCountingPtr<JobNode>> LastModifyingJobPerComponent;
 
-		std::unordered_map<RefCountingPtr<JobNode>, std::unordered_set<RefCountingPtr<JobNode>>> AccountedDependencies;
-
 		std::unordered_map<UpdatePassType, std::unordered_set<UpdatePassType>> UpdatePassDependencies;
 		std::unordered_map<UpdatePassType, bool> ProcessedUpdatePasses;
+
+		void UpdateLastJobs(RefCountingPtr<JobNode>& Job, const UpdateJob& UpdateJob);
 	};
 
-	void ConstructUpdateGraphForPass(const UpdatePass* Pass, GraphBuildContext& Context);
-	void ConstructUpdateGraphForJobs(const UpdatePass* Pass, GraphBuildContext& Context);
+	// Graph nodes of a single pass, kept between rebuilds so unchanged passes don't have to be recomputed
+	struct UpdatePassGraph
+	{
+		const UpdatePass* Pass = nullptr;
+		UpdatePassType Type = 0;
+		uint32 Version = 0;
+		std::vector<std::pair<const UpdateJob*, RefCountingPtr<JobNode>>> Jobs; // In scheduling order
+		// Everything the jobs touch, copied as the pass may be unloaded before the next rebuild
+		std::unordered_set<EcsComponentType> Components;
+		std::unordered_set<SharedResourceType> Resources;
+	};
+
+	void RebuildUpdateGraph(bool RebuildAllPasses);
+	void SortUpdatePass(const UpdatePass* Pass, GraphBuildContext& Context, std::vector<const UpdatePass*>& OutPassOrder);
+	void ConstructUpdateGraphForJobs(UpdatePassGraph& PassGraph, GraphBuildContext& Context, std::vector<RefCountingPtr<JobNode>>& OutRemovedJobs);
+	void ReplayUpdateGraphForJobs(UpdatePassGraph& PassGraph, GraphBuildContext& Context);
+	void DetachUpdateGraphJob(JobNode& Job);
+	void AcquireGraphIndex(JobNode& Job);
+	void ReleaseGraphIndex(JobNode& Job);
 	bool ValidateGraph();
+	void RecordJobTelemetry();
+	void SetupStealOrders();
 
-	std::vector<RefCountingPtr<JobNode>> AvailableJobs;
-	std::vector<RefCountingPtr<JobNode>> Jobs;
+	std::vector<JobNode*> AvailableJobs; // Jobs without dependencies, owned by PassGraphs
+	std::vector<RefCountingPtr<JobNode>> Jobs; // Topologically sorted, a job only depends on the ones created before it
+	JobGraph CompiledGraph; // Jobs flattened for scheduling, indices match the Jobs order
+	std::vector<UpdatePassGraph> PassGraphs; // In the order passes are processed
+	// All jobs every job already depends on, directly or transitively, as bits indexed by graph index. Used to skip redundant dependency links
+	std::vector<std::vector<uint64>> AccountedDependencies;
+	std::vector<JobNode*> GraphJobs; // Update graph jobs by graph index
+	std::vector<uint32> FreeGraphIndices;
 
 	std::atomic<uint32_t> ActiveJobs;
-	std::condition_variable FrameFinishedCV;
-	std::mutex FrameFinishedMutex;
 
 	std::atomic<uint32> CurrentThreadForPush;
+	std::atomic<uint32> ParkedWorkers; // Only pushes that see a parked worker pay for a wake up
+
+	// Background lane, not counted in ActiveJobs. Jobs are coarse, so a single lock is enough
+	std::deque<RefCountingPtr<BackgroundJob>> QueuedBackgroundJobs;
+	std::vector<RefCountingPtr<BackgroundJob>> RunningBackgroundJobs;
+	std::vector<RefCountingPtr<BackgroundJob>> FinishedBackgroundJobs; // Waiting for their callbacks on GT
+	std::mutex BackgroundJobsMutex;
+	std::atomic<uint32> QueuedBackgroundJobCount; // Mirrors of the container sizes, so idle workers can check them without locking
+	std::atomic<uint32> RunningBackgroundJobCount;
+	std::vector<ThreadIdleStats> LastFrameWorkerIdleStats;
+	uint64 CriticalPathCost;
+	JobTelemetry Telemetry;
 
-	uint8 ThreadCount;
+	uint16 ThreadCount;
 	std::vector<Thread> ThreadPool;
 	RefCountingPtr<Thread> RenderThread;
+	std::vector<uint32> AffinityOrder;
+	std::vector<std::vector<uint16>> StealOrders; // Pool indices of victims per requesting thread index, 0 is the main thread
 
 	uint64 FrameCounter;
 };
-}
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+#include <vector>
+
+#include "CoreDefinitions.h"
+#include "Multithreading/UpdateJobs.h"
+
+namespace LE
+{
+#define JOB_TELEMETRY_HISTORY_FRAMES 240
+
+struct JobExecutionRecord
+{
+	uint64 FrameIndex = 0;
+	uint64 ExecutionTimeNs = 0;
+	uint64 QueueWaitNs = 0; // From the job becoming ready till it started executing
+	int16 ThreadIndex = -1; // 0 is the main thread, workers start from 1
+	bool WasStolen = false;
+};
+
+struct JobTimingSummary
+{
+	uint64 P50ExecutionTimeNs = 0;
+	uint64 P99ExecutionTimeNs = 0;
+	uint64 P50QueueWaitNs = 0;
+	uint64 P99QueueWaitNs = 0;
+	float StolenRatio = 0.f;
+	uint32 SampleCount = 0;
+};
+
+// Rolling window of execution records per update job, filled by the scheduler at the start of every frame
+class JobTelemetry
+{
+public:
+	explicit JobTelemetry(uint32 InHistorySize = JOB_TELEMETRY_HISTORY_FRAMES)
+		: HistorySize(InHistorySize)
+	{
+	}
+
+	void SetHistorySize(uint32 InHistorySize);
+
+	uint32 GetHistorySize() const
+	{
+		return HistorySize;
+	}
+
+	void Record(UpdateJobType JobType, const JobExecutionRecord& Record);
+	void Clear();
+
+	// Records are not ordered by frame once the window is full
+	const std::vector<JobExecutionRecord>* GetRecords(UpdateJobType JobType) const;
+	const JobExecutionRecord* GetLastRecord(UpdateJobType JobType) const;
+	JobTimingSummary GetSummary(UpdateJobType JobType) const;
+
+private:
+	struct JobHistory
+	{
+		std::vector<JobExecutionRecord> Records;
+		uint32 LastRecord = 0;
+	};
+
+	std::unordered_map<UpdateJobType, JobHistory> Histories;
+	uint32 HistorySize;
+};
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <coroutine>
+
+#include "Core.h"
+#include "Templates/NonCopyable.h"
+
+namespace LE
+{
+class JobNode;
+
+// Lock-free list of coroutines waiting for something to happen. Once signaled, all waiters are resumed as jobs
+// and later waiters don't suspend at all, till the list is reset
+class JobWaitList : public NonCopyable
+{
+public:
+	struct Waiter
+	{
+		Waiter* Next = nullptr;
+		JobNode* SuspendedJob = nullptr; // Job the coroutine was running in, it can't complete till the coroutine is resumed
+		std::coroutine_handle<> Handle;
+	};
+
+	JobWaitList()
+		: Head(nullptr)
+	{
+	}
+
+	~JobWaitList()
+	{
+		LE_ASSERT_DESC(Head.load(std::memory_order_relaxed) == nullptr || IsSignaled(), "Wait list was destroyed with suspended waiters")
+	}
+
+	bool IsSignaled() const
+	{
+		return Head.load(std::memory_order_acquire) == GetSignaledMarker();
+	}
+
+	// Returns false if the list is already signaled, the waiter is not added then
+	bool AddWaiter(Waiter& InWaiter);
+
+	void Signal();
+
+	// Should only be called when nobody is waiting
+	void Reset();
+
+	// Blocks the calling thread, for waiting outside of coroutines
+	void Wait() const;
+
+private:
+	static Waiter* GetSignaledMarker()
+	{
+		static Waiter signaledMarker;
+		return &signaledMarker;
+	}
+
+	std::atomic<Waiter*> Head;
+};
+}
\ No newline at end of file
@@ -1,10 +1,11 @@
 #pragma once
+#include <array>
 #include <thread>
-#include <deque>
 #include <mutex>
-#include <semaphore>
+#include <span>
 
 #include "JobNode.h"
+#include "WorkStealingQueue.h"
 #include "Templates/RefCounters.h"
 
 namespace LE
@@ -14,26 +15,44 @@ class JobScheduler;
 
 namespace LE
 {
+// Idle thread first busy-spins (adapting the spin count to how often spinning paid off), then yields, then parks on an atomic wait
+#define THREAD_SPIN_COUNT_MIN 32
+#define THREAD_SPIN_COUNT_MAX 4096
+#define THREAD_YIELD_COUNT 16
+
 enum class ThreadType : uint8_t
 {
 	Worker = 1,
 	Render
 };
 
+struct ThreadIdleStats
+{
+	uint64 IdleTimeNs = 0; // Time spent spinning, yielding and parked
+	uint64 ParkCount = 0;
+	uint64 WakeCount = 0; // Times the thread was unparked by a job push
+	uint64 TotalWakeLatencyNs = 0; // From the wake request till the thread is running again
+	uint64 MaxWakeLatencyNs = 0;
+};
+
 class Thread : public RefCountableBase
 {
 public:
 	static bool IsMainThread();
 	static bool IsRenderThread();
-	static int8 GetWorkerThreadIndex();
+	static int16 GetWorkerThreadIndex();
 
 
-	Thread(int8 InIndex, std::string InName, ThreadType InType, JobScheduler* InOwner)
+	Thread(int16 InIndex, std::string InName, ThreadType InType, JobScheduler* InOwner)
 		: Index(InIndex)
 		  , Type(InType)
 		  , Owner(InOwner)
 		  , Name(std::move(InName))
 	{
+		for (UniquePtr<WorkStealingQueue<JobNode*>>& localQueue : LocalQueues)
+		{
+			localQueue = std::make_unique<WorkStealingQueue<JobNode*>>();
+		}
 	}
 
 	Thread(const Thread&) = delete;
@@ -44,8 +63,10 @@ public:
 		Type = Other.Type;
 		Owner = Other.Owner;
 		Name = Other.Name;
+		AffinityCpu = Other.AffinityCpu;
 		std::swap(ThreadImpl, Other.ThreadImpl);
-		std::swap(LocalQueue, Other.LocalQueue);
+		std::swap(LocalQueues, Other.LocalQueues);
+		std::swap(IncomingJobs, Other.IncomingJobs);
 	}
 
 	Thread& operator=(const Thread&) = delete;
@@ -56,8 +77,10 @@ public:
 		std::swap(Type, Other.Type);
 		std::swap(Owner, Other.Owner);
 		std::swap(Name, Other.Name);
+		std::swap(AffinityCpu, Other.AffinityCpu);
 		std::swap(ThreadImpl, Other.ThreadImpl);
-		std::swap(LocalQueue, Other.LocalQueue);
+		std::swap(LocalQueues, Other.LocalQueues);
+		std::swap(IncomingJobs, Other.IncomingJobs);
 		return *this;
 	}
 
@@ -67,6 +90,8 @@ public:
 		{
 			ThreadImpl.join();
 		}
+
+		ReleaseLocalJobs();
 	}
 
 	ThreadType GetType() const
@@ -74,33 +99,77 @@ public:
 		return Type;
 	}
 
+	// Pins the thread to a single logical CPU once it starts, has to be called before Start. Negative value leaves it to the OS
+	void SetAffinity(int32 LogicalCpu)
+	{
+		AffinityCpu = LogicalCpu;
+	}
+
+	int32 GetAffinity() const
+	{
+		return AffinityCpu;
+	}
+
 	void Start();
 	void Stop();
 
 	void Main();
 
-	bool TryPushJob(RefCountingPtr<JobNode> JobToAdd);
-	void PushJob(RefCountingPtr<JobNode> JobToAdd);
-	bool TryStealJob(RefCountingPtr<JobNode>& JobOut);
+	bool IsCurrentThread() const;
+
+	// Runs the thread's own jobs and, for workers, the ones it can steal, till none are left. Should be called on the thread itself
+	void RunPendingJobs();
+
+	// Jobs pushed from the owning thread go to the lock-free local queue of their priority, others are handed over through the incoming list.
+	// Pushing doesn't wake the thread up, that's up to the caller. Queued jobs hold a queue reference, which is passed on to whoever takes the job
+	void PushJob(JobNode* JobToAdd);
+	// Same as PushJob for a batch of jobs, the incoming list is locked once for all of them
+	void PushJobs(std::span<JobNode* const> JobsToAdd);
+	// Jobs from the incoming list are only stolen together with the lowest priority
+	bool TryStealJob(JobNode*& JobOut, JobPriority Priority);
+	bool HasPendingJobs() const;
+
+	bool TryUnpark(); // Returns false if thread wasn't parked or somebody else has already woken it up
+
+	ThreadIdleStats GetIdleStats() const;
+	void ResetIdleStats();
 
 	void IncrementFrameCounter();
 	uint64 GetCurrentFrame() const;
 
 protected:
-	bool NextJob(RefCountingPtr<JobNode>& JobOut);
+	bool NextJob(JobNode*& JobOut);
+	bool HasJobsToRun() const;
+	void WaitForJobs();
+	bool SpinForJobs();
+	void Park();
+	bool MoveIncomingJobsToLocalQueue();
+	void ReleaseLocalJobs();
 
 	void SetThreadDescription();
+	void ApplyAffinity();
 
 protected:
-	int8 Index;
+	int16 Index;
 	ThreadType Type;
 	JobScheduler* Owner;
 	std::string Name;
+	int32 AffinityCpu = -1;
 	std::thread ThreadImpl;
 	std::atomic<bool> IsRunning{false};
-	std::binary_semaphore IsReady{0};
+	std::atomic<uint32> WakeEpoch{0};
+	std::atomic<bool> IsParked{false};
+	std::atomic<uint64> WakeRequestTimeNs{0};
+	uint32 SpinLimit = THREAD_SPIN_COUNT_MIN;
+	std::atomic<uint64> IdleTimeNs{0};
+	std::atomic<uint64> ParkCount{0};
+	std::atomic<uint64> WakeCount{0};
+	std::atomic<uint64> TotalWakeLatencyNs{0};
+	std::atomic<uint64> MaxWakeLatencyNs{0};
 	std::atomic<uint64> CurrentFrame;
-	std::deque<RefCountingPtr<JobNode>> LocalQueue;
-	std::mutex LocalQueueMutex;
+	std::array<UniquePtr<WorkStealingQueue<JobNode*>>, JOB_PRIORITY_COUNT> LocalQueues;
+	std::vector<JobNode*> IncomingJobs;
+	std::atomic<bool> HasIncomingJobs{false};
+	std::mutex IncomingJobsMutex;
 };
-}
+}
\ No newline at end of file
@@ -23,6 +23,7 @@ struct UpdateJob
 private:
 	friend class JobScheduler;
 
+protected:
 	enum class Operation : uint8
 	{
 		Read = 0,
@@ -33,22 +34,22 @@ private:
 		Count
 	};
 
-	template <typename EcsComponent>
-	void AddComponentOperation(Operation Type)
+	// Type ids are taken as they are, so jobs can also be described at runtime, e.g. by tools loading a dumped update graph
+	void AddComponentOperation(EcsComponentType ComponentType, Operation Type)
 	{
 		switch (Type)
 		{
 		case Operation::Delete:
 		{
-			ComponentOperations[static_cast<size_t>(Operation::Add)].erase(ComponentTypeIdGetter<EcsComponent>::Value);
+			ComponentOperations[static_cast<size_t>(Operation::Add)].erase(ComponentType);
 		}
 		case Operation::Add:
 		{
-			ComponentOperations[static_cast<size_t>(Operation::Write)].erase(ComponentTypeIdGetter<EcsComponent>::Value);
+			ComponentOperations[static_cast<size_t>(Operation::Write)].erase(ComponentType);
 		}
 		case Operation::Write:
 		{
-			ComponentOperations[static_cast<size_t>(Operation::Read)].erase(ComponentTypeIdGetter<EcsComponent>::Value);
+			ComponentOperations[static_cast<size_t>(Operation::Read)].erase(ComponentType);
 		}
 		case Operation::Read:
 			break;
@@ -58,21 +59,21 @@ private:
 		{
 		case Operation::Read:
 			{
-			if (ComponentOperations[static_cast<size_t>(Operation::Write)].contains(ComponentTypeIdGetter<EcsComponent>::Value))
+			if (ComponentOperations[static_cast<size_t>(Operation::Write)].contains(ComponentType))
 			{
 				return;
 			}
 			}
 		case Operation::Write:
 			{
-			if (ComponentOperations[static_cast<size_t>(Operation::Add)].contains(ComponentTypeIdGetter<EcsComponent>::Value))
+			if (ComponentOperations[static_cast<size_t>(Operation::Add)].contains(ComponentType))
 			{
 				return;
 			}
 			}
 		case Operation::Add:
 			{
-			if (ComponentOperations[static_cast<size_t>(Operation::Delete)].contains(ComponentTypeIdGetter<EcsComponent>::Value))
+			if (ComponentOperations[static_cast<size_t>(Operation::Delete)].contains(ComponentType))
 			{
 				return;
 			}
@@ -81,25 +82,24 @@ private:
 			break;
 		}
 
-		ComponentOperations[static_cast<size_t>(Type)].emplace(ComponentTypeIdGetter<EcsComponent>::Value);
+		ComponentOperations[static_cast<size_t>(Type)].emplace(ComponentType);
 	}
 
-	template <typename Resource>
-	void AddResourceOperation(Operation Type)
+	void AddResourceOperation(SharedResourceType ResourceType, Operation Type)
 	{
 		switch (Type)
 		{
 		case Operation::Delete:
 		{
-			ResourceOperations[static_cast<size_t>(Operation::Add)].erase(SharedResourceTypeIdGetter<Resource>::Value);
+			ResourceOperations[static_cast<size_t>(Operation::Add)].erase(ResourceType);
 		}
 		case Operation::Add:
 		{
-			ResourceOperations[static_cast<size_t>(Operation::Write)].erase(SharedResourceTypeIdGetter<Resource>::Value);
+			ResourceOperations[static_cast<size_t>(Operation::Write)].erase(ResourceType);
 		}
 		case Operation::Write:
 		{
-			ResourceOperations[static_cast<size_t>(Operation::Read)].erase(SharedResourceTypeIdGetter<Resource>::Value);
+			ResourceOperations[static_cast<size_t>(Operation::Read)].erase(ResourceType);
 		}
 		case Operation::Read:
 			break;
@@ -109,21 +109,21 @@ private:
 		{
 		case Operation::Read:
 		{
-			if (ResourceOperations[static_cast<size_t>(Operation::Write)].contains(SharedResourceTypeIdGetter<Resource>::Value))
+			if (ResourceOperations[static_cast<size_t>(Operation::Write)].contains(ResourceType))
 			{
 				return;
 			}
 		}
 		case Operation::Write:
 		{
-			if (ResourceOperations[static_cast<size_t>(Operation::Add)].contains(SharedResourceTypeIdGetter<Resource>::Value))
+			if (ResourceOperations[static_cast<size_t>(Operation::Add)].contains(ResourceType))
 			{
 				return;
 			}
 		}
 		case Operation::Add:
 		{
-			if (ResourceOperations[static_cast<size_t>(Operation::Delete)].contains(SharedResourceTypeIdGetter<Resource>::Value))
+			if (ResourceOperations[static_cast<size_t>(Operation::Delete)].contains(ResourceType))
 			{
 				return;
 			}
@@ -132,63 +132,63 @@ private:
 			break;
 		}
 
-		ResourceOperations[static_cast<size_t>(Type)].emplace(SharedResourceTypeIdGetter<Resource>::Value);
+		ResourceOperations[static_cast<size_t>(Type)].emplace(ResourceType);
 	}
 
 public:
 	template <typename... EcsComponent>
 	void ReadsComponents()
 	{
-		((AddComponentOperation<EcsComponent>(Operation::Read)), ...);
+		((AddComponentOperation(ComponentTypeIdGetter<EcsComponent>::Value, Operation::Read)), ...);
 		CacheComponentNames<EcsComponent...>();
 	}
 
 	template <typename... EcsComponent>
 	void WritesComponents()
 	{
-		((AddComponentOperation<EcsComponent>(Operation::Write)), ...);
+		((AddComponentOperation(ComponentTypeIdGetter<EcsComponent>::Value, Operation::Write)), ...);
 		CacheComponentNames<EcsComponent...>();
 	}
 
 	template <typename... EcsComponent>
 	void AddsComponents()
 	{
-		((AddComponentOperation<EcsComponent>(Operation::Add)), ...);
+		((AddComponentOperation(ComponentTypeIdGetter<EcsComponent>::Value, Operation::Add)), ...);
 		CacheComponentNames<EcsComponent...>();
 	}
 
 	template <typename... EcsComponent>
 	void DeletesComponents()
 	{
-		((AddComponentOperation<EcsComponent>(Operation::Delete)), ...);
+		((AddComponentOperation(ComponentTypeIdGetter<EcsComponent>::Value, Operation::Delete)), ...);
 		CacheComponentNames<EcsComponent...>();
 	}
 
 	template <typename... Resource>
 	void ReadsResources()
 	{
-		((AddResourceOperation<Resource>(Operation::Read)), ...);
+		((AddResourceOperation(SharedResourceTypeIdGetter<Resource>::Value, Operation::Read)), ...);
 		CacheResourceNames<Resource...>();
 	}
 
 	template <typename... Resource>
 	void WritesResources()
 	{
-		((AddResourceOperation<Resource>(Operation::Write)), ...);
+		((AddResourceOperation(SharedResourceTypeIdGetter<Resource>::Value, Operation::Write)), ...);
 		CacheResourceNames<Resource...>();
 	}
 
 	template <typename... Resource>
 	void AddsResources()
 	{
-		((AddResourceOperation<Resource>(Operation::Add)), ...);
+		((AddResourceOperation(SharedResourceTypeIdGetter<Resource>::Value, Operation::Add)), ...);
 		CacheResourceNames<Resource...>();
 	}
 
 	template <typename... Resource>
 	void DeletesResources()
 	{
-		((AddResourceOperation<Resource>(Operation::Delete)), ...);
+		((AddResourceOperation(SharedResourceTypeIdGetter<Resource>::Value, Operation::Delete)), ...);
 		CacheResourceNames<Resource...>();
 	}
 
@@ -255,6 +255,17 @@ public:
 	virtual std::string_view GetName() const = 0;
 	virtual UpdateJobType GetType() const = 0;
 
+	// Relative cost used for critical path scheduling until the job was measured
+	void SetStaticWeight(uint32 InWeight)
+	{
+		StaticWeight = InWeight;
+	}
+
+	uint32 GetStaticWeight() const
+	{
+		return StaticWeight;
+	}
+
 
 	std::string_view GetComponentName(EcsComponentType ComponentType) const
 	{
@@ -287,6 +298,8 @@ protected:
 
 	Delegate<void(const float)> UpdateFunction;
 
+	uint32 StaticWeight = 1;
+
 	template <typename... EcsComponent>
 	void CacheComponentNames()
 	{
@@ -335,6 +348,7 @@ protected:
 		using ObserverType =  EcsObserver<ObservedComponentTypes<UNWRAP(ObservedComponents)>, FilteredComponentTypes<UNWRAP(FilteredComponents)>>; \
 		void TryRunObserver(const float) \
 		{ \
+		Observer.CollectUpdatedEntities(); \
 		if (Observer.IsEmpty()) \
 		{ \
 			return; \
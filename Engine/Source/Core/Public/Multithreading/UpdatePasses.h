@@ -25,6 +25,9 @@ struct UpdatePass
 		GetUpdatePasses().push_back(this);
 	}
 
+	// Passes of unloaded modules leave the update graph at the start of the next frame
+	virtual ~UpdatePass();
+
 	static std::vector<const UpdatePass*>& GetUpdatePasses();
 
 	template<typename UpdatePassT, typename UpdateJobType>
@@ -33,9 +36,30 @@ struct UpdatePass
 		GetUpdatePassInternal<UpdatePassT>()->AddJob(UpdateJobTypeIdGetter<UpdateJobType>::Value, Job);
 	}
 
+	template<typename UpdatePassT, typename UpdateJobType>
+	static void RemoveJob()
+	{
+		GetUpdatePassInternal<UpdatePassT>()->RemoveJob(UpdateJobTypeIdGetter<UpdateJobType>::Value);
+	}
+
+	// Jobs can be added and removed between frames, the scheduler rebuilds the graph around passes whose version changed
 	void AddJob(UpdateJobType JobType, const UpdateJob* Job)
 	{
 		Jobs[JobType] = Job;
+		++Version;
+	}
+
+	void RemoveJob(UpdateJobType JobType)
+	{
+		if (Jobs.erase(JobType) > 0)
+		{
+			++Version;
+		}
+	}
+
+	uint32 GetVersion() const
+	{
+		return Version;
 	}
 
 	const std::unordered_map<UpdateJobType, const UpdateJob*>& GetUpdateJobs() const
@@ -98,6 +122,7 @@ protected:
 	std::string Name;
 	Color DebugColor;
 	UpdatePassType Type;
+	uint32 Version = 0;
 };
 
 #define REGISTER_UPDATE_PASS(UpdatePassType, DebugColorIn, ...) \
@@ -118,4 +143,4 @@ protected:
 	{ \
 		static constexpr std::string_view Value = #UpdatePassType; \
 	};
-}
+}
\ No newline at end of file
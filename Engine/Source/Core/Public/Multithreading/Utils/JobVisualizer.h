@@ -3,6 +3,7 @@
 #include "Math/Color.h"
 #include "Misc/Paths.h"
 #include "Multithreading/JobScheduler.h"
+#include "Multithreading/JobTelemetry.h"
 
 namespace LE
 {
@@ -13,6 +14,7 @@ class JobVisualizer
 	struct UpdatePassDescriptor
 	{
 		std::vector<JobNodeDescriptor*> Jobs;
+		const UpdatePass* Pass = nullptr;
 		std::string_view UpdatePassName;
 		Color Color;
 	};
@@ -21,11 +23,17 @@ class JobVisualizer
 	{
 		std::vector<JobNodeDescriptor*> DependentJobs;
 		std::string_view JobName;
+		const UpdateJob* Job = nullptr; // Null if the job already left its pass
 		UpdatePassDescriptor* ParentUpdatePass;
+		JobTimingSummary Timing;
+		uint64 RemainingPathCost = 0;
+		JobNodeDescriptor* CriticalDependentJob = nullptr; // Next job on the longest path, measured by p50 durations
+		bool IsOnCriticalPath = false;
 	};
 
 public:
-	JobVisualizer(const std::vector<RefCountingPtr<JobNode>>& Jobs);
+	// With telemetry, nodes are annotated with p50/p99 durations and the measured critical path is highlighted
+	JobVisualizer(const std::vector<RefCountingPtr<JobNode>>& Jobs, const JobTelemetry* Telemetry = nullptr);
 	~JobVisualizer();
 
 	JobVisualizer(const JobVisualizer&) = delete;
@@ -34,10 +42,14 @@ public:
 	JobVisualizer& operator=(JobVisualizer&&) = delete;
 
 	void Dump(Path SavePath);
+	// Besides the graph itself, passes with their dependencies and the access sets of jobs are written out,
+	// so tools can rebuild the same graph from the file
+	void DumpJson(Path SavePath);
 
 private:
 	void WriteUpdatePass(std::ostream& Stream, const UpdatePassDescriptor& Descriptor);
 	void WriteJob(std::ostream& Stream, const JobNodeDescriptor& Descriptor);
+	void FindCriticalPath();
 
 	JobNodeDescriptor* GetCreateJobDescriptor(UpdateJobType JobType);
 	UpdatePassDescriptor* GetCreateUpdatePassDescriptor(UpdatePassType PassType);
@@ -45,5 +57,8 @@ private:
 	std::unordered_map<UpdateJobType, JobNodeDescriptor*> JobDescriptors;
 	std::unordered_map<UpdatePassType, UpdatePassDescriptor*> UpdatePasses;
 	std::vector<JobNodeDescriptor*> StartingJobs;
+	std::vector<JobNodeDescriptor*> OrderedJobs; // Topologically sorted
+	std::vector<UpdatePassDescriptor*> OrderedUpdatePasses; // In the order their first job appears
+	bool HasTelemetry;
 };
 }
@@ -0,0 +1,51 @@
+#pragma once
+#include <span>
+#include <vector>
+
+#include "CoreDefinitions.h"
+#include "Multithreading/JobGraph.h"
+
+namespace LE
+{
+struct SchedulerSimulationSettings
+{
+	uint16 WorkerThreadCount = 1;
+	bool MainThreadHelps = true; // Main thread runs jobs too, as it does in HelpWorkerThreads
+	bool UsePriorities = true; // Otherwise every job is treated as a normal priority one
+	bool RunContinuations = true; // First dependent made ready by a job runs next on the same thread
+	uint64 PushCostNs = 0; // Paid by the thread that makes a job ready, per job it pushes
+	uint64 StealCostNs = 0; // Paid by a thread taking a job from another thread's queue
+};
+
+struct SchedulerSimulationResult
+{
+	uint64 FrameTimeNs = 0;
+	uint64 CriticalPathCostNs = 0; // No number of workers can make the frame shorter than this
+	uint64 TotalWorkNs = 0;
+	std::vector<uint64> ThreadBusyNs; // Main thread first, then the workers
+	bool MainThreadHelped = true;
+	std::vector<uint32> CriticalPath; // Graph job indices, from the first job to the last one
+	uint32 StealCount = 0;
+	uint32 ContinuationCount = 0;
+
+	float GetThreadUtilisation(size_t ThreadIdx) const
+	{
+		return FrameTimeNs > 0 ? static_cast<float>(ThreadBusyNs[ThreadIdx]) / static_cast<float>(FrameTimeNs) : 0.f;
+	}
+
+	float GetAverageUtilisation() const;
+};
+
+// Replays one frame of a compiled update graph with the scheduler's policy on simulated threads: round-robin submission from
+// the main thread, per thread priority queues with LIFO pops and FIFO steals, and continuations. Nothing is executed,
+// so what-if questions like more workers or a split job can be answered without running the game
+class SchedulerSimulator
+{
+public:
+	// Costs are indexed by graph job index, GetJobCosts gives the ones the scheduler itself plans with
+	static SchedulerSimulationResult Simulate(const JobGraph& Graph, std::span<const uint64> JobCostsNs, const SchedulerSimulationSettings& Settings);
+	static std::vector<uint64> GetJobCosts(const JobGraph& Graph);
+	// Longest chain of dependent jobs, from the first job to the last one. Returns its cost
+	static uint64 GetCriticalPath(const JobGraph& Graph, std::span<const uint64> JobCostsNs, std::vector<uint32>& OutCriticalPath);
+};
+}
\ No newline at end of file
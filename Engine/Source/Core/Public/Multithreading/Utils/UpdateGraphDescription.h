@@ -0,0 +1,62 @@
+#pragma once
+#include <array>
+#include <string>
+#include <vector>
+
+#include "Misc/Paths.h"
+#include "Multithreading/UpdatePasses.h"
+#include "Templates/NonCopyable.h"
+
+namespace LE
+{
+// Access sets are indexed the same way as UpdateJob operations: read, write, add, delete
+using AccessSets = std::array<std::vector<uint32>, 4>;
+
+struct UpdateJobDescription
+{
+	std::string Name;
+	std::string PassName;
+	uint32 StaticWeight = 1;
+	uint64 P50ExecutionTimeNs = 0; // Zero if the dump was written without telemetry
+	uint64 P99ExecutionTimeNs = 0;
+	AccessSets Components;
+	AccessSets Resources;
+};
+
+struct UpdatePassDescription
+{
+	std::string Name;
+	std::vector<std::string> DependsOn;
+};
+
+// Update graph as written by JobScheduler::DumpUpdateGraph. It is turned back into real passes and jobs,
+// so the scheduler builds exactly the same dependencies as it does in the game
+struct UpdateGraphDescription
+{
+	std::vector<UpdatePassDescription> Passes;
+	std::vector<UpdateJobDescription> Jobs;
+
+	bool Load(const Path& JsonPath);
+
+	// Replaces the job with PartCount jobs with the same accesses, each taking an equal share of its cost.
+	// Parts that write the same data still run one after another, edit the accesses in the file to model finer splits
+	bool SplitJob(std::string_view JobName, uint32 PartCount);
+
+	const UpdateJobDescription* FindJob(UpdateJobType JobType) const;
+};
+
+struct DescribedUpdatePass;
+struct DescribedUpdateJob;
+
+// Registers the described passes and jobs, they stay registered while the instance is alive
+class UpdateGraphInstance : public NonCopyable
+{
+public:
+	explicit UpdateGraphInstance(const UpdateGraphDescription& Description);
+	~UpdateGraphInstance();
+
+private:
+	std::vector<UniquePtr<DescribedUpdatePass>> Passes;
+	std::vector<UniquePtr<DescribedUpdateJob>> Jobs;
+};
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#pragma once
+#include <atomic>
+#include <vector>
+
+#include "Core.h"
+#include "CoreDefinitions.h"
+#include "Templates/NonCopyable.h"
+
+namespace LE
+{
+// Lock-free Chase-Lev deque (Le et al. "Correct and Efficient Work-Stealing for Weak Memory Models")
+// Push and Pop may only be called by the owning thread and work on the bottom end, Steal can be called from any thread and takes from the top.
+template <typename Type>
+class WorkStealingQueue : public NonCopyable
+{
+	static_assert(std::is_trivially_copyable_v<Type>, "WorkStealingQueue element has to be trivially copyable");
+
+	struct RingBuffer
+	{
+		explicit RingBuffer(const int64 InCapacity)
+			: Capacity(InCapacity)
+			  , Mask(InCapacity - 1)
+			  , Elements(new std::atomic<Type>[static_cast<size_t>(InCapacity)])
+		{
+		}
+
+		~RingBuffer()
+		{
+			delete[] Elements;
+		}
+
+		Type Get(const int64 Index) const noexcept
+		{
+			return Elements[Index & Mask].load(std::memory_order_relaxed);
+		}
+
+		void Put(const int64 Index, Type Element) noexcept
+		{
+			Elements[Index & Mask].store(Element, std::memory_order_relaxed);
+		}
+
+		RingBuffer* Grow(const int64 Bottom, const int64 Top) const
+		{
+			RingBuffer* newBuffer = new RingBuffer(Capacity * 2);
+			for (int64 current = Top; current != Bottom; ++current)
+			{
+				newBuffer->Put(current, Get(current));
+			}
+
+			return newBuffer;
+		}
+
+		int64 Capacity;
+		int64 Mask;
+		std::atomic<Type>* Elements;
+	};
+
+public:
+	static constexpr int64 DefaultCapacity = 256;
+
+	explicit WorkStealingQueue(const int64 InitialCapacity = DefaultCapacity)
+		: Top(0)
+		  , Bottom(0)
+	{
+		LE_ASSERT_DESC(InitialCapacity > 0 && (InitialCapacity & (InitialCapacity - 1)) == 0, "Capacity has to be a power of two")
+		RingBuffer* buffer = new RingBuffer(InitialCapacity);
+		Buffer.store(buffer, std::memory_order_relaxed);
+		Buffers.push_back(buffer);
+	}
+
+	~WorkStealingQueue()
+	{
+		for (RingBuffer* buffer : Buffers)
+		{
+			delete buffer;
+		}
+	}
+
+	// Owner only
+	void Push(Type Element)
+	{
+		const int64 bottom = Bottom.load(std::memory_order_relaxed);
+		const int64 top = Top.load(std::memory_order_acquire);
+		RingBuffer* buffer = Buffer.load(std::memory_order_relaxed);
+
+		if (bottom - top > buffer->Capacity - 1)
+		{
+			// Thieves may still read from the old buffer, so it is only released with the queue
+			buffer = buffer->Grow(bottom, top);
+			Buffers.push_back(buffer);
+			Buffer.store(buffer, std::memory_order_release);
+		}
+
+		buffer->Put(bottom, Element);
+		// Release store instead of a standalone fence, so thieves acquiring Bottom see everything written before the push
+		Bottom.store(bottom + 1, std::memory_order_release);
+	}
+
+	// Owner only
+	bool Pop(Type& OutElement)
+	{
+		const int64 bottom = Bottom.load(std::memory_order_relaxed) - 1;
+		RingBuffer* buffer = Buffer.load(std::memory_order_relaxed);
+		Bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64 top = Top.load(std::memory_order_relaxed);
+
+		if (top > bottom)
+		{
+			Bottom.store(bottom + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		OutElement = buffer->Get(bottom);
+		if (top == bottom)
+		{
+			// Last element, race against thieves for it
+			const bool won = Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			Bottom.store(bottom + 1, std::memory_order_relaxed);
+			return won;
+		}
+
+		return true;
+	}
+
+	// Any thread. Returns false if the queue is empty or the element was taken by another thread
+	bool Steal(Type& OutElement)
+	{
+		int64 top = Top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64 bottom = Bottom.load(std::memory_order_acquire);
+
+		if (top >= bottom)
+		{
+			return false;
+		}
+
+		const RingBuffer* buffer = Buffer.load(std::memory_order_acquire);
+		const Type element = buffer->Get(top);
+		if (!Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			return false;
+		}
+
+		OutElement = element;
+		return true;
+	}
+
+	bool IsEmpty() const noexcept
+	{
+		const int64 bottom = Bottom.load(std::memory_order_relaxed);
+		const int64 top = Top.load(std::memory_order_relaxed);
+		return bottom <= top;
+	}
+
+	uint64 Count() const noexcept
+	{
+		const int64 bottom = Bottom.load(std::memory_order_relaxed);
+		const int64 top = Top.load(std::memory_order_relaxed);
+		return bottom > top ? static_cast<uint64>(bottom - top) : 0u;
+	}
+
+	int64 Capacity() const noexcept
+	{
+		return Buffer.load(std::memory_order_relaxed)->Capacity;
+	}
+
+private:
+	alignas(CACHE_LINE_SIZE) std::atomic<int64> Top;
+	alignas(CACHE_LINE_SIZE) std::atomic<int64> Bottom;
+	alignas(CACHE_LINE_SIZE) std::atomic<RingBuffer*> Buffer;
+	std::vector<RingBuffer*> Buffers; // Owner only, keeps retired buffers alive for late thieves
+};
+}
\ No newline at end of file
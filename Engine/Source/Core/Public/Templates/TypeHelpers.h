@@ -117,6 +117,15 @@ struct ExcludedComponentTypes final : ComponentTypeList<ExcludedComponents...>
 template <typename... ExcludedComponents>
 inline constexpr ExcludedComponentTypes<ExcludedComponents...> ExcludeComponentTypes{};
 
+template <typename... ChangedComponents>
+struct ChangedComponentTypes final : ComponentTypeList<ChangedComponents...>
+{
+	explicit constexpr ChangedComponentTypes() = default;
+};
+
+template <typename... ChangedComponents>
+inline constexpr ChangedComponentTypes<ChangedComponents...> Changed{};
+
 template <std::size_t, typename>
 struct ComponentStorageType;
 
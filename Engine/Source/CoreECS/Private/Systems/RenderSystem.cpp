@@ -7,6 +7,7 @@
 #include "Components/StaticMeshComponent.h"
 #include "Components/TransformComponent.h"
 #include "ECS/Ecs.h"
+#include "Multithreading/JobScheduler.h"
 #include "Multithreading/UpdatePasses.h"
 #include "SceneRendering/RenderScene.h"
 #include "tracy/Tracy.hpp"
@@ -42,29 +43,26 @@ void RenderSystem::UpdateStaticMeshes(const float DeltaSeconds)
 {
 	ZoneScopedN("RenderSystem::UpdateStaticMeshes");
 	Renderer::RenderScene& renderScene = GetRendererModule()->GetRenderScene();
-	auto view = ViewComponents<StaticMeshComponent, TransformComponent>();
-	for (const EcsEntity& entity : view)
+	auto view = ViewComponents<StaticMeshComponent, TransformComponent>(Changed<TransformComponent>);
+	JobScheduler::Get()->ParallelEach(view, [view, &renderScene](const EcsEntity entity)
 	{
-		const TransformComponent& transformComponent = view.GetComponents<TransformComponent>(entity);
+		const TransformComponent& transformComponent = view.ReadComponents<TransformComponent>(entity);
 		renderScene.UpdateStaticMeshProxyTransform(entity, transformComponent.Transform);
-	}
+	});
 }
 
 void RenderSystem::UpdateCamera(const float DeltaSeconds)
 {
 	ZoneScopedN("RenderSystem::UpdateCamera");
 	auto cameraView = ViewComponents<CameraComponent, TransformComponent>();
-	for (const EcsEntity& entity : cameraView)
+	cameraView.Each([](const EcsEntity, const CameraComponent& cameraComponent, const TransformComponent& transformComponent)
 	{
 		// TODO: For now we always assume that we have one camera, later we will need to handle multiple active cameras out of all cameras
-		const TransformComponent& transformComponent = cameraView.GetComponents<TransformComponent>(entity);
-		const CameraComponent& cameraComponent = cameraView.GetComponents<CameraComponent>(entity);
-
 		Renderer::SceneViewInfo newViewInfo;
 		newViewInfo.FOV = cameraComponent.FOV;
 		newViewInfo.ViewTransform = transformComponent.Transform;
 		GetWorld()->SetPrimaryViewInfo(newViewInfo);
-	}
+	});
 }
 
 void RenderSystem::OnAdd(const OnAddObserverType::ObserverType& Observer)
@@ -73,8 +71,8 @@ void RenderSystem::OnAdd(const OnAddObserverType::ObserverType& Observer)
 	Renderer::RenderScene& renderScene = GetRendererModule()->GetRenderScene();
 	for (auto entity : Observer)
 	{
-		const StaticMeshComponent& staticMeshComponent = Observer.GetComponents<StaticMeshComponent>(entity);
-		const TransformComponent& transformComponent = Observer.GetComponents<TransformComponent>(entity);
+		const StaticMeshComponent& staticMeshComponent = Observer.ReadComponents<StaticMeshComponent>(entity);
+		const TransformComponent& transformComponent = Observer.ReadComponents<TransformComponent>(entity);
 
 		renderScene.CreateStaticMeshRenderProxy(entity, transformComponent.Transform, staticMeshComponent.RenderData, staticMeshComponent.MeshMaterial);
 	}
@@ -4,6 +4,7 @@
 #include "Components/CameraComponent.h"
 #include "Components/TransformComponent.h"
 #include "ECS/Ecs.h"
+#include "Multithreading/JobScheduler.h"
 #include "Multithreading/UpdateJobs.h"
 #include "Multithreading/UpdatePasses.h"
 #include "tracy/Tracy.hpp"
@@ -25,7 +26,7 @@ namespace LE
 		time += DeltaSeconds;
 
 		auto view = ViewComponents<TransformComponent>(ExcludedComponentTypes<CameraComponent>());
-		for (auto entity : view)
+		JobScheduler::Get()->ParallelEach(view, [view](const EcsEntity entity)
 		{
 			TransformComponent& transformComponent = view.GetComponents<TransformComponent>(entity);
 
@@ -38,7 +39,7 @@ namespace LE
 			pos.X += amp * Sin(PI * time * freq);
 
 			transformComponent.Transform.SetPosition(pos);
-		}
+		});
 	}
 
 	void TestSystem::Shutdown()
@@ -146,13 +146,11 @@ void GameEngine::InitMaterials()
 void GameEngine::InitJobScheduler()
 {
 	JobScheduler* scheduler = JobScheduler::Get();
-	const int availableThreadCount = std::thread::hardware_concurrency();
-	const int capCount = Min(availableThreadCount, static_cast<int>(Constants<int8>::CMax));
-	const int8 workerThreadCount = static_cast<int8>(capCount - 2);
+	const uint16 workerThreadCount = JobScheduler::GetDefaultWorkerThreadCount(JOB_SCHEDULER_DEFAULT_AFFINITY_POLICY);
 
-	scheduler->Init(workerThreadCount);
+	scheduler->Init(workerThreadCount, JOB_SCHEDULER_DEFAULT_AFFINITY_POLICY);
 
-	Renderer::RenderCommandList::Get().Initialize(workerThreadCount);
+	Renderer::RenderCommandList::Get().Initialize(workerThreadCount, RENDER_THREAD_FRAME_BEHIND_MAX);
 	scheduler->StartRenderThread();
 }
-}
+}
\ No newline at end of file
@@ -20,10 +20,23 @@ RenderCommandList::RenderCommandList()
 	WriteRenderCommands.resize(1);
 }
 
-void RenderCommandList::Initialize(int8 WorkerThreadNum)
+void RenderCommandList::Initialize(uint16 WorkerThreadNum, uint32 FramesInFlightCount)
 {
+	LE_ASSERT_DESC(FramesInFlightCount > 0, "At least one frame has to be in flight")
 	WriteRenderCommands.resize(WorkerThreadNum + 1);
-	RenderThreadFinished.release();
+
+	FramesInFlight.clear();
+	for (uint32 i = 0; i < FramesInFlightCount; ++i)
+	{
+		UniquePtr<FrameInFlight> frame = std::make_unique<FrameInFlight>();
+		frame->RenderFinishedFence.Signal();
+		FramesInFlight.push_back(std::move(frame));
+	}
+
+	FinalizedFrameCount = 0;
+	RenderedFrameCount = 0;
+	FrameStatsHistory.clear();
+	FrameStatsHistory.reserve(RENDER_FRAME_STATS_HISTORY_SIZE);
 }
 
 void RenderCommandList::EnqueueLambdaCommand(const RenderCommand& LambdaCommand)
@@ -34,7 +47,7 @@ void RenderCommandList::EnqueueLambdaCommand(const RenderCommand& LambdaCommand)
 	}
 	else
 	{
-		const int8 workerThreadIdx = Thread::IsMainThread()? static_cast<int8>(0) : Thread::GetWorkerThreadIndex();
+		const int16 workerThreadIdx = Thread::IsMainThread()? static_cast<int16>(0) : Thread::GetWorkerThreadIndex();
 		LE_ASSERT_DESC(workerThreadIdx >= 0, "Trying to enqueue render command from non-working thread")
 		WriteRenderCommands[workerThreadIdx].emplace_back(LambdaCommand);
 	}
@@ -57,22 +70,82 @@ void RenderCommandList::FinalizeFrame()
 		commandList.clear();
 	}
 
-	// Wait for the render frame to finish
-	RenderThreadFinished.acquire();
+	// Wait for the render thread to finish the frame that used this command buffer the last time
+	FrameInFlight& frame = *FramesInFlight[FinalizedFrameCount % FramesInFlight.size()];
+	const Clock::TimePoint waitBeginning = Clock::Now();
+	frame.RenderFinishedFence.Wait();
+	const float stallMs = Clock::GetMsFrom(waitBeginning);
+
+	if (FinalizedFrameCount >= FramesInFlight.size())
+	{
+		RecordFrameStats(frame.Stats);
+	}
 
-	ReadRenderCommands.reserve(finalSize);
-	ReadRenderCommands.insert(ReadRenderCommands.end(), finalRenderCommandList.begin(), finalRenderCommandList.end());
+	frame.RenderFinishedFence.Reset();
+	frame.Commands = std::move(finalRenderCommandList);
+	frame.Stats = RenderFrameStats();
+	frame.Stats.FrameIndex = FinalizedFrameCount;
+	frame.Stats.GameThreadStallMs = stallMs;
+	frame.FinalizeTime = Clock::Now();
+	++FinalizedFrameCount;
 }
 
 void RenderCommandList::Render_ExecuteFrame()
 {
-	for (RenderCommandWrapper& command : ReadRenderCommands)
+	// Every kick-off renders the oldest finalized frame, so the order kick-off jobs are picked up in doesn't matter
+	FrameInFlight& frame = *FramesInFlight[RenderedFrameCount % FramesInFlight.size()];
+	const Clock::TimePoint renderBeginning = Clock::Now();
+	for (RenderCommandWrapper& command : frame.Commands)
 	{
 		command.Execute(*this);
 	}
 
-	ReadRenderCommands.clear();
-	RenderThreadFinished.release();
+	frame.Commands.clear();
+	const Clock::TimePoint renderEnd = Clock::Now();
+	frame.Stats.QueuedMs = Clock::GetMsBetween(frame.FinalizeTime, renderBeginning);
+	frame.Stats.RenderMs = Clock::GetMsBetween(renderBeginning, renderEnd);
+	frame.Stats.LatencyMs = Clock::GetMsBetween(frame.FinalizeTime, renderEnd);
+	++RenderedFrameCount;
+
+	// Stats are read by GT only after it waited on the fence
+	frame.RenderFinishedFence.Signal();
+}
+
+RenderFrameStats RenderCommandList::GetAverageFrameStats() const
+{
+	RenderFrameStats average;
+	if (FrameStatsHistory.empty())
+	{
+		return average;
+	}
+
+	for (const RenderFrameStats& stats : FrameStatsHistory)
+	{
+		average.GameThreadStallMs += stats.GameThreadStallMs;
+		average.QueuedMs += stats.QueuedMs;
+		average.RenderMs += stats.RenderMs;
+		average.LatencyMs += stats.LatencyMs;
+	}
+
+	const float count = static_cast<float>(FrameStatsHistory.size());
+	average.FrameIndex = LastFrameStats.FrameIndex;
+	average.GameThreadStallMs /= count;
+	average.QueuedMs /= count;
+	average.RenderMs /= count;
+	average.LatencyMs /= count;
+	return average;
+}
+
+void RenderCommandList::RecordFrameStats(const RenderFrameStats& Stats)
+{
+	LastFrameStats = Stats;
+	if (FrameStatsHistory.size() < RENDER_FRAME_STATS_HISTORY_SIZE)
+	{
+		FrameStatsHistory.push_back(Stats);
+		return;
+	}
+
+	FrameStatsHistory[Stats.FrameIndex % RENDER_FRAME_STATS_HISTORY_SIZE] = Stats;
 }
 
 RefCountingPtr<RHI::RHIBuffer> RenderCommandList::CreateBuffer(uint32 Size, RHI::BufferUsageFlags UsageFlags, uint32 Stride,
@@ -138,4 +211,4 @@ RHI::RHIContext& RenderCommandList::GetContext()
 {
 	return *RHI::gDynamicRHI->RHIGetContext();
 }
-}
+}
\ No newline at end of file
@@ -1,10 +1,11 @@
 #pragma once
-#include <semaphore>
 
 #include "RHIContext.h"
 #include "RHIResources.h"
 #include "RHIShaderParameters.h"
+#include "Multithreading/JobCoroutine.h"
 #include "Templates/RefCounters.h"
+#include "Time/Clock.h"
 
 
 namespace LE::Renderer
@@ -30,6 +31,17 @@ private:
 	RenderCommand Command;
 };
 
+#define RENDER_FRAME_STATS_HISTORY_SIZE 128
+
+struct RenderFrameStats
+{
+	uint64 FrameIndex = 0;
+	float GameThreadStallMs = 0.f; // Time FinalizeFrame waited for the render thread to free a command buffer
+	float QueuedMs = 0.f; // From FinalizeFrame till the render thread started executing the frame
+	float RenderMs = 0.f;
+	float LatencyMs = 0.f; // From FinalizeFrame till the frame was fully executed on the render thread
+};
+
 class RenderCommandList
 {
 public:
@@ -37,11 +49,37 @@ public:
 
 	RenderCommandList();
 
-	void Initialize(int8 WorkerThreadNum);
+	// Game thread can finalize up to FramesInFlight frames before it has to wait for the render thread
+	void Initialize(uint16 WorkerThreadNum, uint32 FramesInFlight);
 	void EnqueueLambdaCommand(const RenderCommand& LambdaCommand);
 
-	void FinalizeFrame(); // Joins commands from worker thread and puts them into reading list
-	void Render_ExecuteFrame(); // Should be called from render frame
+	void FinalizeFrame(); // Joins commands from worker thread and puts them into the next free frame in flight
+	void Render_ExecuteFrame(); // Should be called from render frame, executes the oldest finalized frame
+
+	uint32 GetFramesInFlightCount() const
+	{
+		return static_cast<uint32>(FramesInFlight.size());
+	}
+
+	uint64 GetFinalizedFrameCount() const
+	{
+		return FinalizedFrameCount;
+	}
+
+	// Signaled once the frame was executed on the render thread, valid for the last GetFramesInFlightCount() finalized frames.
+	// Coroutine jobs can co_await it
+	JobFence& GetRenderFrameFence(uint64 FrameIndex)
+	{
+		return FramesInFlight[FrameIndex % FramesInFlight.size()]->RenderFinishedFence;
+	}
+
+	// Stats of a frame are collected on GT once its command buffer is reused, so they lag behind by the number of frames in flight
+	const RenderFrameStats& GetLastFrameStats() const
+	{
+		return LastFrameStats;
+	}
+
+	RenderFrameStats GetAverageFrameStats() const;
 
 	RefCountingPtr<RHI::RHIBuffer> CreateBuffer(uint32 Size, RHI::BufferUsageFlags UsageFlags, uint32 Stride,
 	                                            RHI::RHIResourceCreateInfo& CreateInfo);
@@ -79,9 +117,23 @@ protected:
 	RHI::RHIShaderParametersCollection ScratchShaderParametersCollection;
 
 private:
-	std::vector<RenderCommandWrapper> ReadRenderCommands; // Those are executed on the render thread
+	struct FrameInFlight
+	{
+		std::vector<RenderCommandWrapper> Commands; // Those are executed on the render thread
+		JobFence RenderFinishedFence;
+		Clock::TimePoint FinalizeTime;
+		RenderFrameStats Stats;
+	};
+
+	void RecordFrameStats(const RenderFrameStats& Stats);
+
+	std::vector<UniquePtr<FrameInFlight>> FramesInFlight;
 	std::vector<std::vector<RenderCommandWrapper>> WriteRenderCommands; // Those are where worker threads write
 
-	std::binary_semaphore RenderThreadFinished{0};
+	uint64 FinalizedFrameCount = 0; // Game thread only
+	uint64 RenderedFrameCount = 0; // Render thread only
+
+	RenderFrameStats LastFrameStats;
+	std::vector<RenderFrameStats> FrameStatsHistory; // Ring buffer of the last RENDER_FRAME_STATS_HISTORY_SIZE frames
 };
-}
+}
\ No newline at end of file
@@ -0,0 +1,259 @@
+#include <charconv>
+#include <format>
+#include <iostream>
+#include <numeric>
+#include <string_view>
+
+#include "Multithreading/JobScheduler.h"
+#include "Multithreading/Utils/SchedulerSimulator.h"
+#include "Multithreading/Utils/UpdateGraphDescription.h"
+
+namespace
+{
+	enum class CostSource : LE::uint8
+	{
+		P50,
+		P99,
+		StaticWeight
+	};
+
+	struct SimulatorOptions
+	{
+		LE::Path GraphPath;
+		std::vector<LE::uint16> WorkerCounts = {1, 2, 4, 8, 16};
+		std::vector<std::pair<std::string, LE::uint32>> Splits;
+		CostSource Cost = CostSource::P50;
+		LE::SchedulerSimulationSettings Settings;
+	};
+
+	void PrintUsage()
+	{
+		std::cout << "Usage: SchedulerSimulator <UpdatePass.json> [options]\n"
+			<< "  --workers 1,2,4,8       Worker thread counts to simulate\n"
+			<< "  --cost p50|p99|static   Job costs, static uses only the static weights\n"
+			<< "  --split <Job>=<Parts>   Splits a job into equal parts, can be repeated\n"
+			<< "  --steal-cost-us <us>    Cost of taking a job from another thread's queue\n"
+			<< "  --push-cost-us <us>     Cost of making a job ready, per job\n"
+			<< "  --no-priorities         Ignore critical path priorities\n"
+			<< "  --no-continuations      Push every ready dependent instead of running the first one inline\n"
+			<< "  --no-main-thread        Main thread doesn't help with the jobs\n";
+	}
+
+	template <typename T>
+	bool ParseNumber(std::string_view String, T& OutNumber)
+	{
+		const auto [end, error] = std::from_chars(String.data(), String.data() + String.size(), OutNumber);
+		return error == std::errc() && end == String.data() + String.size();
+	}
+
+	bool ParseMicroseconds(std::string_view String, LE::uint64& OutNs)
+	{
+		double microseconds = 0.0;
+		if (!ParseNumber(String, microseconds) || microseconds < 0.0)
+		{
+			return false;
+		}
+
+		OutNs = static_cast<LE::uint64>(microseconds * 1000.0 + 0.5);
+		return true;
+	}
+
+	bool ParseOptions(int ArgCount, char* Args[], SimulatorOptions& OutOptions)
+	{
+		if (ArgCount < 2)
+		{
+			return false;
+		}
+
+		OutOptions.GraphPath = Args[1];
+		OutOptions.Settings.StealCostNs = 500;
+		OutOptions.Settings.PushCostNs = 100;
+		for (int i = 2; i < ArgCount; ++i)
+		{
+			const std::string_view option = Args[i];
+			const std::string_view value = i + 1 < ArgCount ? std::string_view(Args[i + 1]) : std::string_view();
+			if (option == "--workers")
+			{
+				OutOptions.WorkerCounts.clear();
+				for (size_t begin = 0; begin < value.size();)
+				{
+					const size_t end = std::min(value.find(',', begin), value.size());
+					LE::uint16 workerCount = 0;
+					if (!ParseNumber(value.substr(begin, end - begin), workerCount))
+					{
+						return false;
+					}
+
+					OutOptions.WorkerCounts.push_back(workerCount);
+					begin = end + 1;
+				}
+				++i;
+			}
+			else if (option == "--cost")
+			{
+				if (value == "p50")
+				{
+					OutOptions.Cost = CostSource::P50;
+				}
+				else if (value == "p99")
+				{
+					OutOptions.Cost = CostSource::P99;
+				}
+				else if (value == "static")
+				{
+					OutOptions.Cost = CostSource::StaticWeight;
+				}
+				else
+				{
+					return false;
+				}
+				++i;
+			}
+			else if (option == "--split")
+			{
+				const size_t separator = value.rfind('=');
+				LE::uint32 partCount = 0;
+				if (separator == std::string_view::npos || !ParseNumber(value.substr(separator + 1), partCount) || partCount == 0)
+				{
+					return false;
+				}
+
+				OutOptions.Splits.emplace_back(std::string(value.substr(0, separator)), partCount);
+				++i;
+			}
+			else if (option == "--steal-cost-us")
+			{
+				if (!ParseMicroseconds(value, OutOptions.Settings.StealCostNs))
+				{
+					return false;
+				}
+				++i;
+			}
+			else if (option == "--push-cost-us")
+			{
+				if (!ParseMicroseconds(value, OutOptions.Settings.PushCostNs))
+				{
+					return false;
+				}
+				++i;
+			}
+			else if (option == "--no-priorities")
+			{
+				OutOptions.Settings.UsePriorities = false;
+			}
+			else if (option == "--no-continuations")
+			{
+				OutOptions.Settings.RunContinuations = false;
+			}
+			else if (option == "--no-main-thread")
+			{
+				OutOptions.Settings.MainThreadHelps = false;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return !OutOptions.WorkerCounts.empty();
+	}
+
+	double ToMicroseconds(LE::uint64 TimeNs)
+	{
+		return static_cast<double>(TimeNs) / 1000.0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Log::Initialize();
+
+	SimulatorOptions options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	LE::UpdateGraphDescription description;
+	if (!description.Load(options.GraphPath))
+	{
+		return 1;
+	}
+
+	for (const auto& [jobName, partCount] : options.Splits)
+	{
+		if (!description.SplitJob(jobName, partCount))
+		{
+			LE_ERROR("There is no job {} to split", jobName);
+			return 1;
+		}
+	}
+
+	// Graph is built by the scheduler itself, so the simulated dependencies are the ones the game would run with
+	LE::UpdateGraphInstance graphInstance(description);
+	LE::JobScheduler* scheduler = LE::JobScheduler::Get();
+	scheduler->ConstructUpdateGraph();
+
+	const LE::JobGraph& graph = scheduler->GetCompiledGraph();
+	for (LE::uint32 jobIndex = 0; jobIndex < graph.GetJobCount(); ++jobIndex)
+	{
+		LE::JobNode* job = graph.GetJob(jobIndex);
+		const LE::UpdateJobDescription* jobDescription = description.FindJob(job->GetType());
+		if (!jobDescription || options.Cost == CostSource::StaticWeight)
+		{
+			continue;
+		}
+
+		const LE::uint64 cost = options.Cost == CostSource::P50 ? jobDescription->P50ExecutionTimeNs : jobDescription->P99ExecutionTimeNs;
+		if (cost > 0)
+		{
+			job->SetAverageExecutionTimeNs(cost);
+		}
+	}
+
+	// Priorities are assigned from the loaded costs the same way they are at the start of a frame
+	scheduler->UpdateCriticalPath();
+	const std::vector<LE::uint64> costs = LE::SchedulerSimulator::GetJobCosts(graph);
+
+	std::vector<LE::uint32> criticalPath;
+	const LE::uint64 criticalPathCostNs = LE::SchedulerSimulator::GetCriticalPath(graph, costs, criticalPath);
+	const LE::uint64 totalWorkNs = std::accumulate(costs.begin(), costs.end(), LE::uint64{0});
+
+	size_t simulatedCount = 0;
+	std::cout << std::format("{} jobs in {} passes\n\n", graph.GetJobCount(), description.Passes.size());
+	std::cout << std::format("{:>8} {:>12} {:>8} {:>12} {:>8} {:>14}\n", "Workers", "Frame (us)", "Speedup", "Utilisation", "Steals", "Continuations");
+	for (const LE::uint16 workerCount : options.WorkerCounts)
+	{
+		LE::SchedulerSimulationSettings settings = options.Settings;
+		settings.WorkerThreadCount = workerCount;
+		if (workerCount == 0 && !settings.MainThreadHelps)
+		{
+			LE_WARN("Nobody runs jobs with 0 workers and --no-main-thread, skipped");
+			continue;
+		}
+
+		const LE::SchedulerSimulationResult result = LE::SchedulerSimulator::Simulate(graph, costs, settings);
+		++simulatedCount;
+		std::cout << std::format("{:>8} {:>12.1f} {:>8.2f} {:>11.1f}% {:>8} {:>14}\n", workerCount, ToMicroseconds(result.FrameTimeNs),
+		                         result.FrameTimeNs > 0 ? static_cast<double>(result.TotalWorkNs) / static_cast<double>(result.FrameTimeNs) : 0.0,
+		                         result.GetAverageUtilisation() * 100.f, result.StealCount, result.ContinuationCount);
+	}
+
+	if (simulatedCount == 0)
+	{
+		LE_ERROR("Every worker count was skipped, nothing was simulated");
+	}
+
+	// Doesn't depend on the worker count, so it's printed even if nothing was simulated
+	std::cout << std::format("\nTotal work {:.1f} us, critical path {:.1f} us, the frame can't get shorter than that:\n",
+	                         ToMicroseconds(totalWorkNs), ToMicroseconds(criticalPathCostNs));
+	for (const LE::uint32 jobIndex : criticalPath)
+	{
+		const LE::JobNode* job = graph.GetJob(jobIndex);
+		const LE::UpdatePass* pass = LE::UpdatePass::GetUpdatePass(job->GetUpdatePassType());
+		std::cout << std::format("  {:>10.1f} us  {} ({})\n", ToMicroseconds(costs[jobIndex]), job->GetName(), pass ? pass->GetName() : "");
+	}
+
+	return simulatedCount > 0 ? 0 : 1;
+}
\ No newline at end of file
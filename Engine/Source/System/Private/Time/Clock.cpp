@@ -11,6 +11,12 @@ namespace LE
 		return ClockClass::now();
 	}
 
+	uint64_t Clock::NowNs()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
 	void Clock::StartFrame()
 	{
 		const Clock::TimePoint current = Clock::Now();
@@ -11,6 +11,7 @@ namespace LE
 		using TimePoint = std::chrono::time_point<ClockClass>;
 
 		static TimePoint Now();
+		static uint64_t NowNs(); // Monotonic, for measuring short intervals
 
 		static void StartFrame();
 		static float GetElapsedSeconds();